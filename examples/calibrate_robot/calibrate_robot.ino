@@ -62,7 +62,7 @@ void loop() {
 	#if USE_DABBLE != 0
 		Dabble.processInput();
 		
-		if (morobot.type == "morobot_s_rrp") {
+		if (morobot.typeId == ROBOT_TYPE_S_RRP) {
 			if (GamePad.isPressed(0) && currentLimitReached == false) {			// UP
 				morobot.moveAngle(2, -2, 1, false);
 			} else if(GamePad.isPressed(1)) {									// DOWN
@@ -33,7 +33,7 @@
 
 // Create morobot object and declare variables
 MOROBOT_TYPE morobot;
-String drive_type = "xyz";				// xyz, angular
+bool driveAngular = false;			// false: xyz, true: angular
 float step = 2.0;
 int delayDebounce = 250;
 float actPos[3];
@@ -49,7 +49,7 @@ void setup() {
 	delay(200);
 	initVars();
 	
-	if (morobot.type == "morobot_s_rrp") step = 1;
+	if (morobot.typeId == ROBOT_TYPE_S_RRP) step = 1;
 	
 	Serial.println("Waiting for Dabble to connect to smartphone. If you are already connected, press any app-key.");
 	Dabble.waitForAppConnection();
@@ -73,12 +73,12 @@ void loop() {
 		delay(delayDebounce);
 		initVars();
 	} else if(GamePad.isPressed(5)) {	// Select
-		if (drive_type == "xyz") {
-			drive_type = "angular";
+		if (!driveAngular) {
+			driveAngular = true;
 			step = step*2;
 			Serial.println(F("Changed Drive-Type to ANGULAR"));
 		} else {
-			drive_type = "xyz";
+			driveAngular = false;
 			step = step/2;
 			Serial.println(F("Changed Drive-Type to XYZ"));
 			initVars();
@@ -86,7 +86,7 @@ void loop() {
 		delay(delayDebounce);
 	}
 
-	if (drive_type == "xyz"){
+	if (!driveAngular){
 		if(GamePad.isPressed(2)) {			// Left
 			actPosTemp[1] = actPos[1] - step;
 		} else if(GamePad.isPressed(3)) {	// Right
@@ -96,10 +96,10 @@ void loop() {
 		} else if(GamePad.isPressed(1)) {	// Down
 			actPosTemp[0] = actPos[0] + step;
 		} else if(GamePad.isPressed(6)) {	// Triangle
-			if (morobot.type == "morobot_s_rrp") actPosTemp[2] = actPos[2] + 0.05;
+			if (morobot.typeId == ROBOT_TYPE_S_RRP) actPosTemp[2] = actPos[2] + 0.05;
 			else actPosTemp[2] = actPos[2] + step;
 		} else if(GamePad.isPressed(8)) {   // X
-			if (morobot.type == "morobot_s_rrp") actPosTemp[2] = actPos[2] - 0.05;
+			if (morobot.typeId == ROBOT_TYPE_S_RRP) actPosTemp[2] = actPos[2] - 0.05;
 			else actPosTemp[2] = actPos[2] - step;
 		}
 	
@@ -114,7 +114,7 @@ void loop() {
 		}
 	}
 	
-	if (drive_type == "angular"){
+	if (driveAngular){
 		if(GamePad.isPressed(2)) {			// Left
 			morobot.moveAngle(0, step);
 		} else if(GamePad.isPressed(3)) {	// Right
@@ -86,7 +86,8 @@ void loop() {
 		magnet.activate();
 		delay(delayDebounce);
 	} else if(GamePad.isPressed(4)) {	// Start
-		gripper.closeToForce();
+		gripper.graspToForce();			// Only for smart-servo gripper
+		gripper.printGraspTrace();		// Shows how long the grasp took and the current while closing
 		delay(delayDebounce);
 	} else if(GamePad.isPressed(5)) {	// Select
 		gripper.moveToAngle(90, 10);
@@ -0,0 +1,47 @@
+/**
+ *  \file gcode_streaming.ino
+ *  \brief Stream G-code from a PC to a morobot with a pen or dispensing tool. Consecutive segments are chained without stopping.
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  
+ *  Hardware: 		- Arduino Mega (or similar microcontroller)
+ *  				- morobot with pen-lifter, dispenser or similar tool switched by a relais
+ *  				- Powersupply 9-12V 5A (or more)
+ *  Connections:	- Powersupply to Arduino hollow connector
+ *  				- First smart servo of robot to Arduino:
+ *  					- Red cable to Vin
+ *  					- Black cable to GND
+ *  					- Yellow cable to pin 16 (TX2)
+ *  					- White calbe to pin 17 (RX2)
+ *  				- Relais of the tool to pin 8
+ *  Send G-code with the streaming script in extras/gcode (waits for the "ok" of each line):
+ *  	python gcode_stream.py drawing.gcode COM3
+ */
+
+// **********************************************************************
+// ********************* CHANGE THESE TWO LINES *************************
+// **********************************************************************
+#define MOROBOT_TYPE 	morobot_s_rrr	// morobot_s_rrr, morobot_s_rrp, morobot_2d, morobot_3d, morobot_p
+#define SERIAL_PORT		"Serial2"		// "Serial", "Serial1", "Serial2", "Serial3" (not all supported for all microcontroller - see readme)
+
+#include <morobot.h>
+#include <gcode.h>
+
+MOROBOT_TYPE morobot;
+binaryEEF tool(8);
+gcodeInterpreter gcode(&morobot, &tool);
+
+void setup() {
+	morobot.begin(SERIAL_PORT);
+	morobot.moveHome();
+	morobot.waitUntilIsReady();
+	
+	gcode.begin(&Serial);
+	gcode.setResolution(2);		// Distance between interpolated points in mm
+	gcode.setAcceleration(200);	// Path acceleration in mm/s^2
+	Serial.println(F("Ready for G-code"));
+}
+
+void loop() {
+	gcode.update();
+}
@@ -0,0 +1,49 @@
+/**
+ *  \file host_control.ino
+ *  \brief Control a morobot from a PC (or PLC, cell controller) with the binary host protocol. Commands are pipelined, the robot reports when they are finished.
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  
+ *  Hardware: 		- Arduino Mega (or similar microcontroller)
+ *  				- morobot with smart servo gripper
+ *  				- USB-to-serial adapter for the host
+ *  				- Powersupply 9-12V 5A (or more)
+ *  Connections:	- Powersupply to Arduino hollow connector
+ *  				- First smart servo of robot to Arduino:
+ *  					- Red cable to Vin
+ *  					- Black cable to GND
+ *  					- Yellow cable to pin 16 (TX2)
+ *  					- White calbe to pin 17 (RX2)
+ *  				- USB-to-serial adapter to pin 18 (TX1) and 19 (RX1) and GND
+ *  The host port must not be "Serial" since the library prints messages there.
+ *  Control the robot with the client in extras/host_server:
+ *  	python morobot_client.py COM5 pose 150 0 100
+ *  	python morobot_client.py COM5 watch 200
+ */
+
+// **********************************************************************
+// ********************* CHANGE THESE TWO LINES *************************
+// **********************************************************************
+#define MOROBOT_TYPE 	morobot_s_rrr	// morobot_s_rrr, morobot_s_rrp, morobot_2d, morobot_3d, morobot_p
+#define SERIAL_PORT		"Serial2"		// "Serial", "Serial1", "Serial2", "Serial3" (not all supported for all microcontroller - see readme)
+#define HOST_PORT		Serial1			// Port the host is connected to
+
+#include <morobot.h>
+#include <host_server.h>
+
+MOROBOT_TYPE morobot;
+gripper gripper(&morobot);
+morobotServer server(&morobot, &gripper);
+
+void setup() {
+	morobot.begin(SERIAL_PORT);
+	gripper.begin();
+	morobot.moveHome();
+	
+	HOST_PORT.begin(115200);
+	server.begin(&HOST_PORT);
+}
+
+void loop() {
+	server.update();
+}
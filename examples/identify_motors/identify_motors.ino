@@ -0,0 +1,57 @@
+/**
+ *  \file identify_motors.ino
+ *  \brief Tune the position controllers of all motors, measure their backlash and the relation between PWM value and velocity and store everything in the EEPROM of the microcontroller. This program must only be called once per robot (or after changing motors or the load).
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  
+ *  Hardware: 		- Arduino Mega (or similar microcontroller)
+ *  				- Calibrated morobot
+ *  				- Powersupply 9-12V 5A (or more)
+ *  Connections:	- Powersupply to Arduino hollow connector
+ *  				- First smart servo of robot to Arduino:
+ *  					- Red cable to Vin
+ *  					- Black cable to GND
+ *  					- Yellow cable to pin 16 (TX2)
+ *  					- White calbe to pin 17 (RX2)
+ *  Every motor moves several times between its joint limits. Make sure there are no obstacles in the workspace!
+ *  Other programs use the stored data after calling loadPidProfiles(), loadBacklash() (followed by setBacklashCompensation()) and loadPwmModels() in setup().
+ */
+
+// **********************************************************************
+// ********************* CHANGE THESE TWO LINES *************************
+// **********************************************************************
+#define MOROBOT_TYPE 	morobot_s_rrr	// morobot_s_rrr, morobot_s_rrp, morobot_2d, morobot_3d, morobot_p
+#define SERIAL_PORT		"Serial2"		// "Serial", "Serial1", "Serial2", "Serial3" (not all supported for all microcontroller - see readme)
+
+#include <morobot.h>
+
+MOROBOT_TYPE morobot;
+
+void setup() {
+	morobot.begin(SERIAL_PORT);
+	morobot.moveHome();
+	
+	Serial.println("Identifying motors in 5 seconds");
+	delay(5000);
+	
+	for (uint8_t i = 0; i < morobot.getNumSmartServos(); i++) {
+		if (!morobot.tunePid(i)) {
+			Serial.println("Tuning failed, nothing stored!");
+			return;
+		}
+		if (!morobot.calibrateBacklash(i)) {
+			Serial.println("Backlash calibration failed, nothing stored!");
+			return;
+		}
+		if (!morobot.identifyPwmModel(i)) {
+			Serial.println("Identification failed, nothing stored!");
+			return;
+		}
+	}
+	
+	if (morobot.savePidProfiles() && morobot.saveBacklash() && morobot.savePwmModels()) Serial.println("Gains, backlash and models stored!");
+	morobot.moveHome();
+}
+
+void loop() {
+}
@@ -0,0 +1,59 @@
+/**
+ *  \file motion_program.ino
+ *  \brief Run motion programs (bytecode) stored in flash or received over the serial monitor port without reflashing the controller.
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  
+ *  Hardware: 		- Arduino Mega (or similar microcontroller)
+ *  				- morobot with smart servo gripper
+ *  				- Powersupply 9-12V 5A (or more)
+ *  Connections:	- Powersupply to Arduino hollow connector
+ *  				- First smart servo of robot to Arduino:
+ *  					- Red cable to Vin
+ *  					- Black cable to GND
+ *  					- Yellow cable to pin 16 (TX2)
+ *  					- White calbe to pin 17 (RX2)
+ *  Create programs with the assembler in extras/motion_program:
+ *  	python motion_asm.py program.txt --c-array pickPlace	(paste the output into this sketch)
+ *  	python motion_asm.py program.txt --send COM3			(send the program to the running sketch)
+ */
+
+// **********************************************************************
+// ********************* CHANGE THESE TWO LINES *************************
+// **********************************************************************
+#define MOROBOT_TYPE 	morobot_s_rrr	// morobot_s_rrr, morobot_s_rrp, morobot_2d, morobot_3d, morobot_p
+#define SERIAL_PORT		"Serial2"		// "Serial", "Serial1", "Serial2", "Serial3" (not all supported for all microcontroller - see readme)
+
+#include <morobot.h>
+#include <motion_program.h>
+
+// speed 20 / loop 2 / pose 150 0 100 / open / wait 500 / angles 0 45 -30 / linear 150 50 100 / close / endloop
+const uint8_t pickPlace[] PROGMEM = {
+	0x4D, 0x50, 0x01, 0x09, 0x14, 0x07, 0x02, 0x00, 0x01, 0xDC, 0x05, 0x00,
+	0x00, 0xE8, 0x03, 0x04, 0x06, 0xF4, 0x01, 0x02, 0x03, 0x00, 0x00, 0x2D,
+	0x00, 0xE2, 0xFF, 0x03, 0xDC, 0x05, 0xF4, 0x01, 0xE8, 0x03, 0x05, 0x08,
+	0x00,
+};
+
+MOROBOT_TYPE morobot;
+gripper gripper(&morobot);
+motionProgram program(&morobot, &gripper);
+uint8_t programBuffer[256];		// Programs received over Serial are stored here
+
+void setup() {
+	morobot.begin(SERIAL_PORT);
+	gripper.begin();
+	morobot.moveHome();
+	
+	// Check all poses before the robot moves (check() prints the first failing instruction)
+	program.load(pickPlace, sizeof(pickPlace), true);
+	if (program.check()) Serial.println(F("Running program from flash. Send a new program at any time to replace it."));
+}
+
+void loop() {
+	// A new program replaces the running one
+	if (program.receive(&Serial, programBuffer, sizeof(programBuffer)) > 0 && program.check()) {
+		Serial.println(F("New program received"));
+	}
+	program.step();
+}
@@ -48,8 +48,13 @@ morobotClass* actMorobot;	// Pointer to store which robot is active at the momen
 
 void setup() {
 	Dabble.begin(DABBLE_PARAM);
-	morobot1.begin(SERIAL_PORT_1);
-	morobot2.begin(SERIAL_PORT_2);
+	
+	// Start both robots at the same time. If the motors kept their IDs (e.g. only the Arduino has been reset), the robots are ready after a few milliseconds.
+	morobotClass* robots[2] = {&morobot1, &morobot2};
+	const char* ports[2] = {SERIAL_PORT_1, SERIAL_PORT_2};
+	morobotClass::beginAll(robots, ports, 2);
+	morobot1.printTopology();
+	morobot2.printTopology();
 	delay(500);
 	morobot1.moveHome();
 	morobot2.moveHome();
@@ -66,7 +66,7 @@ void setup() {
 void loop() {
 	Dabble.processInput();
 
-	if (morobot.type == "morobot_s_rrp"){	
+	if (morobot.typeId == ROBOT_TYPE_S_RRP){	
 		if(GamePad.isPressed(0)) {			// Up
 			morobot.moveAngle(2, -20, 30);
 		} else if(GamePad.isPressed(1)) {   // Down
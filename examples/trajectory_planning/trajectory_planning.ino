@@ -42,6 +42,9 @@ void loop() {
    * 5 ... continuous linear movement
    * 6 ... linear movement with pauses at each intermediate point
    * 7 ... linear movement with trajectory planning (not recommended with current motors)
+   * 8 ... linear movement with closed-loop tracking and a given TCP speed
+   * 9 ... circular movement (arc around a center point)
+   * 10 .. spline movement through several points
    */
   
   if(i==1){
@@ -163,6 +166,71 @@ void loop() {
     float end_pose[] = {161.37, -113.63, 0};
     morobot.moveLinear(end_pose, 0, 5, 1);
     
+    if(show_all==1){
+      i+=1;
+      delay(1000);
+      morobot.moveHome();        // Move the robot into initial position
+      delay(2000);
+    }else{
+      i=0;
+    }
+    
+  }else if(i==8){
+    //linear movement with closed-loop tracking
+    Serial.println("\n---\nlinear movement with closed-loop tracking\n---\n");
+    //                    x        y     z
+    float end_pose[] = {161.37, -113.63, 0};
+    morobot.moveLinearTracked(end_pose, 20);   // TCP speed 20 mm/s
+    
+    tracking_stats_type stats = morobot.getTrackingStats();
+    Serial.print("Max. joint error [deg]: ");
+    Serial.println(stats.maxError);
+    Serial.print("RMS joint error [deg]: ");
+    Serial.println(stats.rmsError);
+    Serial.print("Duration [ms]: ");
+    Serial.println(stats.duration);
+    Serial.print("Cycles / pauses / overruns: ");
+    Serial.print(stats.numCycles);
+    Serial.print(" / ");
+    Serial.print(stats.numPauses);
+    Serial.print(" / ");
+    Serial.println(stats.numOverruns);
+    
+    if(show_all==1){
+      i+=1;
+      delay(1000);
+      morobot.moveHome();        // Move the robot into initial position
+      delay(2000);
+    }else{
+      i=0;
+    }
+    
+  }else if(i==9){
+    //circular movement
+    Serial.println("\n---\ncircular movement\n---\n");
+    //                   x       y    z
+    float center[] = {150.0,    0.0, 0};
+    float end_pose[] = {150.0, -59.0, 0};
+    morobot.moveCircular(center, end_pose, ARC_CENTER_CW, 20);   // TCP speed 20 mm/s
+    
+    if(show_all==1){
+      i+=1;
+      delay(1000);
+      morobot.moveHome();        // Move the robot into initial position
+      delay(2000);
+    }else{
+      i=0;
+    }
+    
+  }else if(i==10){
+    //spline movement through several points
+    Serial.println("\n---\nspline movement\n---\n");
+    //                     x        y     z
+    float poses[][3] = {{188.92,   -3.77, 0},
+                        {161.37, -113.63, 0},
+                        {137.38,   67.23, 0}};
+    morobot.moveSpline(poses, 3, SPLINE_CATMULL_ROM, 20);   // TCP speed 20 mm/s
+    
     if(show_all==1){
       i+=1;
       delay(1000);
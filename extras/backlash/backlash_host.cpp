@@ -0,0 +1,147 @@
+/**
+ *  \file 	backlash_host.cpp
+ *  \brief 	Tests the backlash compensation of morobotClass (BACKLASH_TRAJECTORY) on a PC with simulated motors
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Notes:
+ *  	The library is compiled for the PC, only MakeblockSmartServo is replaced by motors simulated below. Each motor reaches its goal
+ *  	immediately, its joint follows with SIM_BACKLASH degrees of play (the joint only moves when the motor pushes against one side).
+ *  	The test moves a joint relative and absolute in both directions and checks after every movement that the joint is exactly
+ *  	where it was sent to and that getKnownAngle() returns that angle (no drift by the backlash offset).
+ *  	Build (see test_backlash.py):
+ *  		g++ -std=gnu++11 -fpermissive -w -DARDUINO_AVR_MEGA2560 -I../host_stubs -I../../src backlash_host.cpp \
+ *  			(all files of ../../src except MakeblockSmartServo.cpp) ../host_stubs/arduino.cpp -o backlash_host
+ */
+
+#include "morobot.h"
+#include <stdio.h>
+
+#define SIM_NUM_SERVOS	1		//!< Number of motors of the test robot
+#define SIM_BACKLASH	4		//!< Play between motor and joint in degrees
+
+static long simMotor[SIM_NUM_SERVOS];	//!< Angles of the simulated motors (what the encoder reports)
+static float simJoint[SIM_NUM_SERVOS];	//!< Angles of the joints behind the gears
+
+/**
+ *  \brief Moves a motor and lets the joint follow when the motor pushes against one side of the play
+ */
+static void simMoveMotor(uint8_t devId, long angle){
+	uint8_t i = devId-1;
+	if (i >= SIM_NUM_SERVOS) return;
+	simMotor[i] = angle;
+	if (simMotor[i] > simJoint[i] + SIM_BACKLASH/2.0) simJoint[i] = simMotor[i] - SIM_BACKLASH/2.0;
+	if (simMotor[i] < simJoint[i] - SIM_BACKLASH/2.0) simJoint[i] = simMotor[i] + SIM_BACKLASH/2.0;
+}
+
+/**
+ *  \brief Robot with one joint and no kinematics
+ */
+class testRobot : public morobotBase<SIM_NUM_SERVOS, testRobot> {
+	friend class morobotBase<SIM_NUM_SERVOS, testRobot>;
+	public:
+		const char* getType() { return "test"; }
+		uint8_t getTypeId() { return 0; }
+		void setTCPoffset(float, float, float) {}
+		bool checkIfAngleValid(uint8_t, float) { return true; }
+	protected:
+		bool calculateAngles(float, float, float) { return false; }
+		void updateTCPpose(bool) {}
+};
+
+/* Simulated motors */
+bool MakeblockSmartServo::move(uint8_t dev_id, long angle_value, float, smartServoCb){
+	simMoveMotor(dev_id, simMotor[dev_id-1] + angle_value);
+	return true;
+}
+bool MakeblockSmartServo::moveTo(uint8_t dev_id, long angle_value, float, smartServoCb){
+	simMoveMotor(dev_id, angle_value);
+	return true;
+}
+long MakeblockSmartServo::getAngleRequest(uint8_t devId){ return simMotor[devId-1]; }
+uint8_t MakeblockSmartServo::getLastError(uint8_t){ return PROCESS_SUC; }
+bool MakeblockSmartServo::getPositionReached(uint8_t){ return true; }
+bool MakeblockSmartServo::clrMotionCompensation(uint8_t){ return true; }
+bool MakeblockSmartServo::setMotionCompensation(uint8_t, int16_t){ return true; }
+
+/* Not used by the test */
+void MakeblockSmartServo::beginSerial(Stream*){}
+void MakeblockSmartServo::beginTransport(servoTransport*){}
+uint8_t MakeblockSmartServo::assignDevIdPoll(void){ return 0; }
+bool MakeblockSmartServo::assignDevIdRequest(void){ return true; }
+void MakeblockSmartServo::assignDevIdStart(void){}
+uint8_t MakeblockSmartServo::getNumDevices(void){ return SIM_NUM_SERVOS; }
+bool MakeblockSmartServo::probeRequest(uint8_t){ return true; }
+servo_bus_stats_type MakeblockSmartServo::getBusStats(void){
+	servo_bus_stats_type stats = {};
+	return stats;
+}
+void MakeblockSmartServo::resetBusStats(void){}
+servo_error_type MakeblockSmartServo::getErrorStats(uint8_t){
+	servo_error_type errors = {};
+	return errors;
+}
+void MakeblockSmartServo::resetErrorStats(uint8_t){}
+uint32_t MakeblockSmartServo::getResponseTimeout(uint8_t, uint8_t){ return 0; }
+bool MakeblockSmartServo::getRttHistogram(uint8_t, uint8_t, uint16_t[SERVO_STATS_BUCKETS]){ return false; }
+float MakeblockSmartServo::getCurrentRequest(uint8_t){ return 0; }
+float MakeblockSmartServo::getSpeedRequest(uint8_t){ return 0; }
+float MakeblockSmartServo::getTempRequest(uint8_t){ return 0; }
+float MakeblockSmartServo::getVoltageRequest(uint8_t){ return 0; }
+bool MakeblockSmartServo::getVersionRequest(uint8_t){ return false; }
+void MakeblockSmartServo::getVersion(uint8_t, char version[SERVO_VERSION_LENGTH + 1]){ version[0] = 0; }
+bool MakeblockSmartServo::getPidRequest(uint8_t, uint8_t, float[3]){ return false; }
+bool MakeblockSmartServo::setPid(uint8_t, uint8_t, float, float, float){ return true; }
+bool MakeblockSmartServo::setPwmMove(uint8_t, int16_t){ return true; }
+bool MakeblockSmartServo::setBreak(uint8_t, uint8_t){ return true; }
+bool MakeblockSmartServo::setInitAngle(uint8_t, uint8_t, int16_t){ return true; }
+bool MakeblockSmartServo::setZero(uint8_t){ return true; }
+
+static uint32_t failures = 0;	//!< Number of failed checks
+
+/**
+ *  \brief Waits until the robot reached its goal and checks the joint and the known angle
+ */
+static void check(testRobot* robot, const char* movement, long expected){
+	robot->waitUntilIsReady();
+	long known = robot->getKnownAngle(0);
+	bool ok = (simJoint[0] == expected) && (known == expected);
+	if (!ok) failures++;
+	printf("%s %-12s joint %6.1f, known %4ld, expected %4ld (motor %4ld)\n", ok ? "ok    " : "FAILED", movement, simJoint[0], known, expected, simMotor[0]);
+}
+
+int main(){
+	testRobot robot;
+	robot.setBacklash(0, SIM_BACKLASH);
+	robot.setBacklashCompensation(BACKLASH_TRAJECTORY);
+
+	// Motor and joint start at 0 (after setZero() the library knows no backlash offset yet)
+	simMotor[0] = 0;
+	simJoint[0] = 0;
+
+	long expected = 0;
+	const long relative[] = {10, 10, 10, 10, -10, -10, -10, 5, -3, -3, 20};
+	for (uint8_t i=0; i<sizeof(relative)/sizeof(relative[0]); i++) {
+		robot.moveAngle(0, relative[i]);
+		expected += relative[i];
+		check(&robot, relative[i] > 0 ? "moveAngle +" : "moveAngle -", expected);
+	}
+
+	const long absolute[] = {50, 30, 30, 40};
+	for (uint8_t i=0; i<sizeof(absolute)/sizeof(absolute[0]); i++) {
+		robot.moveToAngle(0, absolute[i]);
+		expected = absolute[i];
+		check(&robot, "moveToAngle", expected);
+	}
+
+	// Relative movements after the angle has been read from the motor (the measured angle is stored)
+	for (uint8_t i=0; i<4; i++) {
+		robot.getActAngle(0);
+		robot.checkIfMotorMoves(0);
+		robot.moveAngle(0, -5);
+		expected -= 5;
+		check(&robot, "read, move -", expected);
+	}
+
+	printf("%u failures\n", (unsigned)failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+"""
+Test of the backlash compensation of morobotClass (BACKLASH_TRAJECTORY), without hardware.
+
+The library is compiled for the PC with backlash_host.cpp, which replaces the motors by simulated motors with play between motor and
+joint. The test fails if relative or absolute movements do not end at the commanded joint angle. Needs g++ (or clang++).
+
+Usage:
+    test_backlash.py [--cxx g++]
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SRC = os.path.join(HERE, "..", "..", "src")
+STUBS = os.path.join(HERE, "..", "host_stubs")
+
+
+def build(cxx, output):
+    library = sorted(os.path.join(SRC, name) for name in os.listdir(SRC) if name.endswith(".cpp") and name != "MakeblockSmartServo.cpp")
+    sources = [os.path.join(HERE, "backlash_host.cpp")] + library + [os.path.join(STUBS, "arduino.cpp")]
+    # The library is written for the Arduino compiler, which accepts more than g++ on the PC
+    subprocess.check_call([cxx, "-std=gnu++11", "-fpermissive", "-w", "-DARDUINO_AVR_MEGA2560", "-I" + STUBS, "-I" + SRC] + sources + ["-o", output])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Test of the backlash compensation on the PC")
+    parser.add_argument("--cxx", default="g++", help="C++ compiler")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        host = os.path.join(tmp, "backlash_host")
+        build(args.cxx, host)
+        return subprocess.call([host])
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""
+Streams a G-code file to a morobot running the gcodeInterpreter (see src/gcode.h).
+
+Every line is sent as soon as the "ok" of the previous line has been received. The interpreter answers
+immediately while its lookahead buffer has space, so the robot keeps moving while the next lines are transferred.
+Lines answered with "error: ..." are reported and skipped.
+
+Usage:
+    gcode_stream.py drawing.gcode /dev/ttyACM0 [--baud 115200]   (needs pyserial)
+"""
+
+import argparse
+import sys
+import time
+
+
+def stream(lines, port, verbose=False):
+    errors = 0
+    for lineNr, line in enumerate(lines, 1):
+        line = line.split(";", 1)[0].strip()
+        if not line:
+            continue
+        port.write((line + "\n").encode("ascii"))
+        while True:
+            answer = port.readline().decode("ascii", "replace").strip()
+            if answer == "ok":
+                break
+            if answer.startswith("error"):
+                errors += 1
+                print("line %d (%s): %s" % (lineNr, line, answer), file=sys.stderr)
+                break
+            if answer and verbose:
+                print(answer)
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Stream G-code to a morobot")
+    parser.add_argument("file", help="G-code file")
+    parser.add_argument("port", help="serial port of the microcontroller")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("-v", "--verbose", action="store_true", help="print other messages of the robot")
+    args = parser.parse_args()
+
+    import serial
+    with open(args.file) as f, serial.Serial(args.port, args.baud) as port:
+        # Wait until the microcontroller has restarted and the interpreter is ready
+        port.timeout = 30
+        while b"Ready for G-code" not in port.readline():
+            pass
+        start = time.time()
+        errors = stream(f, port, args.verbose)
+        port.write(b"M400\n")	# Returns when all blocks have been executed
+        port.readline()
+        print("finished in %.1f s with %d error(s)" % (time.time() - start, errors))
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,472 @@
+#!/usr/bin/env python3
+"""
+Host client for the morobotServer binary protocol (see src/host_server.h).
+
+The client keeps track of sequence numbers and credits, so queued commands are pipelined:
+it sends as many commands as the robot has free queue slots and waits for ACK/DONE frames.
+
+Usage:
+    morobot_client.py PORT ping
+    morobot_client.py PORT status
+    morobot_client.py PORT pose X Y Z            # mm
+    morobot_client.py PORT linear X Y Z          # mm
+    morobot_client.py PORT angles A0 A1 A2 ...   # degrees
+    morobot_client.py PORT home | open | close | breaks | release
+    morobot_client.py PORT speed RPM
+    morobot_client.py PORT watch PERIOD_MS       # print status pushes
+    morobot_client.py PORT busstats [MOTOR]      # bus load, errors and round trip time histograms of a motor
+    morobot_client.py PORT resetstats            # reset the bus statistics
+    morobot_client.py --simulate <command ...>   # run against a simulated robot on a pseudo terminal (no hardware)
+    morobot_client.py --server EXE <command ...> # run against a host build of the C++ server (see server_host.cpp, test_server.py)
+
+PORT is a serial port (needs pyserial) or a pseudo terminal.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import threading
+import time
+
+SYNC = 0xA5
+MAX_FRAME_PAYLOAD = 3 + 5 * 4 + 5 * 2 + 2 * 4 * 8   # bus statistics frame (longer than a status frame)
+QUEUE_SIZE = 4
+
+CMD_PING = 0x00
+CMD_MOVE_POSE = 0x01
+CMD_MOVE_ANGLES = 0x02
+CMD_MOVE_LINEAR = 0x03
+CMD_SET_SPEED = 0x04
+CMD_MOVE_HOME = 0x05
+CMD_GRIPPER_OPEN = 0x06
+CMD_GRIPPER_CLOSE = 0x07
+CMD_SET_BREAKS = 0x08
+CMD_RELEASE_BREAKS = 0x09
+CMD_GET_STATUS = 0x10
+CMD_SET_STATUS_PERIOD = 0x11
+CMD_STOP = 0x12
+CMD_GET_BUS_STATS = 0x13
+CMD_RESET_BUS_STATS = 0x14
+
+# Commands which block the server until they finished: the next frame is only sent after their DONE
+BLOCKING_COMMANDS = (CMD_MOVE_LINEAR, CMD_MOVE_HOME)
+
+RSP_ACK = 0x80
+RSP_DONE = 0x81
+RSP_STATUS = 0x82
+RSP_BUS_STATS = 0x83
+
+ACK_NAMES = {0: "ok", 1: "queue full", 2: "checksum", 3: "unknown command", 4: "length", 5: "range"}
+STATUS_BUSY = 0x01
+STATUS_POSE_VALID = 0x02
+RTT_TYPES = ("move", "pwm", "read", "config")
+
+
+def crc8(data, crc=0):
+    for value in data:
+        crc ^= value
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def encode(seq, cmd, payload=b""):
+    body = bytes([len(payload), seq & 0xFF, cmd]) + bytes(payload)
+    return bytes([SYNC]) + body + bytes([crc8(body)])
+
+
+class FrameReader:
+    """Incremental frame parser, feed() returns complete (seq, cmd, payload) tuples."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+
+    def feed(self, data):
+        self.buffer += data
+        frames = []
+        while True:
+            start = self.buffer.find(bytes([SYNC]))
+            if start < 0:
+                self.buffer.clear()
+                return frames
+            del self.buffer[:start]
+            if len(self.buffer) < 5:
+                return frames
+            length = self.buffer[1]
+            if length > MAX_FRAME_PAYLOAD:
+                del self.buffer[0]
+                continue
+            if len(self.buffer) < 5 + length:
+                return frames
+            body = bytes(self.buffer[1:4 + length])
+            if crc8(body) != self.buffer[4 + length]:
+                del self.buffer[0]
+                continue
+            frames.append((body[1], body[2], body[3:]))
+            del self.buffer[:5 + length]
+
+
+def parse_status(payload):
+    flags, queued, n = payload[0], payload[1], payload[2]
+    angles = list(struct.unpack("<%dh" % n, payload[3:3 + 2 * n]))
+    status = {"busy": bool(flags & STATUS_BUSY), "queued": queued, "angles": angles}
+    if flags & STATUS_POSE_VALID:
+        status["pose"] = [v / 10.0 for v in struct.unpack("<3h", payload[3 + 2 * n:9 + 2 * n])]
+    return status
+
+
+def parse_bus_stats(payload):
+    motor, types, buckets = payload[0], payload[1], payload[2]
+    bus = struct.unpack("<5I", payload[3:23])
+    errors = struct.unpack("<5H", payload[23:33])
+    histogram = struct.unpack("<%dH" % (types * buckets), payload[33:33 + 2 * types * buckets])
+    stats = {"motor": motor}
+    stats["bus"] = dict(zip(("transactions", "bytes_sent", "bytes_received", "wait_us", "event_handle_us"), bus))
+    stats["errors"] = dict(zip(("timeouts", "bad_checksums", "busy", "errors", "retries"), errors))
+    # bucket k counts round trip times below 500 us * 2^k, the last one all longer ones
+    stats["rtt"] = {name: list(histogram[i * buckets:(i + 1) * buckets]) for i, name in enumerate(RTT_TYPES[:types])}
+    return stats
+
+
+class MorobotClient:
+    """Sends commands to a morobotServer. port needs read(n) (non-blocking or with timeout) and write(bytes)."""
+
+    def __init__(self, port, timeout=0.5, retries=3):
+        self.port = port
+        self.timeout = timeout
+        self.retries = retries
+        self.reader = FrameReader()
+        self.seq = 0
+        self.synced = False     # the first queued command is sent after a ping (see host_server.h)
+        self.credits = QUEUE_SIZE
+        self.pending = {}       # seq -> command of queued commands without DONE
+        self.done = {}          # seq -> result
+        self.acks = {}          # seq -> status
+        self.statuses = {}      # seq -> status of requested status frames
+        self.bus_stats = {}     # seq -> requested bus statistics
+        self.on_status = None   # callback for status pushes
+
+    def poll(self, duration=0.0):
+        """Reads and handles all frames received within duration seconds."""
+        end = time.time() + duration
+        while True:
+            data = self.port.read(64)
+            if data:
+                for seq, cmd, payload in self.reader.feed(data):
+                    self._handle(seq, cmd, payload)
+            elif time.time() >= end:
+                return
+            else:
+                time.sleep(0.001)
+
+    def _handle(self, seq, cmd, payload):
+        if cmd == RSP_ACK:
+            self.acks[seq] = payload[0]
+            self.credits = payload[1]
+        elif cmd == RSP_DONE:
+            self.pending.pop(seq, None)
+            self.done[seq] = payload[0]
+            self.credits = payload[1]
+        elif cmd == RSP_STATUS:
+            status = parse_status(payload)
+            if seq in self.acks and seq not in self.statuses:
+                self.statuses[seq] = status
+            elif self.on_status:
+                self.on_status(status)
+        elif cmd == RSP_BUS_STATS:
+            self.bus_stats[seq] = parse_bus_stats(payload)
+
+    def send(self, cmd, payload=b"", queued=True):
+        """Sends a command and waits for its ACK. Returns the sequence number."""
+        if any(pending in BLOCKING_COMMANDS for pending in self.pending.values()):
+            self.wait()
+        if queued and not self.synced:
+            self.ping()
+        self.synced = True
+        if queued:
+            while self.credits <= 0:
+                self.poll(0.01)
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        for _ in range(self.retries):
+            self.acks.pop(seq, None)
+            self.port.write(encode(seq, cmd, payload))
+            end = time.time() + self.timeout
+            while seq not in self.acks and time.time() < end:
+                self.poll(0.005)
+            if seq in self.acks and self.acks[seq] != 2:
+                break
+        status = self.acks.get(seq)
+        if status is None:
+            raise IOError("no answer from robot")
+        if status != 0:
+            raise IOError("command rejected: " + ACK_NAMES.get(status, str(status)))
+        if queued and seq not in self.done:
+            self.pending[seq] = cmd
+        return seq
+
+    def wait(self, seq=None, timeout=60):
+        """Waits until a queued command (or all queued commands) finished. Returns True if all succeeded."""
+        end = time.time() + timeout
+        while time.time() < end:
+            if (seq is None and not self.pending) or (seq is not None and seq in self.done):
+                break
+            self.poll(0.01)
+        else:
+            raise IOError("timeout while waiting for robot")
+        if seq is not None:
+            return self.done[seq] == 0
+        return all(result == 0 for result in self.done.values())
+
+    def ping(self):
+        self.send(CMD_PING, queued=False)
+        return self.credits
+
+    def status(self):
+        seq = self.send(CMD_GET_STATUS, queued=False)
+        end = time.time() + self.timeout
+        while seq not in self.statuses and time.time() < end:
+            self.poll(0.005)
+        return self.statuses.pop(seq, None)
+
+    def get_bus_stats(self, motor=0):
+        seq = self.send(CMD_GET_BUS_STATS, bytes([motor]), queued=False)
+        end = time.time() + self.timeout
+        while seq not in self.bus_stats and time.time() < end:
+            self.poll(0.005)
+        return self.bus_stats.pop(seq, None)
+
+    def reset_bus_stats(self):
+        self.send(CMD_RESET_BUS_STATS, queued=False)
+
+    def set_status_period(self, period_ms):
+        self.send(CMD_SET_STATUS_PERIOD, struct.pack("<H", period_ms), queued=False)
+
+    def stop(self):
+        self.send(CMD_STOP, queued=False)
+
+    def move_pose(self, x, y, z):
+        return self.send(CMD_MOVE_POSE, struct.pack("<3h", *[int(round(v * 10)) for v in (x, y, z)]))
+
+    def move_linear(self, x, y, z):
+        return self.send(CMD_MOVE_LINEAR, struct.pack("<3h", *[int(round(v * 10)) for v in (x, y, z)]))
+
+    def move_angles(self, angles):
+        return self.send(CMD_MOVE_ANGLES, bytes([len(angles)]) + struct.pack("<%dh" % len(angles), *[int(a) for a in angles]))
+
+    def set_speed(self, rpm):
+        return self.send(CMD_SET_SPEED, bytes([rpm]))
+
+    def home(self):
+        return self.send(CMD_MOVE_HOME)
+
+    def gripper_open(self):
+        return self.send(CMD_GRIPPER_OPEN)
+
+    def gripper_close(self):
+        return self.send(CMD_GRIPPER_CLOSE)
+
+    def set_breaks(self):
+        return self.send(CMD_SET_BREAKS)
+
+    def release_breaks(self):
+        return self.send(CMD_RELEASE_BREAKS)
+
+
+class SimulatedRobot(threading.Thread):
+    """Minimal simulation of morobotServer on a pseudo terminal (each movement takes motion_time seconds)."""
+
+    def __init__(self, fd, num_servos=3, motion_time=0.3):
+        super().__init__(daemon=True)
+        self.fd = fd
+        self.angles = [0] * num_servos
+        self.motion_time = motion_time
+        self.queue = []
+        self.active_until = None
+        self.period = 0
+        self.last_status = time.time()
+        self.push_seq = 0
+        self.last = None        # (seq, cmd) of the last frame if it has been queued
+
+    def write(self, seq, cmd, payload):
+        os.write(self.fd, encode(seq, cmd, payload))
+
+    def status(self, seq):
+        flags = STATUS_BUSY if self.active_until else STATUS_POSE_VALID
+        payload = bytes([flags, len(self.queue), len(self.angles)]) + struct.pack("<%dh" % len(self.angles), *self.angles)
+        if not self.active_until:
+            payload += struct.pack("<3h", 1500, 0, 1000)
+        self.write(seq, RSP_STATUS, payload)
+
+    def run(self):
+        reader = FrameReader()
+        os.set_blocking(self.fd, False)
+        while True:
+            try:
+                data = os.read(self.fd, 64)
+            except (BlockingIOError, OSError):
+                data = b""
+            for seq, cmd, payload in reader.feed(data):
+                credits = lambda: QUEUE_SIZE - len(self.queue)
+                repeated, self.last = self.last == (seq, cmd), None
+                if cmd == CMD_PING:
+                    self.write(seq, RSP_ACK, bytes([0, credits()]))
+                elif cmd == CMD_GET_STATUS:
+                    self.write(seq, RSP_ACK, bytes([0, credits()]))
+                    self.status(seq)
+                elif cmd == CMD_SET_STATUS_PERIOD:
+                    self.period = struct.unpack("<H", payload)[0] / 1000.0
+                    self.write(seq, RSP_ACK, bytes([0, credits()]))
+                elif cmd == CMD_STOP:
+                    keep = 1 if self.active_until else 0
+                    while len(self.queue) > keep:
+                        dropped = self.queue.pop()
+                        self.write(dropped[0], RSP_DONE, bytes([1, credits()]))
+                    self.write(seq, RSP_ACK, bytes([0, credits()]))
+                elif cmd == CMD_GET_BUS_STATS:
+                    if payload[0] >= len(self.angles):
+                        self.write(seq, RSP_ACK, bytes([5, credits()]))
+                        continue
+                    self.write(seq, RSP_ACK, bytes([0, credits()]))
+                    self.write(seq, RSP_BUS_STATS, bytes([payload[0], len(RTT_TYPES), 8]) + bytes(30 + 2 * len(RTT_TYPES) * 8))
+                elif cmd == CMD_RESET_BUS_STATS:
+                    self.write(seq, RSP_ACK, bytes([0, credits()]))
+                elif cmd <= CMD_RELEASE_BREAKS:
+                    if repeated:
+                        self.last = (seq, cmd)
+                        self.write(seq, RSP_ACK, bytes([0, credits()]))
+                    elif len(self.queue) >= QUEUE_SIZE:
+                        self.write(seq, RSP_ACK, bytes([1, credits()]))
+                    else:
+                        self.queue.append((seq, cmd, payload))
+                        self.last = (seq, cmd)
+                        self.write(seq, RSP_ACK, bytes([0, credits()]))
+                else:
+                    self.write(seq, RSP_ACK, bytes([3, credits()]))
+            now = time.time()
+            if self.active_until and now >= self.active_until:
+                seq, cmd, payload = self.queue.pop(0)
+                if cmd == CMD_MOVE_ANGLES:
+                    self.angles = list(struct.unpack("<%dh" % payload[0], payload[1:]))
+                self.active_until = None
+                self.write(seq, RSP_DONE, bytes([0, QUEUE_SIZE - len(self.queue)]))
+            if not self.active_until and self.queue:
+                self.active_until = now + self.motion_time
+            if self.period and now - self.last_status >= self.period:
+                self.last_status = now
+                self.status(self.push_seq)
+                self.push_seq = (self.push_seq + 1) & 0xFF
+            time.sleep(0.001)
+
+
+class PtyPort:
+    """File descriptor based port with the read/write interface of pyserial."""
+
+    def __init__(self, fd):
+        self.fd = fd
+        os.set_blocking(fd, False)
+
+    def read(self, n):
+        try:
+            return os.read(self.fd, n)
+        except (BlockingIOError, OSError):
+            return b""
+
+    def write(self, data):
+        return os.write(self.fd, data)
+
+
+def open_pty():
+    import pty
+    import tty
+    master, slave = pty.openpty()
+    tty.setraw(slave)
+    return master, slave
+
+
+def start_simulation():
+    """Starts SimulatedRobot on a pseudo terminal and returns the port of the host."""
+    master, slave = open_pty()
+    SimulatedRobot(master).start()
+    return PtyPort(slave)
+
+
+def start_server(executable):
+    """Starts a host build of the C++ server (talking on stdin/stdout) on a pseudo terminal and returns the port of the host."""
+    import subprocess
+    master, slave = open_pty()
+    server = subprocess.Popen([executable], stdin=master, stdout=master)
+    os.close(master)
+    port = PtyPort(slave)
+    port.process = server
+    return port
+
+
+def open_port(name, baud):
+    if name.startswith("/dev/pts/"):
+        return PtyPort(os.open(name, os.O_RDWR | os.O_NOCTTY))
+    import serial
+    return serial.Serial(name, baud, timeout=0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Control a morobot running morobotServer")
+    parser.add_argument("--simulate", action="store_true", help="use a simulated robot on a pseudo terminal")
+    parser.add_argument("--server", metavar="EXE", help="run a host build of the C++ server on a pseudo terminal")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("args", nargs="+", help="[PORT] COMMAND [VALUES]")
+    args = parser.parse_args()
+
+    if args.simulate:
+        port = start_simulation()
+        words = args.args
+    elif args.server:
+        port = start_server(args.server)
+        words = args.args
+    else:
+        port = open_port(args.args[0], args.baud)
+        words = args.args[1:]
+    if not words:
+        parser.error("missing command")
+
+    client = MorobotClient(port)
+    command, values = words[0], [float(v) for v in words[1:]]
+    start = time.time()
+    if command == "ping":
+        print("credits:", client.ping())
+    elif command == "status":
+        print(client.status())
+    elif command == "busstats":
+        print(client.get_bus_stats(int(values[0]) if values else 0))
+    elif command == "resetstats":
+        client.reset_bus_stats()
+    elif command == "watch":
+        client.on_status = print
+        client.set_status_period(int(values[0]) if values else 200)
+        try:
+            client.poll(1e9)
+        except KeyboardInterrupt:
+            client.set_status_period(0)
+    elif command == "demo":
+        # Pipelined sequence: all commands are sent while the robot is still moving
+        for angles in ([0, 30, 0], [30, 30, -20], [-30, 10, 20], [0, 0, 0]):
+            client.move_angles(angles)
+        print("all commands queued after %.3f s" % (time.time() - start))
+        print("finished:", client.wait(), "after %.3f s" % (time.time() - start))
+    else:
+        actions = {
+            "pose": lambda: client.move_pose(*values), "linear": lambda: client.move_linear(*values),
+            "angles": lambda: client.move_angles(values), "speed": lambda: client.set_speed(int(values[0])),
+            "home": client.home, "open": client.gripper_open, "close": client.gripper_close,
+            "breaks": client.set_breaks, "release": client.release_breaks,
+        }
+        if command not in actions:
+            parser.error("unknown command " + command)
+        seq = actions[command]()
+        print("finished:", client.wait(seq))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
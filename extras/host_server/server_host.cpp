@@ -0,0 +1,143 @@
+/**
+ *  \file 	server_host.cpp
+ *  \brief 	Runs morobotServer (src/host_server.cpp) on a PC with a simulated robot, so the protocol can be tested without hardware
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Notes:
+ *  	The server talks to the host on stdin/stdout, test_server.py connects it to a pseudo terminal and runs morobot_client.py against it.
+ *  	Only host_server.cpp (and the classes morobotClass contains) is taken from the library. The functions of morobotClass it calls are replaced by the simulation below:
+ *  	every movement takes SIM_MOVE_TIME ms, moveLinear() and moveHome() block for SIM_BLOCK_TIME ms like on the robot and poses with z < 0 can not be reached.
+ *  	The server runs without gripper (gripper commands fail). The functions the path controller of morobotBase calls are empty, the server never moves along a path.
+ *  	Build (see test_server.py):
+ *  		g++ -std=gnu++11 -Wno-narrowing -Wno-overflow -I../host_stubs -I../../src server_host.cpp ../../src/host_server.cpp \
+ *  			../../src/servo_parser.cpp ../../src/transport.cpp ../../src/estimator.cpp ../../src/path.cpp ../host_stubs/arduino.cpp -o server_host
+ */
+
+#include "host_server.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define SIM_NUM_SERVOS	3		//!< Number of motors of the simulated robot
+#define SIM_MOVE_TIME	300		//!< Duration of every movement in ms
+#define SIM_BLOCK_TIME	2000	//!< Duration of moveLinear() and moveHome() in ms (longer than the ACK timeout of the client)
+
+static long simAngles[SIM_NUM_SERVOS];	//!< Angles of the simulated motors
+static unsigned long simMoveEnd = 0;	//!< Time the current movement ends
+static uint32_t simMoves = 0;			//!< Number of movements (counted as bus transactions, so the host can check how often a command ran)
+
+/**
+ *  \brief Port of the host on stdin/stdout
+ */
+class stdioStream : public Stream {
+	public:
+		stdioStream() : _peek(-1), _eof(false) { fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK); }
+		int available() { return (peek() >= 0) ? 1 : 0; }
+		int read() { int value = peek(); _peek = -1; return value; }
+		int peek() {
+			if (_peek >= 0) return _peek;
+			uint8_t value;
+			ssize_t n = ::read(STDIN_FILENO, &value, 1);
+			if (n == 1) _peek = value;
+			else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) _eof = true;
+			return _peek;
+		}
+		size_t write(uint8_t value) { return write(&value, 1); }
+		size_t write(const uint8_t* buffer, size_t size) { return (::write(STDOUT_FILENO, buffer, size) == (ssize_t)size) ? size : 0; }
+		bool isClosed() { return _eof; }
+	private:
+		int _peek;
+		bool _eof;
+};
+
+/**
+ *  \brief Simulated robot, only the pure virtual functions are needed to create it
+ */
+class simRobot : public morobotBase<SIM_NUM_SERVOS, simRobot> {
+	public:
+		void setTCPoffset(float, float, float) {}
+		bool checkIfAngleValid(uint8_t, float) { return true; }
+		const char* getType() { return "sim"; }
+		uint8_t getTypeId() { return 0; }
+		bool calculateAngles(float, float, float) { return true; }
+		void updateTCPpose(bool) {}
+};
+
+static void simStartMove(){
+	simMoveEnd = millis() + SIM_MOVE_TIME;
+	simMoves++;
+}
+
+/* Functions of the library used by host_server.cpp */
+morobotClass::morobotClass(uint8_t numSmartServos){ _numSmartServos = numSmartServos; }
+void morobotClass::initJointStorage(){}
+bool morobotClass::calculateGoalAngles(const float[3]){ return true; }
+uint8_t morobotClass::getNumSmartServos(){ return _numSmartServos; }
+long morobotClass::getActAngle(uint8_t servoId){ return simAngles[servoId]; }
+float morobotClass::getActPosition(char axis){ return (axis == 'z') ? 100 : 0; }
+float morobotClass::getSpeed(uint8_t){ return (millis() < simMoveEnd) ? 10 : 0; }
+void morobotClass::setIdle(){}
+bool morobotClass::moveToPose(float, float, float z){
+	if (z < 0) return false;
+	simStartMove();
+	return true;
+}
+void morobotClass::moveLinear(float*, int, float, int){
+	simStartMove();
+	delay(SIM_BLOCK_TIME);
+}
+void morobotClass::moveToAngles(long angles[]){
+	for (uint8_t i=0; i<SIM_NUM_SERVOS; i++) simAngles[i] = angles[i];
+	simStartMove();
+}
+void morobotClass::moveHome(){
+	for (uint8_t i=0; i<SIM_NUM_SERVOS; i++) simAngles[i] = 0;
+	delay(SIM_BLOCK_TIME);
+}
+void morobotClass::setSpeedRPM(uint8_t){}
+void morobotClass::setBreaks(){}
+void morobotClass::releaseBreaks(){}
+servo_bus_stats_type morobotClass::getBusStats(){
+	servo_bus_stats_type stats = {};
+	stats.transactions = simMoves;
+	return stats;
+}
+servo_error_type morobotClass::getBusErrors(uint8_t){
+	servo_error_type errors = {};
+	return errors;
+}
+bool morobotClass::getRttHistogram(uint8_t, uint8_t, uint16_t histogram[SERVO_STATS_BUCKETS]){
+	memset(histogram, 0, SERVO_STATS_BUCKETS*sizeof(uint16_t));
+	return false;
+}
+void morobotClass::resetBusStats(){ simMoves = 0; }
+void morobotClass::resetBusErrors(){}
+/* Used by the path controller of morobotBase, which the server never calls */
+void morobotClass::invalidateJointState(){}
+joint_estimate_type morobotClass::getEstimate(uint8_t){
+	joint_estimate_type estimate = {};
+	return estimate;
+}
+void morobotClass::moveToAngle(uint8_t, long){}
+void morobotClass::markJointCommanded(uint8_t, long, bool){}
+void morobotClass::sendPwm(uint8_t, float){}
+bool morobotClass::seedEstimators(){ return false; }
+float morobotClass::calcPwm(uint8_t, float){ return 0; }
+float morobotClass::calcTrapezoidalProfile(float, float, float, float){ return 0; }
+bool morobotClass::checkForNANerror(uint8_t, float){ return false; }
+void morobotClass::printInvalidAngleError(uint8_t, float){}
+bool gripper::startOpen(){ return false; }
+bool gripper::startClose(){ return false; }
+bool gripper::isFinished(){ return true; }
+
+int main(){
+	simRobot robot;
+	stdioStream host;
+	morobotServer server(&robot);
+	server.begin(&host);
+	while (!host.isClosed()) {
+		server.update();
+		usleep(500);
+	}
+	return 0;
+}
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+Tests the C++ morobotServer (src/host_server.cpp) with morobot_client.py, without hardware.
+
+The server is compiled for the PC together with a simulated robot (server_host.cpp) and runs on a pseudo terminal.
+Needs g++ and Linux (or another system with pseudo terminals).
+
+Usage:
+    test_server.py [--cxx g++]
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+from morobot_client import (CMD_MOVE_ANGLES, CMD_MOVE_POSE, MorobotClient, encode, start_server)
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SRC = os.path.join(HERE, "..", "..", "src")
+STUBS = os.path.join(HERE, "..", "host_stubs")
+
+
+def build(cxx, output):
+    sources = [os.path.join(HERE, "server_host.cpp"), os.path.join(SRC, "host_server.cpp"), os.path.join(SRC, "servo_parser.cpp"),
+               os.path.join(SRC, "transport.cpp"), os.path.join(SRC, "estimator.cpp"),
+               os.path.join(SRC, "path.cpp"), os.path.join(STUBS, "arduino.cpp")]
+    subprocess.check_call([cxx, "-std=gnu++11", "-Wno-narrowing", "-Wno-overflow", "-I" + STUBS, "-I" + SRC] + sources + ["-o", output])
+
+
+def moves(client):
+    """Number of movements the simulated robot executed (reported as bus transactions)."""
+    return client.get_bus_stats(0)["bus"]["transactions"]
+
+
+def test_pipelined(client):
+    client.reset_bus_stats()
+    start = time.time()
+    for angles in ([0, 30, 0], [30, 30, -20], [-30, 10, 20], [10, 20, 30]):
+        client.move_angles(angles)
+    queued = time.time() - start
+    assert client.wait(), "pipelined commands failed"
+    assert queued < 0.2, "commands were not pipelined (%.3f s)" % queued
+    assert client.status()["angles"] == [10, 20, 30]
+    assert moves(client) == 4
+
+
+def test_repeated_frame(client):
+    # The ACK of the first frame is lost: the client sends the frame again with the same seq
+    client.reset_bus_stats()
+    seq = client.seq
+    client.seq = (client.seq + 1) & 0xFF
+    frame = encode(seq, CMD_MOVE_ANGLES, bytes([3]) + struct.pack("<3h", 5, 5, 5))
+    client.port.write(frame)
+    client.poll(0.05)
+    del client.acks[seq]
+    client.port.write(frame)
+    client.poll(0.05)
+    assert client.acks.get(seq) == 0, "repeated frame not acknowledged"
+    client.pending[seq] = CMD_MOVE_ANGLES
+    assert client.wait(seq)
+    client.poll(0.5)
+    assert moves(client) == 1, "repeated frame executed twice"
+
+    # The same seq after another frame is a new command
+    client.ping()
+    client.seq = seq
+    client.move_angles([6, 6, 6])
+    assert client.wait()
+
+
+def test_checksum(client):
+    seq = client.seq
+    frame = bytearray(encode(seq, CMD_MOVE_POSE, struct.pack("<3h", 1500, 0, 1000)))
+    frame[-1] ^= 0xFF
+    client.port.write(bytes(frame))
+    client.poll(0.05)
+    assert client.acks.get(seq) == 2
+
+
+def test_failed_commands(client):
+    assert not client.wait(client.move_pose(150, 0, -10)), "unreachable pose reported as done"
+    assert not client.wait(client.gripper_open()), "gripper command without gripper reported as done"
+    client.done.clear()
+
+
+def test_blocking(client):
+    # moveLinear blocks the server, the following commands must still be acknowledged
+    start = time.time()
+    client.move_linear(150, 0, 100)
+    client.move_pose(150, 0, 100)
+    seq = client.home()
+    assert client.wait(seq)
+    assert time.time() - start >= 4.0
+
+
+def test_stop(client):
+    for angles in ([1, 1, 1], [2, 2, 2], [3, 3, 3]):
+        last = client.move_angles(angles)
+    client.stop()
+    assert not client.wait(last), "queued command not dropped by stop"
+    client.done.clear()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Test morobotServer on the PC")
+    parser.add_argument("--cxx", default="g++", help="C++ compiler")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        executable = os.path.join(tmp, "server_host")
+        build(args.cxx, executable)
+        port = start_server(executable)
+        client = MorobotClient(port)
+        failed = 0
+        for test in (test_pipelined, test_repeated_frame, test_checksum, test_failed_commands, test_blocking, test_stop):
+            try:
+                test(client)
+                print("ok     " + test.__name__)
+            except (AssertionError, IOError) as error:
+                failed += 1
+                print("FAILED %s: %s" % (test.__name__, error))
+        os.close(port.fd)
+        port.process.wait()
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,91 @@
+/**
+ *  \file 	Arduino.h
+ *  \brief 	Minimal replacement of the Arduino core, so parts of the library can be compiled and tested on a PC (see extras/host_server and extras/servo_parser)
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Notes:
+ *  	Only what the headers of the library need to compile is declared. Time functions are real (arduino.cpp), everything printed with Serial is dropped.
+ *  	Compile with -Wno-narrowing (the Arduino toolchain accepts narrowing conversions in initializers).
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+class __FlashStringHelper;
+#define F(x) (reinterpret_cast<const __FlashStringHelper*>(x))
+#define PROGMEM
+#define PSTR(x) x
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_float(p) (*(const float*)(p))
+
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+#define SERIAL_8N1 0
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+template<class T> T constrain(T x, T low, T high) { return x < low ? low : (x > high ? high : x); }
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+class Print {
+	public:
+		virtual ~Print() {}
+		virtual size_t write(uint8_t value)=0;
+		virtual size_t write(const uint8_t* buffer, size_t size) { for (size_t i=0; i<size; i++) write(buffer[i]); return size; }
+		size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+		template<class T> size_t print(T) { return 0; }
+		template<class T> size_t print(T, int) { return 0; }
+		template<class T> size_t println(T) { return 0; }
+		template<class T> size_t println(T, int) { return 0; }
+		size_t println() { return 0; }
+		virtual void flush() {}
+};
+
+class Stream : public Print {
+	public:
+		virtual int available()=0;
+		virtual int read()=0;
+		virtual int peek()=0;
+		size_t readBytes(uint8_t* buffer, size_t size) { size_t n=0; while (n<size && available()>0) buffer[n++] = read(); return n; }
+		size_t readBytes(char* buffer, size_t size) { return readBytes((uint8_t*)buffer, size); }
+		void setTimeout(unsigned long) {}
+};
+
+class HardwareSerial : public Stream {
+	public:
+		void begin(unsigned long) {}
+		void begin(unsigned long, int, int, int) {}
+		void end() {}
+		int available() { return 0; }
+		int read() { return -1; }
+		int peek() { return -1; }
+		size_t write(uint8_t) { return 1; }
+		using Print::write;
+		int availableForWrite() { return 64; }
+		operator bool() { return true; }
+};
+
+extern HardwareSerial Serial, Serial1, Serial2, Serial3;
+
+#endif
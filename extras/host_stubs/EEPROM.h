@@ -0,0 +1,25 @@
+/**
+ *  \file 	EEPROM.h
+ *  \brief 	EEPROM of the minimal Arduino core for the PC (kept in RAM, see Arduino.h)
+ */
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stdint.h>
+
+class EEPROMClass {
+	public:
+		uint8_t read(int address) { return _data[address]; }
+		void write(int address, uint8_t value) { _data[address] = value; }
+		void update(int address, uint8_t value) { _data[address] = value; }
+		uint16_t length() { return sizeof(_data); }
+		void begin(int) {}
+		bool commit() { return true; }
+	private:
+		uint8_t _data[4096];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ *  \file 	Servo.h
+ *  \brief 	Servo library of the minimal Arduino core for the PC (does nothing, see Arduino.h)
+ */
+
+#ifndef HOST_SERVO_H
+#define HOST_SERVO_H
+
+class Servo {
+	public:
+		void attach(int) {}
+		void write(int) {}
+};
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ *  \file 	arduino.cpp
+ *  \brief 	Time functions and serial ports of the minimal Arduino core for the PC (see Arduino.h)
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ */
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial, Serial1, Serial2, Serial3;
+EEPROMClass EEPROM;
+
+static unsigned long long nowUs(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec*1000000ULL + now.tv_nsec/1000;
+}
+
+unsigned long millis(){
+	return (unsigned long)(nowUs()/1000);
+}
+
+unsigned long micros(){
+	return (unsigned long)nowUs();
+}
+
+void delay(unsigned long ms){
+	usleep(ms*1000);
+}
+
+void delayMicroseconds(unsigned int us){
+	usleep(us);
+}
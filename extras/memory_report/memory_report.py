@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""
+Reports the static RAM and the worst-case stack usage of the functions of a sketch built for an AVR board (e.g. Arduino Mega).
+
+The static RAM is read from the ELF file (.data and .bss, largest variables first). The stack usage of each function is
+taken from the .su files written by the compiler with -fstack-usage. The call graph is read from the disassembly, so the
+worst-case stack of a function includes everything it calls. Calls through function pointers or virtual functions
+(icall/eicall) cannot be followed and are marked with "+?". Functions with dynamic stack (e.g. alloca) are marked with "!".
+
+Build the sketch without link time optimization, otherwise the .su files do not match the functions of the ELF file:
+    arduino-cli compile -b arduino:avr:mega --build-path build \\
+        --build-property "compiler.cpp.extra_flags=-fstack-usage -fno-lto" \\
+        --build-property "compiler.c.elf.extra_flags=-fno-lto" examples/multiple_robots
+
+Usage:
+    memory_report.py build [--filter morobotClass::] [--top 30] [--pc-bytes 3] [--toolchain-prefix avr-]
+"""
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+
+CALL_RE = re.compile(r"\s(e?call|r?call)\s.*<([^>+]+)(\+0x[0-9a-f]+)?>")
+JUMP_RE = re.compile(r"\s(r?jmp)\s.*<([^>+]+)>")
+INDIRECT_RE = re.compile(r"\s(e?icall|e?ijmp)\b")
+LABEL_RE = re.compile(r"^[0-9a-f]+ <(.+)>:$")
+
+
+def run(cmd):
+    try:
+        return subprocess.run(cmd, check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+    except (OSError, subprocess.CalledProcessError) as error:
+        sys.exit("ERROR: %s failed: %s" % (cmd[0], error))
+
+
+def find_elf(build):
+    elfs = glob.glob(os.path.join(build, "*.elf"))
+    if len(elfs) != 1:
+        sys.exit("ERROR: expected one .elf file in %s, found %d" % (build, len(elfs)))
+    return elfs[0]
+
+
+def read_static_ram(elf, prefix):
+    sections = {}
+    for line in run([prefix + "size", "-A", elf]).splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0] in (".data", ".bss", ".noinit"):
+            sections[parts[0]] = int(parts[1])
+    variables = []
+    for line in run([prefix + "nm", "-C", "-S", "--size-sort", elf]).splitlines():
+        parts = line.split(None, 3)
+        if len(parts) == 4 and parts[2] in "dDbB":
+            variables.append((int(parts[1], 16), parts[3]))
+    variables.sort(reverse=True)
+    return sections, variables
+
+
+def read_stack_usage(build):
+    """Returns {function name: (bytes, dynamic)} from all .su files"""
+    usage = {}
+    for path in glob.glob(os.path.join(build, "**", "*.su"), recursive=True):
+        with open(path) as su:
+            for line in su:
+                parts = line.rstrip("\n").split("\t")
+                if len(parts) < 3:
+                    continue
+                location, size, kind = parts[0], int(parts[1]), parts[2]
+                name = base_name(location.split(":", 3)[-1])
+                old = usage.get(name, (0, False))
+                usage[name] = (max(size, old[0]), old[1] or kind != "static")
+    return usage
+
+
+def base_name(name):
+    """Returns the qualified name of a function without return type and parameters
+    ("bool morobotClass::moveToPose(float, float, float)" -> "morobotClass::moveToPose").
+    The .su files and the disassembly spell parameter types differently (uint8_t, unsigned char), so overloads
+    share one entry and the largest of them is used."""
+    depth = 0
+    start = 0
+    for i, char in enumerate(name):
+        if char == "<":
+            depth += 1
+        elif char == ">":
+            depth -= 1
+        elif char == " " and depth == 0:
+            start = i + 1
+        elif char == "(" and depth == 0 and i > 0:
+            return name[start:i]
+    return name[start:]
+
+
+def read_call_graph(elf, prefix, pcBytes):
+    """Returns {function: [(callee, extra bytes)]} and the set of functions with indirect calls"""
+    graph = {}
+    indirect = set()
+    function = None
+    for line in run([prefix + "objdump", "-d", "-C", elf]).splitlines():
+        label = LABEL_RE.match(line)
+        if label:
+            function = base_name(label.group(1))
+            graph.setdefault(function, [])
+            continue
+        if function is None:
+            continue
+        call = CALL_RE.search(line)
+        if call:
+            graph[function].append((base_name(call.group(2)), pcBytes))
+            continue
+        jump = JUMP_RE.search(line)
+        if jump and base_name(jump.group(2)) != function:
+            graph[function].append((base_name(jump.group(2)), 0))		# tail call
+            continue
+        if INDIRECT_RE.search(line):
+            indirect.add(function)
+    return graph, indirect
+
+
+def worst_case(function, graph, usage, indirect, cache, active):
+    """Returns (bytes, unknown) with unknown set if an indirect call, a recursion or dynamic stack was found"""
+    if function in cache:
+        return cache[function]
+    if function in active:
+        return 0, True
+    active.add(function)
+    own, dynamic = usage.get(function, (0, False))
+    best, unknown = 0, dynamic or function in indirect
+    for callee, extra in graph.get(function, []):
+        size, calleeUnknown = worst_case(callee, graph, usage, indirect, cache, active)
+        best = max(best, size + extra)
+        unknown = unknown or calleeUnknown
+    active.discard(function)
+    cache[function] = (own + best, unknown)
+    return cache[function]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Static RAM and worst-case stack report of a sketch")
+    parser.add_argument("build", help="build directory with the .elf and .su files")
+    parser.add_argument("--filter", default="morobot", help="only list functions containing this text (default: morobot)")
+    parser.add_argument("--top", type=int, default=30, help="number of variables and functions listed")
+    parser.add_argument("--pc-bytes", type=int, default=3, help="bytes pushed by a call (3 on the Mega, 2 on the Uno)")
+    parser.add_argument("--toolchain-prefix", default="avr-", help="prefix of size, nm and objdump")
+    args = parser.parse_args()
+
+    elf = find_elf(args.build)
+    sections, variables = read_static_ram(elf, args.toolchain_prefix)
+    print("Static RAM: %d bytes (%s)" % (sum(sections.values()),
+          ", ".join("%s %d" % item for item in sorted(sections.items()))))
+    for size, name in variables[:args.top]:
+        print("  %6d  %s" % (size, name))
+
+    usage = read_stack_usage(args.build)
+    if not usage:
+        sys.exit("ERROR: no .su files found, build with -fstack-usage")
+    graph, indirect = read_call_graph(elf, args.toolchain_prefix, args.pc_bytes)
+    cache = {}
+    report = []
+    for function in graph:
+        if args.filter in function:
+            size, unknown = worst_case(function, graph, usage, indirect, cache, set())
+            own, dynamic = usage.get(function, (0, False))
+            report.append((size, own, unknown, dynamic, function))
+    report.sort(reverse=True)
+
+    print()
+    print("Worst-case stack per function (own stack in brackets, +? indirect calls or recursion not included, ! dynamic):")
+    for size, own, unknown, dynamic, function in report[:args.top]:
+        print("  %6d%-2s (%4d%s)  %s" % (size, "+?" if unknown else "", own, "!" if dynamic else " ", function))
+
+
+if __name__ == "__main__":
+    main()
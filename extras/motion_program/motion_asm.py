@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Assembler for morobot motion programs (see src/motion_program.h for the bytecode format).
+
+Source syntax (one instruction per line, '#' starts a comment):
+    speed 20                # set default speed in RPM
+    pose 150 0 100          # moveToPose, x y z in mm
+    angles 0 45 -30         # moveToAngles, one angle per servo in degrees
+    linear 150 50 100       # moveLinear, x y z in mm
+    open / close            # gripper
+    wait 500                # wait in ms
+    loop 3 ... endloop      # repeat block (loop 0 = forever)
+
+Usage:
+    motion_asm.py program.txt -o program.bin          # write binary program
+    motion_asm.py program.txt --c-array pickPlace      # print PROGMEM array for a sketch
+    motion_asm.py program.txt --send /dev/ttyACM0      # stream program to motionProgram::receive() (needs pyserial)
+"""
+
+import argparse
+import struct
+import sys
+
+VERSION = 1
+OPCODES = {
+    "end": 0x00, "pose": 0x01, "angles": 0x02, "linear": 0x03, "open": 0x04, "close": 0x05,
+    "wait": 0x06, "loop": 0x07, "endloop": 0x08, "speed": 0x09,
+}
+
+
+class AssemblerError(Exception):
+    pass
+
+
+def assemble(source):
+    """Translates program source into bytecode (including header and OP_END)."""
+    out = bytearray(b"MP" + bytes([VERSION]))
+    depth = 0
+    for lineNr, line in enumerate(source.splitlines(), 1):
+        tokens = line.split("#", 1)[0].split()
+        if not tokens:
+            continue
+        name, args = tokens[0].lower(), tokens[1:]
+        if name not in OPCODES:
+            raise AssemblerError("line %d: unknown instruction '%s'" % (lineNr, name))
+        try:
+            values = [float(a) for a in args]
+        except ValueError:
+            raise AssemblerError("line %d: arguments must be numbers" % lineNr)
+
+        def expect(count):
+            if len(values) != count:
+                raise AssemblerError("line %d: '%s' expects %d argument(s)" % (lineNr, name, count))
+
+        out.append(OPCODES[name])
+        if name in ("pose", "linear"):
+            expect(3)
+            out += struct.pack("<3h", *[int(round(v * 10)) for v in values])
+        elif name == "angles":
+            if not values:
+                raise AssemblerError("line %d: 'angles' expects at least one angle" % lineNr)
+            out.append(len(values))
+            out += struct.pack("<%dh" % len(values), *[int(round(v)) for v in values])
+        elif name in ("wait", "loop"):
+            expect(1)
+            out += struct.pack("<H", int(values[0]))
+            if name == "loop":
+                depth += 1
+        elif name == "speed":
+            expect(1)
+            out.append(int(values[0]) & 0xFF)
+        else:
+            expect(0)
+            if name == "endloop":
+                depth -= 1
+                if depth < 0:
+                    raise AssemblerError("line %d: 'endloop' without 'loop'" % lineNr)
+    if depth != 0:
+        raise AssemblerError("missing 'endloop'")
+    out.append(OPCODES["end"])
+    return bytes(out)
+
+
+def frame(program):
+    """Frames a program for motionProgram::receive()."""
+    return b"MB" + struct.pack("<H", len(program)) + program + bytes([sum(program) & 0xFF])
+
+
+def cArray(program, name):
+    lines = ["const uint8_t %s[] PROGMEM = {" % name]
+    for i in range(0, len(program), 12):
+        lines.append("\t" + ", ".join("0x%02X" % b for b in program[i:i + 12]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Assembler for morobot motion programs")
+    parser.add_argument("source", help="program source file ('-' for stdin)")
+    parser.add_argument("-o", "--output", help="write binary program to file")
+    parser.add_argument("--c-array", metavar="NAME", help="print program as PROGMEM array")
+    parser.add_argument("--send", metavar="PORT", help="send framed program to serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    source = sys.stdin.read() if args.source == "-" else open(args.source).read()
+    try:
+        program = assemble(source)
+    except AssemblerError as error:
+        sys.exit("error: %s" % error)
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(program)
+    if args.c_array:
+        print(cArray(program, args.c_array))
+    if args.send:
+        import serial
+        with serial.Serial(args.send, args.baud) as port:
+            port.write(frame(program))
+    print("%d bytes" % len(program), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
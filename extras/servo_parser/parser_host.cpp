@@ -0,0 +1,273 @@
+/**
+ *  \file 	parser_host.cpp
+ *  \brief 	Fuzz test and throughput benchmark of servoFrameParser (src/servo_parser.cpp) on a PC
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Notes:
+ *  	fuzz [iterations] [seed]: Builds random streams of valid frames, frames with wrong checksum, truncated and too long frames and noise,
+ *  	splits them into random chunks and checks that exactly the valid frames are received in the right order. Random bytes are parsed
+ *  	with different chunk sizes as well, the results must not depend on how the bytes are split into chunks.
+ *  	bench [megabytes]: Parses a stream of typical responses with different chunk sizes and prints the throughput.
+ *  	Build (see test_parser.py, which also builds with the address and undefined behaviour sanitizers):
+ *  		g++ -std=gnu++11 -O2 -I../host_stubs -I../../src parser_host.cpp ../../src/servo_parser.cpp ../host_stubs/arduino.cpp -o parser_host
+ */
+
+#include "servo_parser.h"
+#include <stdio.h>
+#include <time.h>
+
+#define FUZZ_STREAM_SIZE	4096	//!< Maximum length of a random stream in bytes
+#define FUZZ_MAX_FRAMES		512		//!< Maximum number of results of a stream
+#define BENCH_DATA_LENGTH	9		//!< Data bytes of a response in the benchmark (e.g. the angle of a motor)
+
+typedef struct {
+	uint8_t result;								//!< Result of parse() (SERVO_FRAME_COMPLETE, SERVO_FRAME_BAD_CHECKSUM, SERVO_FRAME_DROPPED)
+	uint8_t length;								//!< Number of bytes between start and end (complete frames only)
+	uint8_t bytes[SERVO_FRAME_MAX_LENGTH];		//!< Bytes between start and end (complete frames only)
+} result_type;
+
+typedef struct {
+	uint8_t data[FUZZ_STREAM_SIZE];	//!< Bytes of the stream
+	uint16_t length;				//!< Number of bytes
+	result_type expected[FUZZ_MAX_FRAMES];	//!< Valid frames of the stream
+	uint16_t numExpected;			//!< Number of valid frames
+} stream_type;
+
+static uint32_t randomState;	//!< State of the random number generator (the same seed gives the same streams on every PC)
+static uint32_t failures = 0;	//!< Number of failed checks
+
+static uint32_t nextRandom(){
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static uint32_t randomBelow(uint32_t limit){
+	return nextRandom() % limit;
+}
+
+static void fail(const char* message, uint32_t iteration){
+	if (failures++ < 10) printf("FAILED iteration %u: %s\n", (unsigned)iteration, message);
+}
+
+/**
+ *  \brief Appends a frame with the given number of bytes between start and end, returns false if the stream is full
+ */
+static bool appendFrame(stream_type* stream, uint8_t length, bool validChecksum, bool addEnd){
+	if (stream->length + length + 2 > FUZZ_STREAM_SIZE) return false;
+	uint8_t* frame = &stream->data[stream->length + 1];
+	stream->data[stream->length] = SERVO_FRAME_START;
+	uint8_t checksum = 0;
+	for (uint8_t i=0; i+1<length; i++) {
+		frame[i] = randomBelow(0x80);
+		checksum += frame[i];
+	}
+	if (length > 0) frame[length-1] = validChecksum ? (checksum & 0x7f) : ((checksum + 1 + randomBelow(0x7f)) & 0x7f);
+	stream->length += length + 1;
+	if (addEnd) stream->data[stream->length++] = SERVO_FRAME_END;
+	return true;
+}
+
+/**
+ *  \brief Builds a random stream and stores the valid frames it contains
+ */
+static void buildStream(stream_type* stream){
+	stream->length = 0;
+	stream->numExpected = 0;
+	bool open = false;	// the last part is a frame without end, the next part must end it
+	while (stream->numExpected < FUZZ_MAX_FRAMES) {
+		uint8_t type = randomBelow(6);
+		if (open && type == 4) type = 0;	// 7 bit noise would continue the open frame
+		bool added = true;
+		switch (type) {
+			case 0: case 1: {	// valid frame
+				uint8_t length = 3 + randomBelow(SERVO_FRAME_MAX_LENGTH - 2);
+				uint16_t start = stream->length + 1;
+				added = appendFrame(stream, length, true, true);
+				if (added) {
+					result_type* expected = &stream->expected[stream->numExpected++];
+					expected->result = SERVO_FRAME_COMPLETE;
+					expected->length = length;
+					memcpy(expected->bytes, &stream->data[start], length);
+				}
+				break;
+			}
+			case 2:				// wrong checksum or too short
+				added = appendFrame(stream, randomBelow(SERVO_FRAME_MAX_LENGTH + 1), false, true);
+				break;
+			case 3:				// too long
+				added = appendFrame(stream, SERVO_FRAME_MAX_LENGTH + 1 + randomBelow(80), true, true);
+				break;
+			case 4:				// 7 bit noise between frames (skipped while no frame is parsed)
+				for (uint8_t i=randomBelow(8); i>0 && stream->length<FUZZ_STREAM_SIZE; i--) stream->data[stream->length++] = randomBelow(0x80);
+				break;
+			case 5:				// truncated frame, ended by the next start or by a byte with the highest bit set
+				added = appendFrame(stream, randomBelow(SERVO_FRAME_MAX_LENGTH), true, false);
+				if (added && randomBelow(2) && stream->length < FUZZ_STREAM_SIZE) {
+					uint8_t noise = 0x80 + randomBelow(0x80);
+					if (noise == SERVO_FRAME_START || noise == SERVO_FRAME_END) noise = 0xFF;
+					stream->data[stream->length++] = noise;
+				}else if (added) {
+					open = true;
+					continue;
+				}
+				break;
+		}
+		if (!added) break;
+		open = false;
+	}
+}
+
+/**
+ *  \brief Parses a stream in chunks of random size (maxChunk = 0) or of the given size, returns the number of results
+ */
+static uint16_t parseStream(const uint8_t* data, uint16_t length, uint8_t maxChunk, result_type* results, uint16_t maxResults, uint32_t iteration){
+	servoFrameParser parser;
+	uint16_t numResults = 0;
+	uint16_t position = 0;
+	while (position < length) {
+		uint16_t chunk = (maxChunk == 0) ? 1 + randomBelow(255) : maxChunk;
+		if (chunk > length - position) chunk = length - position;
+		// Copy the chunk like the transport does, so frames pointing into the chunk are checked before the buffer is reused
+		uint8_t buffer[255];
+		memcpy(buffer, &data[position], chunk);
+		uint8_t offset = 0;
+		while (offset < chunk) {
+			servo_frame_type frame;
+			uint8_t used = 0xff;
+			uint8_t result = parser.parse(&buffer[offset], chunk - offset, &frame, &used);
+			if (used > chunk - offset) {
+				fail("more bytes used than received", iteration);
+				return numResults;
+			}
+			// A new start which ends a frame is kept, so used can be 0 only after a dropped frame
+			if (used == 0 && result != SERVO_FRAME_DROPPED) {
+				fail("no progress", iteration);
+				return numResults;
+			}
+			offset += used;
+			if (result == SERVO_FRAME_INCOMPLETE) continue;
+			if (numResults >= maxResults) continue;
+			result_type* stored = &results[numResults++];
+			stored->result = result;
+			stored->length = 0;
+			if (result != SERVO_FRAME_COMPLETE) continue;
+			if (frame.length > SERVO_FRAME_MAX_LENGTH - 3) {
+				fail("frame too long", iteration);
+				continue;
+			}
+			uint8_t checksum = frame.devId + frame.srvId;
+			for (uint8_t i=0; i<frame.length; i++) checksum += frame.data[i];
+			if (frame.devId >= 0x80 || frame.srvId >= 0x80 || (checksum & 0x7f) != frame.data[frame.length]) fail("complete frame with wrong checksum", iteration);
+			stored->length = frame.length + 3;
+			stored->bytes[0] = frame.devId;
+			stored->bytes[1] = frame.srvId;
+			memcpy(&stored->bytes[2], frame.data, frame.length + 1);
+		}
+		position += chunk;
+	}
+	return numResults;
+}
+
+static bool sameResults(const result_type* a, uint16_t numA, const result_type* b, uint16_t numB){
+	if (numA != numB) return false;
+	for (uint16_t i=0; i<numA; i++) {
+		if (a[i].result != b[i].result || a[i].length != b[i].length) return false;
+		if (memcmp(a[i].bytes, b[i].bytes, a[i].length) != 0) return false;
+	}
+	return true;
+}
+
+static int fuzz(uint32_t iterations){
+	static stream_type stream;
+	static result_type results[FUZZ_STREAM_SIZE];
+	static result_type reference[FUZZ_STREAM_SIZE];
+	static result_type frames[FUZZ_MAX_FRAMES];
+	const uint8_t chunkSizes[] = {1, 2, 7, 64, 255};
+
+	for (uint32_t iteration=0; iteration<iterations; iteration++) {
+		// Structured streams: exactly the valid frames are received, in order
+		buildStream(&stream);
+		uint16_t numResults = parseStream(stream.data, stream.length, 0, results, FUZZ_STREAM_SIZE, iteration);
+		uint16_t numFrames = 0;
+		for (uint16_t i=0; i<numResults; i++) {
+			if (results[i].result == SERVO_FRAME_COMPLETE && numFrames < FUZZ_MAX_FRAMES) frames[numFrames++] = results[i];
+		}
+		if (!sameResults(frames, numFrames, stream.expected, stream.numExpected)) fail("valid frames lost, changed or added", iteration);
+
+		// Random bytes (biased to start and end bytes): the results do not depend on the size of the chunks
+		uint16_t length = 1 + randomBelow(FUZZ_STREAM_SIZE);
+		for (uint16_t i=0; i<length; i++) {
+			uint8_t type = randomBelow(16);
+			stream.data[i] = (type == 0) ? SERVO_FRAME_START : ((type == 1) ? SERVO_FRAME_END : randomBelow(256));
+		}
+		uint16_t numReference = parseStream(stream.data, length, 255, reference, FUZZ_STREAM_SIZE, iteration);
+		for (uint8_t i=0; i<sizeof(chunkSizes); i++) {
+			numResults = parseStream(stream.data, length, chunkSizes[i], results, FUZZ_STREAM_SIZE, iteration);
+			if (!sameResults(results, numResults, reference, numReference)) fail("results depend on the chunk size", iteration);
+		}
+		numResults = parseStream(stream.data, length, 0, results, FUZZ_STREAM_SIZE, iteration);
+		if (!sameResults(results, numResults, reference, numReference)) fail("results depend on random chunks", iteration);
+	}
+	printf("fuzz: %u iterations, %u failures\n", (unsigned)iterations, (unsigned)failures);
+	return failures ? 1 : 0;
+}
+
+static int bench(uint32_t megabytes){
+	// Stream of responses as the motors send them
+	const uint32_t frameSize = BENCH_DATA_LENGTH + 5;
+	uint32_t numFrames = megabytes*1000000UL/frameSize;
+	uint8_t* data = (uint8_t*)malloc(numFrames*frameSize);
+	for (uint32_t i=0; i<numFrames; i++) {
+		uint8_t* frame = &data[i*frameSize];
+		frame[0] = SERVO_FRAME_START;
+		uint8_t checksum = 0;
+		for (uint8_t j=1; j<frameSize-2; j++) {
+			frame[j] = (i + j) & 0x7f;
+			checksum += frame[j];
+		}
+		frame[frameSize-2] = checksum & 0x7f;
+		frame[frameSize-1] = SERVO_FRAME_END;
+	}
+
+	const uint8_t chunkSizes[] = {1, 8, 32, 255};
+	for (uint8_t c=0; c<sizeof(chunkSizes); c++) {
+		servoFrameParser parser;
+		uint32_t received = 0;
+		uint32_t checksum = 0;
+		uint32_t length = numFrames*frameSize;
+		clock_t start = clock();
+		for (uint32_t position=0; position<length; position+=chunkSizes[c]) {
+			uint8_t chunk = (length - position < chunkSizes[c]) ? length - position : chunkSizes[c];
+			uint8_t offset = 0;
+			while (offset < chunk) {
+				servo_frame_type frame;
+				uint8_t used;
+				if (parser.parse(&data[position + offset], chunk - offset, &frame, &used) == SERVO_FRAME_COMPLETE) {
+					received++;
+					checksum += frame.data[0];
+				}
+				offset += used;
+			}
+		}
+		double seconds = (double)(clock() - start)/CLOCKS_PER_SEC;
+		if (seconds <= 0) seconds = 1e-9;
+		printf("bench: chunk %3u bytes: %8.1f MB/s, %6.2f Mframes/s (%u frames, check %u)\n", chunkSizes[c], length/seconds/1e6,
+			received/seconds/1e6, (unsigned)received, (unsigned)checksum);
+		if (received != numFrames) failures++;
+	}
+	free(data);
+	return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]){
+	if (argc >= 2 && strcmp(argv[1], "fuzz") == 0) {
+		randomState = (argc >= 4) ? strtoul(argv[3], NULL, 0) : 0x12345678;
+		if (randomState == 0) randomState = 1;
+		return fuzz((argc >= 3) ? strtoul(argv[2], NULL, 0) : 2000);
+	}
+	if (argc >= 2 && strcmp(argv[1], "bench") == 0) return bench((argc >= 3) ? strtoul(argv[2], NULL, 0) : 20);
+	printf("Usage: %s fuzz [iterations] [seed] | bench [megabytes]\n", argv[0]);
+	return 2;
+}
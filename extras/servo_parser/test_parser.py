@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+Fuzz test and throughput benchmark of the C++ servoFrameParser (src/servo_parser.cpp), without hardware.
+
+The parser is compiled for the PC with parser_host.cpp: once with the address and undefined behaviour sanitizers for the fuzz test
+and once optimized for the benchmark. Needs g++ (or clang++).
+
+Usage:
+    test_parser.py [--cxx g++] [--iterations 2000] [--seed 0x12345678] [--megabytes 20] [--no-bench]
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SRC = os.path.join(HERE, "..", "..", "src")
+STUBS = os.path.join(HERE, "..", "host_stubs")
+
+
+def build(cxx, output, flags):
+    sources = [os.path.join(HERE, "parser_host.cpp"), os.path.join(SRC, "servo_parser.cpp"), os.path.join(STUBS, "arduino.cpp")]
+    subprocess.check_call([cxx, "-std=gnu++11", "-Wall", "-Wextra", "-I" + STUBS, "-I" + SRC] + flags + sources + ["-o", output])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fuzz test and benchmark of servoFrameParser on the PC")
+    parser.add_argument("--cxx", default="g++", help="C++ compiler")
+    parser.add_argument("--iterations", type=int, default=2000, help="number of random streams of the fuzz test")
+    parser.add_argument("--seed", default="0x12345678", help="seed of the random streams")
+    parser.add_argument("--megabytes", type=int, default=20, help="size of the benchmark stream in MB")
+    parser.add_argument("--no-bench", action="store_true", help="only run the fuzz test")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        fuzzer = os.path.join(tmp, "parser_fuzz")
+        build(args.cxx, fuzzer, ["-O1", "-g", "-fsanitize=address,undefined", "-fno-sanitize-recover=undefined"])
+        result = subprocess.call([fuzzer, "fuzz", str(args.iterations), args.seed])
+        if result == 0 and not args.no_bench:
+            bench = os.path.join(tmp, "parser_bench")
+            build(args.cxx, bench, ["-O2"])
+            result = subprocess.call([bench, "bench", str(args.megabytes)])
+    return result
+
+
+if __name__ == "__main__":
+    sys.exit(main())
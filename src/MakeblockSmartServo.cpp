@@ -9,10 +9,10 @@
  * 
  * \par Method List:
  *	  0. void beginSerial(Stream* servoPort);
- *    1. uint8_t MakeblockSmartServo::readByte(uint8_t *argv,int16_t idx);
- *    2. short MakeblockSmartServo::readShort(uint8_t *argv,int16_t idx,bool ignore_high);
- *    3. float MakeblockSmartServo::readFloat(uint8_t *argv,int16_t idx);
- *    4. long MakeblockSmartServo::readLong(uint8_t *argv,int idx);
+ *    1. uint8_t MakeblockSmartServo::readByte(const uint8_t *argv,int16_t idx);
+ *    2. short MakeblockSmartServo::readShort(const uint8_t *argv,int16_t idx,bool ignore_high);
+ *    3. float MakeblockSmartServo::readFloat(const uint8_t *argv,int16_t idx);
+ *    4. long MakeblockSmartServo::readLong(const uint8_t *argv,int idx);
  *    5. uint8_t MakeblockSmartServo::sendByte(uint8_t val);
  *    6. uint8_t MakeblockSmartServo::sendShort(int16_t val,bool ignore_high);
  *    7. uint8_t MakeblockSmartServo::sendFloat(float val);
@@ -31,11 +31,41 @@
  *    20. float MakeblockSmartServo::getVoltageRequest(uint8_t devId);
  *    21. float MakeblockSmartServo::getTempRequest(uint8_t devId);
  *    22. float MakeblockSmartServo::getCurrentRequest(uint8_t devId);
- *    23. void MakeblockSmartServo::assignDevIdResponse(void *arg);
- *    24. void MakeblockSmartServo::processSysexMessage(void);
- *    25. void MakeblockSmartServo::smartServoEventHandle(void);
- *    26. void MakeblockSmartServo::errorCodeCheckResponse(void *arg);
- *    27. void MakeblockSmartServo::smartServoCmdResponse(void *arg);
+ *    23. bool MakeblockSmartServo::setPid(uint8_t dev_id, uint8_t mode, float p_value, float i_value, float d_value);
+ *    24. bool MakeblockSmartServo::getPidRequest(uint8_t devId, uint8_t mode, float pid[3]);
+ *    25. bool MakeblockSmartServo::setMotionCompensation(uint8_t dev_id, int16_t comp_value);
+ *    26. bool MakeblockSmartServo::clrMotionCompensation(uint8_t dev_id);
+ *    27. int16_t MakeblockSmartServo::getMotionCompensationRequest(uint8_t devId);
+ *    28. void MakeblockSmartServo::assignDevIdResponse(void *arg);
+ *    29. void MakeblockSmartServo::processSysexMessage(servo_frame_type *frame);
+ *    30. void MakeblockSmartServo::smartServoEventHandle(void);
+ *    31. void MakeblockSmartServo::errorCodeCheckResponse(void *arg);
+ *    32. void MakeblockSmartServo::smartServoCmdResponse(void *arg);
+ *    33. servo_error_type MakeblockSmartServo::getErrorStats(uint8_t devId);
+ *    34. void MakeblockSmartServo::resetErrorStats(uint8_t devId);
+ *    35. uint8_t MakeblockSmartServo::getLastError(uint8_t devId);
+ *    36. void MakeblockSmartServo::writeTx(uint8_t val);
+ *    37. bool MakeblockSmartServo::request(uint8_t devId, uint16_t flag, bool repeatable);
+ *    38. uint8_t MakeblockSmartServo::transmit(uint16_t flag, uint32_t timeout, uint32_t *rtt);
+ *    39. servo_bus_stats_type MakeblockSmartServo::getBusStats(void);
+ *    40. bool MakeblockSmartServo::getRttHistogram(uint8_t devId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]);
+ *    41. void MakeblockSmartServo::resetBusStats(void);
+ *    42. void MakeblockSmartServo::recordRtt(uint32_t rtt);
+ *    43. uint32_t MakeblockSmartServo::getResponseTimeout(uint8_t devId, uint8_t type);
+ *    44. uint8_t MakeblockSmartServo::getCommandType(void);
+ *    45. void MakeblockSmartServo::updateRtt(uint8_t devId, uint8_t type, uint32_t rtt);
+ *    46. void MakeblockSmartServo::assignDevIdStart(void);
+ *    47. uint8_t MakeblockSmartServo::assignDevIdPoll(void);
+ *    48. uint8_t MakeblockSmartServo::getNumDevices(void);
+ *    49. bool MakeblockSmartServo::getVersionRequest(uint8_t devId);
+ *    50. bool MakeblockSmartServo::probeRequest(uint8_t devId);
+ *    51. void MakeblockSmartServo::getVersion(uint8_t devId, char version[SERVO_VERSION_LENGTH + 1]);
+ *    52. void MakeblockSmartServo::readVersionResponse(void *arg);
+ *    53. void MakeblockSmartServo::beginTransport(servoTransport *servoTransport);
+ *    54. void MakeblockSmartServo::pollEvents(void);
+ *    55. bool MakeblockSmartServo::getPositionReached(uint8_t devId);
+ *    56. void MakeblockSmartServo::clearPositionReached(uint8_t devId);
+ *    57. bool MakeblockSmartServo::isSlowCommand(void);
  *
  * \par History:
  * <pre>
@@ -43,6 +73,14 @@
  * Mark Yan         2016/08/23     1.0.0            Build the new.
  * Jakob Hoerbst    2020/01/28     1.0.0			edited
  * Johannes Rauer	2020/11/24	   1.0.0			Adapted for morobot implementation.
+ * Johannes Rauer	2026/10/18	   1.0.0			Added PID and motion compensation commands.
+ * Johannes Rauer	2026/10/18	   1.0.0			Checksum check of responses, retries and error statistics.
+ * Johannes Rauer	2026/10/18	   1.0.0			Round trip time histograms and bus load statistics.
+ * Johannes Rauer	2026/10/18	   1.0.0			Response timeouts adapted to the measured round trip times.
+ * Johannes Rauer	2026/10/18	   1.0.0			Non-blocking assignment of device ids, firmware versions and probing of servos.
+ * Johannes Rauer	2026/10/18	   1.0.0			Communication through exchangeable transports (serial port, ESP32 UART driver).
+ * Johannes Rauer	2026/10/18	   1.0.0			Incremental frame parser (servoFrameParser), no global conversion buffers.
+ * Johannes Rauer	2026/10/18	   1.0.0			Reports of reached positions are stored for each servo.
  * </pre>
  */
 
@@ -59,9 +97,6 @@
  */
 MakeblockSmartServo::MakeblockSmartServo() : MeSerialStandalone(0)
 {
-  parsingSysex = false;
-  sysex = {0};
-  sysexBytesRead = 0;
   servo_num_max = 0;
 }
 
@@ -78,9 +113,6 @@ MakeblockSmartServo::MakeblockSmartServo() : MeSerialStandalone(0)
 MakeblockSmartServo::MakeblockSmartServo(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic)\
                         : MeSerialStandalone(receivePin, transmitPin, inverse_logic)
 {
-  parsingSysex = false;
-  sysex = {0};
-  sysexBytesRead = 0;
   servo_num_max = 0;
 }
 #endif // ME_PORT_DEFINED
@@ -103,7 +135,27 @@ MakeblockSmartServo::MakeblockSmartServo(uint8_t receivePin, uint8_t transmitPin
  */
 void MakeblockSmartServo::beginSerial(Stream* servoPort)
 {
-	port = servoPort;
+  serialTransport.setStream(servoPort);
+  transport = &serialTransport;
+}
+
+/**
+ * \par Function
+ *   beginTransport
+ * \par Description
+ *   set the transport for the communication instead of a serial port (e.g. the UART driver of the ESP32, see transport.h).
+ * \param[in]
+ *   *servoTransport - the started transport the robot is connected to.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::beginTransport(servoTransport *servoTransport)
+{
+  transport = servoTransport;
 }
 
 /**
@@ -122,8 +174,9 @@ void MakeblockSmartServo::beginSerial(Stream* servoPort)
  * \par Others
  *   None
  */
-uint8_t MakeblockSmartServo::readByte(uint8_t *argv,int16_t idx)
+uint8_t MakeblockSmartServo::readByte(const uint8_t *argv,int16_t idx)
 {
+  val1byte_type val1byte;
   uint8_t temp;
   val1byte.byteVal[0] = argv[idx] & 0x7f;
   temp = argv[idx+1] << 7;
@@ -149,8 +202,9 @@ uint8_t MakeblockSmartServo::readByte(uint8_t *argv,int16_t idx)
  * \par Others
  *   None
  */
-short MakeblockSmartServo::readShort(uint8_t *argv,int16_t idx,bool ignore_high)
+short MakeblockSmartServo::readShort(const uint8_t *argv,int16_t idx,bool ignore_high)
 {
+  val2byte_type val2byte;
   uint8_t temp;
   val2byte.byteVal[0] = argv[idx] & 0x7f;
   temp = argv[idx+1] << 7;
@@ -182,8 +236,9 @@ short MakeblockSmartServo::readShort(uint8_t *argv,int16_t idx,bool ignore_high)
  * \par Others
  *   None
  */
-float MakeblockSmartServo::readFloat(uint8_t *argv,int16_t idx)
+float MakeblockSmartServo::readFloat(const uint8_t *argv,int16_t idx)
 {
+  val4byte_type val4byte;
   uint8_t temp;
   val4byte.byteVal[0] = argv[idx] & 0x7f;
   temp = argv[idx+1] << 7;
@@ -220,8 +275,9 @@ float MakeblockSmartServo::readFloat(uint8_t *argv,int16_t idx)
  * \par Others
  *   None
  */
-long MakeblockSmartServo::readLong(uint8_t *argv,int idx)
+long MakeblockSmartServo::readLong(const uint8_t *argv,int idx)
 {
+  val4byte_type val4byte;
   uint8_t temp;
   val4byte.byteVal[0] = argv[idx] & 0x7f;
   temp = argv[idx+1] << 7;
@@ -260,11 +316,12 @@ uint8_t MakeblockSmartServo::sendByte(uint8_t val)
 {
   uint8_t checksum;
   uint8_t val_7bit[2]={0};
+  val1byte_type val1byte;
   val1byte.charVal = val;
   val_7bit[0] = val1byte.byteVal[0] & 0x7f;
-  port->write(val_7bit[0]);
+  writeTx(val_7bit[0]);
   val_7bit[1] = (val1byte.byteVal[0] >> 7) & 0x7f;
-  port->write(val_7bit[1]);
+  writeTx(val_7bit[1]);
   checksum = val_7bit[0] + val_7bit[1];
   checksum = checksum & 0x7f;
   return checksum;
@@ -290,18 +347,19 @@ uint8_t MakeblockSmartServo::sendShort(int16_t val,bool ignore_high)
 {
   uint8_t checksum;
   uint8_t val_7bit[3]={0};
+  val2byte_type val2byte;
   val2byte.shortVal = val;
   val_7bit[0] = val2byte.byteVal[0] & 0x7f;
-  port->write(val_7bit[0]);
+  writeTx(val_7bit[0]);
   val_7bit[1] = ((val2byte.byteVal[1] << 1) | (val2byte.byteVal[0] >> 7)) & 0x7f;
-  port->write(val_7bit[1]);
+  writeTx(val_7bit[1]);
   checksum = val_7bit[0] + val_7bit[1];
   //Send analog can ignored high
   if(ignore_high == false)
   {
     val_7bit[2] = (val2byte.byteVal[1] >> 6) & 0x7f;
     checksum += val_7bit[2];
-    port->write(val_7bit[2]);
+    writeTx(val_7bit[2]);
   }
   checksum = checksum & 0x7f;
   return checksum;
@@ -325,17 +383,18 @@ uint8_t MakeblockSmartServo::sendFloat(float val)
 {
   uint8_t checksum;
   uint8_t val_7bit[5]={0};
+  val4byte_type val4byte;
   val4byte.floatVal = val;
   val_7bit[0] = val4byte.byteVal[0] & 0x7f;
-  port->write(val_7bit[0]);
+  writeTx(val_7bit[0]);
   val_7bit[1] = ((val4byte.byteVal[1] << 1) | (val4byte.byteVal[0] >> 7)) & 0x7f;
-  port->write(val_7bit[1]);
+  writeTx(val_7bit[1]);
   val_7bit[2] = ((val4byte.byteVal[2] << 2) | (val4byte.byteVal[1] >> 6)) & 0x7f;
-  port->write(val_7bit[2]);
+  writeTx(val_7bit[2]);
   val_7bit[3] = ((val4byte.byteVal[3] << 3) | (val4byte.byteVal[2] >> 5)) & 0x7f;
-  port->write(val_7bit[3]);
+  writeTx(val_7bit[3]);
   val_7bit[4] = (val4byte.byteVal[3] >> 4) & 0x7f;
-  port->write(val_7bit[4]);
+  writeTx(val_7bit[4]);
   checksum = val_7bit[0] + val_7bit[1] + val_7bit[2] + val_7bit[3] + val_7bit[4];
   checksum = checksum & 0x7f;
   return checksum;
@@ -359,17 +418,18 @@ uint8_t MakeblockSmartServo::sendLong(long val)
 {
   uint8_t checksum;
   uint8_t val_7bit[5]={0};
+  val4byte_type val4byte;
   val4byte.longVal = val;
   val_7bit[0] = val4byte.byteVal[0] & 0x7f;
-  port->write(val_7bit[0]);
+  writeTx(val_7bit[0]);
   val_7bit[1] = ((val4byte.byteVal[1] << 1) | (val4byte.byteVal[0] >> 7)) & 0x7f;
-  port->write(val_7bit[1]);
+  writeTx(val_7bit[1]);
   val_7bit[2] = ((val4byte.byteVal[2] << 2) | (val4byte.byteVal[1] >> 6)) & 0x7f;
-  port->write(val_7bit[2]);
+  writeTx(val_7bit[2]);
   val_7bit[3] = ((val4byte.byteVal[3] << 3) | (val4byte.byteVal[2] >> 5)) & 0x7f;
-  port->write(val_7bit[3]);
+  writeTx(val_7bit[3]);
   val_7bit[4] = (val4byte.byteVal[3] >> 4) & 0x7f;
-  port->write(val_7bit[4]);
+  writeTx(val_7bit[4]);
   checksum = val_7bit[0] + val_7bit[1] + val_7bit[2] + val_7bit[3] + val_7bit[4];
   checksum = checksum & 0x7f;
   return checksum;
@@ -379,7 +439,7 @@ uint8_t MakeblockSmartServo::sendLong(long val)
  * \par Function
  *   assignDevIdRequest
  * \par Description
- *   distribution device ID number to the smart servo link.
+ *   distribution device ID number to the smart servo link. The assignment is finished when no servo answered for SERVO_ASSIGN_QUIET_TIME.
  * \param[in]
  *   None
  * \par Output
@@ -391,26 +451,13 @@ uint8_t MakeblockSmartServo::sendLong(long val)
  */
 bool MakeblockSmartServo::assignDevIdRequest(void)
 {
-  port->write(START_SYSEX);
-  port->write(ALL_DEVICE);
-  port->write(CTL_ASSIGN_DEV_ID);
-  port->write((byte)0x00);
-  port->write(0x0f);
-  port->write(END_SYSEX);
-  resFlag &= 0xfe;
-  cmdTimeOutValue = millis();
-  while(((resFlag & 0x01) != 0x01) || (millis() - cmdTimeOutValue < 150))
+  uint8_t result;
+  assignDevIdStart();
+  do
   {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xfe;
-      ////wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xfe;
-  return true;
+    result = assignDevIdPoll();
+  }while(result == PROCESS_BUSY);
+  return result == PROCESS_SUC;
 }
 
 /**
@@ -440,31 +487,20 @@ bool MakeblockSmartServo::moveTo(uint8_t dev_id,long angle_value,float speed,sma
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_ABSOLUTE_ANGLE_LONG);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_ABSOLUTE_ANGLE_LONG);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_ABSOLUTE_ANGLE_LONG);
   checksum += sendLong(angle_value);
   checksum += sendShort((int)speed,true);
   checksum = checksum & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
   _callback = callback;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  clearPositionReached(dev_id);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -494,31 +530,20 @@ bool MakeblockSmartServo::move(uint8_t dev_id,long angle_value,float speed,smart
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_RELATIVE_ANGLE_LONG);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_RELATIVE_ANGLE_LONG);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_RELATIVE_ANGLE_LONG);
   checksum += sendLong(angle_value);
   checksum += sendShort((int)speed,true);
   checksum = checksum & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
   _callback = callback;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  clearPositionReached(dev_id);
+  return request(dev_id, 0x40, false);
 }
 
 /**
@@ -542,27 +567,15 @@ bool MakeblockSmartServo::setZero(uint8_t dev_id)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_CURRENT_ANGLE_ZERO_DEGREES);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_CURRENT_ANGLE_ZERO_DEGREES);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_CURRENT_ANGLE_ZERO_DEGREES) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -588,28 +601,16 @@ bool MakeblockSmartServo::setBreak(uint8_t dev_id, uint8_t breakStatus)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_BREAK);
-  port->write(breakStatus);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_BREAK);
+  writeTx(breakStatus);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_BREAK + breakStatus) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -639,31 +640,19 @@ bool MakeblockSmartServo::setRGBLed(uint8_t dev_id, uint8_t r_value, uint8_t g_v
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_RGB_LED);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_RGB_LED);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_RGB_LED);
   checksum += sendByte(r_value);
   checksum += sendByte(g_value);
   checksum += sendByte(b_value);
   checksum &= 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -687,27 +676,15 @@ bool MakeblockSmartServo::handSharke(uint8_t dev_id)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SERVO_SHARKE_HAND);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SERVO_SHARKE_HAND);
   checksum = (dev_id + SMART_SERVO + SERVO_SHARKE_HAND) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -733,29 +710,17 @@ bool MakeblockSmartServo::setPwmMove(uint8_t dev_id, int16_t pwm_value)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_PWM_MOVE);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_PWM_MOVE);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_PWM_MOVE);
   checksum += sendShort(pwm_value,false);
   checksum &= 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -783,30 +748,18 @@ bool MakeblockSmartServo::setInitAngle(uint8_t dev_id,uint8_t mode,int16_t speed
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(dev_id);
-  port->write(SMART_SERVO);
-  port->write(SET_SERVO_INIT_ANGLE);
-  port->write(mode);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_INIT_ANGLE);
+  writeTx(mode);
   checksum = (dev_id + SMART_SERVO + SET_SERVO_INIT_ANGLE + mode);
   checksum += sendShort(abs(speed),true);
   checksum &= 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xbf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x40) != 0x40)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      resFlag &= 0xbf;
-      //wdt_reset();
-      return false;
-    }
-  }
-  resFlag &= 0xbf;
-  return true;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
 }
 
 /**
@@ -830,26 +783,16 @@ long MakeblockSmartServo::getAngleRequest(uint8_t devId)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(devId);
-  port->write(SMART_SERVO);
-  port->write(GET_SERVO_CUR_ANGLE);
-  port->write((byte)0x00);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_CUR_ANGLE);
+  writeTx((byte)0x00);
   checksum = (devId + SMART_SERVO + GET_SERVO_CUR_ANGLE + 0x00) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xfd;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x02) != 0x02)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      //wdt_reset();
-      break;
-    }
-  }
-  resFlag &= 0xfd;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  request(devId, 0x02);
   return servo_dev_list[devId - 1].angleValue;
 }
 
@@ -874,26 +817,16 @@ float MakeblockSmartServo::getSpeedRequest(uint8_t devId)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(devId);
-  port->write(SMART_SERVO);
-  port->write(GET_SERVO_SPEED);
-  port->write((byte)0x00);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_SPEED);
+  writeTx((byte)0x00);
   checksum = (devId + SMART_SERVO + GET_SERVO_SPEED + 0x00) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xfb;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x04) != 0x04)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      //wdt_reset();
-      break;
-    }
-  }
-  resFlag &= 0xfb;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  request(devId, 0x04);
   return servo_dev_list[devId - 1].servoSpeed;
 }
 
@@ -918,25 +851,16 @@ float MakeblockSmartServo::getVoltageRequest(uint8_t devId)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(devId);
-  port->write(SMART_SERVO);
-  port->write(GET_SERVO_VOLTAGE);
-  port->write((byte)0x00);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_VOLTAGE);
+  writeTx((byte)0x00);
   checksum = (devId + SMART_SERVO + GET_SERVO_VOLTAGE + 0x00) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xf7;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x08) != 0x08)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      //wdt_reset();
-      break;
-    }
-  }
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  request(devId, 0x08);
   return servo_dev_list[devId - 1].voltage;
 }
 
@@ -961,26 +885,16 @@ float MakeblockSmartServo::getTempRequest(uint8_t devId)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(devId);
-  port->write(SMART_SERVO);
-  port->write(GET_SERVO_TEMPERATURE);
-  port->write((byte)0x00);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_TEMPERATURE);
+  writeTx((byte)0x00);
   checksum = (devId + SMART_SERVO + GET_SERVO_TEMPERATURE + 0x00) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xef;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x10) != 0x10)
-  {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      //wdt_reset();
-      break;
-    }
-  }
-  resFlag &= 0xf7;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  request(devId, 0x10);
   return servo_dev_list[devId - 1].temperature;
 }
 
@@ -1005,27 +919,209 @@ float MakeblockSmartServo::getCurrentRequest(uint8_t devId)
   {
     return false;
   }
-  port->write(START_SYSEX);
-  port->write(devId);
-  port->write(SMART_SERVO);
-  port->write(GET_SERVO_ELECTRIC_CURRENT);
-  port->write((byte)0x00);
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_ELECTRIC_CURRENT);
+  writeTx((byte)0x00);
   checksum = (devId + SMART_SERVO + GET_SERVO_ELECTRIC_CURRENT + 0x00) & 0x7f;
-  port->write(checksum);
-  port->write(END_SYSEX);
-  resFlag &= 0xdf;
-  cmdTimeOutValue = millis();
-  while((resFlag & 0x20) != 0x20)
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  request(devId, 0x20);
+  return servo_dev_list[devId - 1].current;
+}
+
+/**
+ * \par Function
+ *   setPid
+ * \par Description
+ *   This function is used to set the gains of a PID loop of the smart servo.
+ * \param[in]
+ *    dev_id - the device id of servo that we want to set.
+ * \param[in]
+ *    mode - the PID loop (SERVO_PID_POSITION or SERVO_PID_SPEED).
+ * \param[in]
+ *    p_value - proportional gain.
+ * \param[in]
+ *    i_value - integral gain.
+ * \param[in]
+ *    d_value - derivative gain.
+ * \par Output
+ *   None
+ * \return
+ *   If the assignment is successful, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::setPid(uint8_t dev_id, uint8_t mode, float p_value, float i_value, float d_value)
+{
+  uint8_t checksum;
+  if((dev_id > servo_num_max) && (dev_id != ALL_DEVICE))
   {
-    smartServoEventHandle();
-    if(millis() - cmdTimeOutValue > 1200)
-    {
-      //wdt_reset();
-      break;
-    }
+    return false;
   }
-  resFlag &= 0xdf;
-  return servo_dev_list[devId - 1].current;
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_PID);
+  checksum = (dev_id + SMART_SERVO + SET_SERVO_PID);
+  checksum += sendByte(mode);
+  checksum += sendFloat(p_value);
+  checksum += sendFloat(i_value);
+  checksum += sendFloat(d_value);
+  checksum &= 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
+}
+
+/**
+ * \par Function
+ *   getPidRequest
+ * \par Description
+ *   This function used to get the gains of a PID loop of the smart servo.
+ * \param[in]
+ *   devId - the device id of servo that we want to read its gains.
+ * \param[in]
+ *   mode - the PID loop (SERVO_PID_POSITION or SERVO_PID_SPEED).
+ * \param[out]
+ *   pid - the proportional, integral and derivative gain.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::getPidRequest(uint8_t devId, uint8_t mode, float pid[3])
+{
+  uint8_t checksum;
+  if((devId > servo_num_max) || (devId == ALL_DEVICE) || (devId == 0))
+  {
+    return false;
+  }
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_PID);
+  checksum = (devId + SMART_SERVO + GET_SERVO_PID);
+  checksum += sendByte(mode);
+  checksum &= 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  if(!request(devId, 0x80))
+  {
+    return false;
+  }
+  pid[0] = servo_dev_list[devId - 1].pid[0];
+  pid[1] = servo_dev_list[devId - 1].pid[1];
+  pid[2] = servo_dev_list[devId - 1].pid[2];
+  return true;
+}
+
+/**
+ * \par Function
+ *   setMotionCompensation
+ * \par Description
+ *   This function is used to set the motion compensation (backlash) of smart servo. The servo adds it to its position when the direction reverses.
+ * \param[in]
+ *    dev_id - the device id of servo that we want to set.
+ * \param[in]
+ *    comp_value - the compensation angle in degrees.
+ * \par Output
+ *   None
+ * \return
+ *   If the assignment is successful, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::setMotionCompensation(uint8_t dev_id, int16_t comp_value)
+{
+  uint8_t checksum;
+  if((dev_id > servo_num_max) && (dev_id != ALL_DEVICE))
+  {
+    return false;
+  }
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(SET_SERVO_MOTION_COMPENSATION);
+  checksum = (dev_id + SMART_SERVO + SET_SERVO_MOTION_COMPENSATION);
+  checksum += sendShort(comp_value,false);
+  checksum &= 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
+}
+
+/**
+ * \par Function
+ *   clrMotionCompensation
+ * \par Description
+ *   This function is used to clear the motion compensation of smart servo.
+ * \param[in]
+ *    dev_id - the device id of servo that we want to set.
+ * \par Output
+ *   None
+ * \return
+ *   If the assignment is successful, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::clrMotionCompensation(uint8_t dev_id)
+{
+  uint8_t checksum;
+  if((dev_id > servo_num_max) && (dev_id != ALL_DEVICE))
+  {
+    return false;
+  }
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(dev_id);
+  writeTx(SMART_SERVO);
+  writeTx(CLR_SERVO_MOTION_COMPENSATION);
+  checksum = (dev_id + SMART_SERVO + CLR_SERVO_MOTION_COMPENSATION) & 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(dev_id, 0x40);
+}
+
+/**
+ * \par Function
+ *   getMotionCompensationRequest
+ * \par Description
+ *   This function used to get the motion compensation of smart servo.
+ * \param[in]
+ *   devId - the device id of servo that we want to read its motion compensation.
+ * \par Output
+ *   None
+ * \return
+ *   the compensation angle in degrees.
+ * \par Others
+ *   None
+ */
+int16_t MakeblockSmartServo::getMotionCompensationRequest(uint8_t devId)
+{
+  uint8_t checksum;
+  if((devId > servo_num_max) || (devId == ALL_DEVICE) || (devId == 0))
+  {
+    return 0;
+  }
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(SMART_SERVO);
+  writeTx(GET_SERVO_MOTION_COMPENSATION);
+  writeTx((byte)0x00);
+  checksum = (devId + SMART_SERVO + GET_SERVO_MOTION_COMPENSATION + 0x00) & 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  request(devId, 0x100);
+  return servo_dev_list[devId - 1].motionCompensation;
 }
 
 /**
@@ -1044,11 +1140,8 @@ float MakeblockSmartServo::getCurrentRequest(uint8_t devId)
  */
 void MakeblockSmartServo::assignDevIdResponse(void *arg)
 {
-  //The arg from value[0]
-  uint8_t DeviceId = 0;
-  uint8_t ServiceId = 0;
-  DeviceId = sysex.val.dev_id;
-  ServiceId = sysex.val.srv_id;
+  servo_frame_type *frame = (servo_frame_type *)arg;
+  uint8_t DeviceId = frame->devId;
   if(servo_num_max < DeviceId)
   {
     servo_num_max = DeviceId;
@@ -1062,7 +1155,7 @@ void MakeblockSmartServo::assignDevIdResponse(void *arg)
  * \par Description
  *   This function is used to process protocol messages of smart servo.
  * \param[in]
- *   None
+ *   *frame - the frame received from the parser.
  * \par Output
  *   None
  * \return
@@ -1070,21 +1163,34 @@ void MakeblockSmartServo::assignDevIdResponse(void *arg)
  * \par Others
  *   None
  */
-void MakeblockSmartServo::processSysexMessage(void)
+void MakeblockSmartServo::processSysexMessage(servo_frame_type *frame)
 {
-  uint8_t i;
-  if(sysex.val.dev_id != ALL_DEVICE)
+  if((frame->srvId != CTL_ASSIGN_DEV_ID) && ((frame->devId == 0) || (frame->devId > SMART_SERVO_MAX_DEVICES)))
+  {
+    return;
+  }
+  // a late response to a previous command (e.g. after a timeout) must not be taken as response of another servo
+  // reports of reached positions are sent without a request, so they can arrive during the request to another servo
+  bool isReport = (frame->srvId == SMART_SERVO) && (frame->length > 0) && (frame->data[0] == REPORT_WHEN_REACH_THE_SET_POSITION);
+  if((rxDevId != ALL_DEVICE) && (frame->srvId != CTL_ASSIGN_DEV_ID) && (frame->devId != rxDevId) && !isReport)
+  {
+    return;
+  }
+  if(frame->devId != ALL_DEVICE)
   {
-    switch(sysex.val.srv_id)
+    switch(frame->srvId)
     {
       case CTL_ASSIGN_DEV_ID:
-        assignDevIdResponse((void*)NULL);
+        assignDevIdResponse((void*)frame);
         break;
       case CTL_ERROR_CODE:
-        errorCodeCheckResponse((void*)NULL);
+        errorCodeCheckResponse((void*)frame);
         break;
       case SMART_SERVO:
-        smartServoCmdResponse((void*)NULL);
+        smartServoCmdResponse((void*)frame);
+        break;
+      case CTL_READ_DEV_VERSION:
+        readVersionResponse((void*)frame);
         break;
       default:
         break;
@@ -1108,37 +1214,37 @@ void MakeblockSmartServo::processSysexMessage(void)
  */
 void MakeblockSmartServo::smartServoEventHandle(void)
 {
-  while (port->available())
+#if SMART_SERVO_STATS
+  unsigned long startTime = micros();
+#endif
+  uint8_t rxChunk[SERVO_RX_CHUNK];
+  uint8_t rxLength;
+  servo_frame_type frame;
+  while ((rxLength = transport->receive(rxChunk, SERVO_RX_CHUNK)) > 0)
   {
-    // get the new byte:
-    uint8_t inputData = port->read();
-    if(parsingSysex)
+#if SMART_SERVO_STATS
+    busStats.bytesReceived += rxLength;
+#endif
+    // the parser stops after each frame, so the frame is processed before the next one of the chunk is parsed
+    uint8_t used;
+    for(uint8_t i = 0; i < rxLength; i += used)
     {
-      if (inputData == END_SYSEX)
+      switch(parser.parse(&rxChunk[i], rxLength - i, &frame, &used))
       {
-        //stop sysex byte
-        parsingSysex = false;
-        //fire off handler function
-        processSysexMessage();
-      }
-      else
-      {
-        //normal data byte - add to buffer
-        sysex.storedInputData[sysexBytesRead] = inputData;
-        sysexBytesRead++;
-        if(sysexBytesRead > DEFAULT_UART_BUF_SIZE-1)
-        {
-          parsingSysex = false;
-          sysexBytesRead = 0;
-        }
+        case SERVO_FRAME_COMPLETE:
+          processSysexMessage(&frame);
+          break;
+        case SERVO_FRAME_BAD_CHECKSUM:
+          rxStatus = SERVO_BAD_CHECKSUM;
+          break;
+        default:
+          break;
       }
     }
-    else if(inputData == START_SYSEX)
-    {
-      parsingSysex = true;
-      sysexBytesRead = 0;
-    }
   }
+#if SMART_SERVO_STATS
+  busStats.eventHandleTime += micros() - startTime;
+#endif
 }
 
 /**
@@ -1157,14 +1263,12 @@ void MakeblockSmartServo::smartServoEventHandle(void)
  */
 void MakeblockSmartServo::errorCodeCheckResponse(void *arg)
 {
-  uint8_t DeviceId = 0;
-  uint8_t ServiceId = 0;
+  servo_frame_type *frame = (servo_frame_type *)arg;
   uint8_t errorcode = WRONG_TYPE_OF_SERVICE;
-  DeviceId = sysex.val.dev_id;
-  ServiceId = sysex.val.srv_id;
-  if(ServiceId == CTL_ERROR_CODE)
+  if((frame->srvId == CTL_ERROR_CODE) && (frame->length > 0))
   {
-    errorcode = sysex.val.value[0];
+    errorcode = frame->data[0];
+    rxStatus = errorcode;
     resFlag |= 0x40;
   }
 }
@@ -1190,36 +1294,67 @@ void MakeblockSmartServo::smartServoCmdResponse(void *arg)
   float temp_v;
   float vol_v;
   float current_v;
-  uint8_t servoNum = sysex.val.dev_id;
-  int16_t cmd = (int16_t)sysex.val.value[0];
+  servo_frame_type *frame = (servo_frame_type *)arg;
+  uint8_t servoNum = frame->devId;
+  int16_t cmd = (frame->length > 0) ? (int16_t)frame->data[0] : -1;
+  // the values are read from the received bytes, a response which is too short is ignored (the request is repeated)
+  uint8_t needed = 6;
+  if(cmd == GET_SERVO_PID)
+  {
+    needed = 18;
+  }
+  else if(cmd == GET_SERVO_MOTION_COMPENSATION)
+  {
+    needed = 4;
+  }
+  else if(cmd == REPORT_WHEN_REACH_THE_SET_POSITION)
+  {
+    needed = 1;
+  }
+  if(frame->length < needed)
+  {
+    return;
+  }
   switch(cmd)
   {
     case GET_SERVO_CUR_ANGLE:
-      angle_v = readLong(sysex.val.value,1);
-      servo_dev_list[sysex.val.dev_id - 1].angleValue = angle_v;
+      angle_v = readLong(frame->data,1);
+      servo_dev_list[servoNum - 1].angleValue = angle_v;
       resFlag |= 0x02;
       break;
     case GET_SERVO_SPEED:
-      speed_v = readFloat(sysex.val.value,1);
-      servo_dev_list[sysex.val.dev_id - 1].servoSpeed = speed_v;
+      speed_v = readFloat(frame->data,1);
+      servo_dev_list[servoNum - 1].servoSpeed = speed_v;
       resFlag |= 0x04;
       break;
     case GET_SERVO_VOLTAGE:
-      vol_v = readFloat(sysex.val.value,1);
-      servo_dev_list[sysex.val.dev_id - 1].voltage = vol_v;
+      vol_v = readFloat(frame->data,1);
+      servo_dev_list[servoNum - 1].voltage = vol_v;
       resFlag |= 0x08;
       break;
     case GET_SERVO_TEMPERATURE:
-      temp_v = readFloat(sysex.val.value,1);
-      servo_dev_list[sysex.val.dev_id - 1].temperature = temp_v;
+      temp_v = readFloat(frame->data,1);
+      servo_dev_list[servoNum - 1].temperature = temp_v;
       resFlag |= 0x10;
       break;
     case GET_SERVO_ELECTRIC_CURRENT:
-      current_v = readFloat(sysex.val.value,1);
-      servo_dev_list[sysex.val.dev_id - 1].current = current_v;
+      current_v = readFloat(frame->data,1);
+      servo_dev_list[servoNum - 1].current = current_v;
       resFlag |= 0x20;
       break;
+    case GET_SERVO_PID:
+      // value[1..2]: PID loop, value[3..17]: P, I and D gain
+      servo_dev_list[servoNum - 1].pid[0] = readFloat(frame->data,3);
+      servo_dev_list[servoNum - 1].pid[1] = readFloat(frame->data,8);
+      servo_dev_list[servoNum - 1].pid[2] = readFloat(frame->data,13);
+      resFlag |= 0x80;
+      break;
+    case GET_SERVO_MOTION_COMPENSATION:
+      servo_dev_list[servoNum - 1].motionCompensation = readShort(frame->data,1,false);
+      resFlag |= 0x100;
+      break;
     case REPORT_WHEN_REACH_THE_SET_POSITION:
+      positionReached[servoNum - 1] = true;
       if(_callback != NULL)
       {
         _callback(servoNum);
@@ -1229,3 +1364,827 @@ void MakeblockSmartServo::smartServoCmdResponse(void *arg)
       break;
   }
 }
+
+/**
+ * \par Function
+ *   getErrorStats
+ * \par Description
+ *   This function used to get the communication errors of the smart servo since the last reset.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   the error counters of the servo.
+ * \par Others
+ *   None
+ */
+servo_error_type MakeblockSmartServo::getErrorStats(uint8_t devId)
+{
+  servo_error_type stats = {};
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return stats;
+  }
+  return errorStats[devId - 1];
+}
+
+/**
+ * \par Function
+ *   resetErrorStats
+ * \par Description
+ *   This function used to reset the communication error counters.
+ * \param[in]
+ *   devId - the device id of servo (ALL_DEVICE resets all servos).
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::resetErrorStats(uint8_t devId)
+{
+  servo_error_type stats = {};
+  for(uint8_t i = 0; i < SMART_SERVO_MAX_DEVICES; i++)
+  {
+    if((devId == ALL_DEVICE) || (devId == i + 1))
+    {
+      errorStats[i] = stats;
+    }
+  }
+}
+
+/**
+ * \par Function
+ *   getLastError
+ * \par Description
+ *   This function used to get the result of the last command sent to the smart servo.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   PROCESS_SUC, PROCESS_BUSY, PROCESS_ERROR, WRONG_TYPE_OF_SERVICE, SERVO_TIMEOUT or SERVO_BAD_CHECKSUM.
+ * \par Others
+ *   None
+ */
+uint8_t MakeblockSmartServo::getLastError(uint8_t devId)
+{
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return PROCESS_SUC;
+  }
+  return errorStats[devId - 1].lastError;
+}
+
+/**
+ * \par Function
+ *   writeTx
+ * \par Description
+ *   add a byte to the frame in the transmit buffer.
+ * \param[in]
+ *   val - the byte to add.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::writeTx(uint8_t val)
+{
+  if(txLength < DEFAULT_UART_BUF_SIZE)
+  {
+    txBuffer[txLength] = val;
+    txLength++;
+  }
+}
+
+/**
+ * \par Function
+ *   request
+ * \par Description
+ *   send the frame in the transmit buffer and wait for the response. Timeouts, corrupted responses, busy and error responses are repeated up to SERVO_MAX_RETRIES times. The timeout is calculated from the round trip times of the servo and doubles with every timeout, busy and error responses are repeated after a delay which doubles as well (starting with SERVO_RETRY_BACKOFF).
+ * \param[in]
+ *   devId - the device id of servo the frame is sent to.
+ * \param[in]
+ *   flag - the bit of resFlag set by the expected response (0x40 for commands answered with an error code).
+ * \param[in]
+ *   repeatable - false if a command must not be repeated after it may have been executed (e.g. relative moves). It is only repeated if the servo was busy.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered successfully, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::request(uint8_t devId, uint16_t flag, bool repeatable)
+{
+  uint16_t backoff = SERVO_RETRY_BACKOFF;
+  uint8_t type = getCommandType();
+  // slow commands keep the fixed timeout and do not shrink the estimate of the fast configuration commands
+  bool slow = isSlowCommand();
+  uint32_t timeout = slow ? SERVO_RESPONSE_TIMEOUT * 1000UL : getResponseTimeout(devId, type);
+  uint8_t result = PROCESS_SUC;
+  uint32_t rtt;
+  servo_error_type dummy;
+  servo_error_type *stats = &dummy;
+  if((devId > 0) && (devId <= SMART_SERVO_MAX_DEVICES))
+  {
+    stats = &errorStats[devId - 1];
+  }
+  for(uint8_t attempt = 0; ; attempt++)
+  {
+    if(attempt > 0)
+    {
+      stats->retries++;
+      // a lost frame is repeated at once, the servo got time to recover from other errors
+      if(result != SERVO_TIMEOUT)
+      {
+        delay(backoff);
+        backoff *= 2;
+      }
+    }
+    result = transmit(flag, timeout, &rtt);
+    stats->lastError = result;
+    if((attempt == 0) && (slow == false) && (result != SERVO_TIMEOUT) && (result != SERVO_BAD_CHECKSUM))
+    {
+      updateRtt(devId, type, rtt);
+    }
+    switch(result)
+    {
+      case PROCESS_SUC:
+        return true;
+      case SERVO_TIMEOUT:
+        stats->timeouts++;
+        timeout *= 2;
+        if(timeout > SERVO_RESPONSE_TIMEOUT * 1000UL)
+        {
+          timeout = SERVO_RESPONSE_TIMEOUT * 1000UL;
+        }
+        break;
+      case SERVO_BAD_CHECKSUM:
+        stats->badChecksums++;
+        break;
+      case PROCESS_BUSY:
+        stats->busy++;
+        break;
+      default:
+        stats->errors++;
+        break;
+    }
+    // a broadcast is answered by several servos, an unknown command is not known after a repetition either
+    if((devId == ALL_DEVICE) || (result == WRONG_TYPE_OF_SERVICE) || (attempt >= SERVO_MAX_RETRIES))
+    {
+      return false;
+    }
+    // the servo may have executed the command although the response got lost
+    if((repeatable == false) && (result != PROCESS_BUSY))
+    {
+      return false;
+    }
+  }
+}
+
+/**
+ * \par Function
+ *   transmit
+ * \par Description
+ *   send the frame in the transmit buffer once and wait for the response.
+ * \param[in]
+ *   flag - the bit of resFlag set by the expected response.
+ * \param[in]
+ *   timeout - the time in us to wait for the response.
+ * \par Output
+ *   rtt - the time in us until the response has been received.
+ * \return
+ *   PROCESS_SUC or the error (see getLastError()).
+ * \par Others
+ *   None
+ */
+uint8_t MakeblockSmartServo::transmit(uint16_t flag, uint32_t timeout, uint32_t *rtt)
+{
+  uint8_t result = SERVO_TIMEOUT;
+  // process late responses to previous commands before waiting for the new one
+  smartServoEventHandle();
+  rxDevId = txBuffer[1];
+  rxStatus = SERVO_TIMEOUT;
+  resFlag &= ~(flag | 0x40);
+  transport->send(txBuffer, txLength);
+  unsigned long startTime = micros();
+  uint32_t elapsed = 0;
+  while(elapsed <= timeout)
+  {
+    // transports which receive in the background block here instead of polling
+    transport->waitForData(timeout - elapsed);
+    smartServoEventHandle();
+    elapsed = micros() - startTime;
+    if((resFlag & flag) == flag)
+    {
+      resFlag &= ~flag;
+      result = (flag == 0x40) ? rxStatus : PROCESS_SUC;
+      break;
+    }
+    // the servo answered with an error code instead of data
+    if((resFlag & 0x40) == 0x40)
+    {
+      resFlag &= ~0x40;
+      if(rxStatus != PROCESS_SUC)
+      {
+        result = rxStatus;
+        break;
+      }
+      // a late acknowledge of an earlier command is no answer to this request, keep waiting for the data
+      rxStatus = SERVO_TIMEOUT;
+    }
+    if(rxStatus == SERVO_BAD_CHECKSUM)
+    {
+      result = SERVO_BAD_CHECKSUM;
+      break;
+    }
+  }
+  // the time the response has been received (the transport may have received it before the driver looked for it)
+  elapsed = micros() - startTime;
+  *rtt = transport->getRxTime() - startTime;
+  if((result == SERVO_TIMEOUT) || (*rtt > elapsed))
+  {
+    *rtt = elapsed;
+  }
+#if SMART_SERVO_STATS
+  busStats.transactions++;
+  busStats.bytesSent += txLength;
+  busStats.waitTime += *rtt;
+#endif
+  // timeouts and corrupted responses are counted as errors only
+  if((result != SERVO_TIMEOUT) && (result != SERVO_BAD_CHECKSUM))
+  {
+    recordRtt(*rtt);
+  }
+  return result;
+}
+
+/**
+ * \par Function
+ *   getBusStats
+ * \par Description
+ *   This function used to get the load of the bus since the last reset (all zero if SMART_SERVO_STATS is 0).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   the number of transactions, bytes sent and received and the time spent waiting for responses and processing them.
+ * \par Others
+ *   The counters wrap around after 2^32 (about 71 minutes of waiting time).
+ */
+servo_bus_stats_type MakeblockSmartServo::getBusStats(void)
+{
+  servo_bus_stats_type stats = {};
+#if SMART_SERVO_STATS
+  stats = busStats;
+#endif
+  return stats;
+}
+
+/**
+ * \par Function
+ *   getRttHistogram
+ * \par Description
+ *   This function used to get the histogram of the round trip times (command sent until response received) of a smart servo.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \param[in]
+ *   type - the command type (SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ, SERVO_STATS_CONFIG).
+ * \par Output
+ *   histogram - number of responses per bucket (see SERVO_STATS_BUCKETS), commands without response are counted in getErrorStats().
+ * \return
+ *   If the histogram is recorded, return true.
+ * \par Others
+ *   The counters stop at 65535.
+ */
+bool MakeblockSmartServo::getRttHistogram(uint8_t devId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS])
+{
+  for(uint8_t i = 0; i < SERVO_STATS_BUCKETS; i++)
+  {
+    histogram[i] = 0;
+  }
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES) || (type >= SERVO_STATS_TYPES))
+  {
+    return false;
+  }
+#if SMART_SERVO_STATS
+  for(uint8_t i = 0; i < SERVO_STATS_BUCKETS; i++)
+  {
+    histogram[i] = rttHistogram[devId - 1][type][i];
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * \par Function
+ *   resetBusStats
+ * \par Description
+ *   This function used to reset the bus load statistics and the round trip time histograms of all servos.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::resetBusStats(void)
+{
+#if SMART_SERVO_STATS
+  servo_bus_stats_type stats = {};
+  busStats = stats;
+  memset(rttHistogram, 0, sizeof(rttHistogram));
+#endif
+}
+
+/**
+ * \par Function
+ *   recordRtt
+ * \par Description
+ *   add the round trip time of the frame in the transmit buffer to the histogram of its servo and command type.
+ * \param[in]
+ *   rtt - the round trip time in us.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::recordRtt(uint32_t rtt)
+{
+#if SMART_SERVO_STATS
+  uint8_t devId = txBuffer[1];
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return;
+  }
+  uint8_t type = getCommandType();
+  uint8_t bucket = 0;
+  uint32_t limit = SERVO_STATS_FIRST_BUCKET;
+  while((bucket < SERVO_STATS_BUCKETS - 1) && (rtt >= limit))
+  {
+    bucket++;
+    limit *= 2;
+  }
+  uint16_t *count = &rttHistogram[devId - 1][type][bucket];
+  if(*count < 0xFFFF)
+  {
+    (*count)++;
+  }
+#else
+  (void)rtt;
+#endif
+}
+
+/**
+ * \par Function
+ *   getResponseTimeout
+ * \par Description
+ *   This function used to get the time a command waits for the response of a smart servo before it is repeated.
+ *   Like the retransmission timeout of TCP it is the smoothed round trip time plus SERVO_RTO_K times its mean deviation,
+ *   limited to SERVO_MIN_RESPONSE_TIMEOUT ... SERVO_RESPONSE_TIMEOUT.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \param[in]
+ *   type - the command type (SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ, SERVO_STATS_CONFIG).
+ * \par Output
+ *   None
+ * \return
+ *   the timeout in us (SERVO_RESPONSE_TIMEOUT until a round trip time has been measured).
+ * \par Others
+ *   None
+ */
+uint32_t MakeblockSmartServo::getResponseTimeout(uint8_t devId, uint8_t type)
+{
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES) || (type >= SERVO_STATS_TYPES))
+  {
+    return SERVO_RESPONSE_TIMEOUT * 1000UL;
+  }
+  servo_rtt_type *estimate = &rttEstimate[devId - 1][type];
+  if(estimate->srtt == 0)
+  {
+    return SERVO_RESPONSE_TIMEOUT * 1000UL;
+  }
+  uint32_t timeout = ((uint32_t)estimate->srtt + SERVO_RTO_K * (uint32_t)estimate->rttvar) * 10;
+  if(timeout < SERVO_MIN_RESPONSE_TIMEOUT * 1000UL)
+  {
+    return SERVO_MIN_RESPONSE_TIMEOUT * 1000UL;
+  }
+  if(timeout > SERVO_RESPONSE_TIMEOUT * 1000UL)
+  {
+    return SERVO_RESPONSE_TIMEOUT * 1000UL;
+  }
+  return timeout;
+}
+
+/**
+ * \par Function
+ *   assignDevIdStart
+ * \par Description
+ *   start the distribution of device ID numbers to the smart servo link without waiting for the answers (see assignDevIdPoll()).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Used to enumerate the servos of several robots at the same time.
+ */
+void MakeblockSmartServo::assignDevIdStart(void)
+{
+  const uint8_t frame[6] = {START_SYSEX, ALL_DEVICE, CTL_ASSIGN_DEV_ID, 0x00, 0x0f, END_SYSEX};
+  transport->send(frame, sizeof(frame));
+  rxDevId = ALL_DEVICE;
+  resFlag &= 0xfe;
+  cmdTimeOutValue = millis();
+  assignLastResponse = 0;
+  assignAnswered = false;
+}
+
+/**
+ * \par Function
+ *   assignDevIdPoll
+ * \par Description
+ *   process the answers to assignDevIdStart(). The assignment is finished when no servo answered for SERVO_ASSIGN_QUIET_TIME.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   PROCESS_BUSY while the assignment is running, PROCESS_SUC if it is finished, SERVO_TIMEOUT if no servo answered.
+ * \par Others
+ *   None
+ */
+uint8_t MakeblockSmartServo::assignDevIdPoll(void)
+{
+  smartServoEventHandle();
+  // every servo of the chain answers when it got its id, wait until the last one is quiet
+  if((resFlag & 0x01) == 0x01)
+  {
+    resFlag &= 0xfe;
+    assignLastResponse = millis();
+    assignAnswered = true;
+  }
+  else if(assignAnswered && (millis() - assignLastResponse >= SERVO_ASSIGN_QUIET_TIME))
+  {
+    return PROCESS_SUC;
+  }
+  if(millis() - cmdTimeOutValue > SERVO_ASSIGN_TIMEOUT)
+  {
+    resFlag &= 0xfe;
+    return assignAnswered ? PROCESS_SUC : SERVO_TIMEOUT;
+  }
+  return PROCESS_BUSY;
+}
+
+/**
+ * \par Function
+ *   getNumDevices
+ * \par Description
+ *   This function used to get the highest device id which has been assigned or probed.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   the number of servos of the smart servo link known by the driver.
+ * \par Others
+ *   None
+ */
+uint8_t MakeblockSmartServo::getNumDevices(void)
+{
+  return servo_num_max;
+}
+
+/**
+ * \par Function
+ *   getVersionRequest
+ * \par Description
+ *   This function used to read the firmware version of the smart servo (see getVersion()).
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered with its version, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::getVersionRequest(uint8_t devId)
+{
+  uint8_t checksum;
+  if((devId == 0) || (devId > servo_num_max) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return false;
+  }
+  servo_dev_list[devId - 1].version[0] = 0;
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(CTL_READ_DEV_VERSION);
+  writeTx((byte)0x00);
+  checksum = (devId + CTL_READ_DEV_VERSION + 0x00) & 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  return request(devId, 0x200);
+}
+
+/**
+ * \par Function
+ *   probeRequest
+ * \par Description
+ *   This function used to check once and with the short timeout SERVO_PROBE_TIMEOUT if a servo with this device id answers,
+ *   e.g. to find out if the servos kept their ids while the microcontroller restarted. The firmware version is read as well.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered, return true (the device id is known to the driver from now on).
+ * \par Others
+ *   The probe is not repeated and not counted in the error statistics.
+ */
+bool MakeblockSmartServo::probeRequest(uint8_t devId)
+{
+  uint8_t checksum;
+  uint32_t rtt;
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return false;
+  }
+  servo_dev_list[devId - 1].version[0] = 0;
+  txLength = 0;
+  writeTx(START_SYSEX);
+  writeTx(devId);
+  writeTx(CTL_READ_DEV_VERSION);
+  writeTx((byte)0x00);
+  checksum = (devId + CTL_READ_DEV_VERSION + 0x00) & 0x7f;
+  writeTx(checksum);
+  writeTx(END_SYSEX);
+  uint8_t result = transmit(0x200, SERVO_PROBE_TIMEOUT * 1000UL, &rtt);
+  // every answer (also an error code of a firmware without version) shows that the servo has this id
+  if((result == SERVO_TIMEOUT) || (result == SERVO_BAD_CHECKSUM))
+  {
+    return false;
+  }
+  if(servo_num_max < devId)
+  {
+    servo_num_max = devId;
+  }
+  return true;
+}
+
+/**
+ * \par Function
+ *   getVersion
+ * \par Description
+ *   This function used to get the firmware version read by getVersionRequest() or probeRequest().
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   version - the version as zero terminated string (empty if not known).
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::getVersion(uint8_t devId, char version[SERVO_VERSION_LENGTH + 1])
+{
+  version[0] = 0;
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return;
+  }
+  for(uint8_t i = 0; i <= SERVO_VERSION_LENGTH; i++)
+  {
+    version[i] = servo_dev_list[devId - 1].version[i];
+  }
+}
+
+/**
+ * \par Function
+ *   readVersionResponse
+ * \par Description
+ *   This function is used to process the firmware version response of smart servo.
+ * \param[in]
+ *   *arg - address of input parameter.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void MakeblockSmartServo::readVersionResponse(void *arg)
+{
+  servo_frame_type *frame = (servo_frame_type *)arg;
+  uint8_t DeviceId = frame->devId;
+  // the data of the response are the characters of the version
+  int16_t length = frame->length;
+  if(length > SERVO_VERSION_LENGTH)
+  {
+    length = SERVO_VERSION_LENGTH;
+  }
+  for(int16_t i = 0; i < length; i++)
+  {
+    servo_dev_list[DeviceId - 1].version[i] = frame->data[i];
+  }
+  servo_dev_list[DeviceId - 1].version[(length > 0) ? length : 0] = 0;
+  resFlag |= 0x200;
+}
+
+/**
+ * \par Function
+ *   getCommandType
+ * \par Description
+ *   get the command type of the frame in the transmit buffer from its service id and secondary command.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ or SERVO_STATS_CONFIG.
+ * \par Others
+ *   None
+ */
+uint8_t MakeblockSmartServo::getCommandType(void)
+{
+  if(txBuffer[2] != SMART_SERVO)
+  {
+    return SERVO_STATS_CONFIG;
+  }
+  switch(txBuffer[3])
+  {
+    case SET_SERVO_ABSOLUTE_ANGLE_LONG:
+    case SET_SERVO_RELATIVE_ANGLE_LONG:
+      return SERVO_STATS_MOVE;
+    case SET_SERVO_PWM_MOVE:
+      return SERVO_STATS_PWM;
+    case GET_SERVO_PID:
+    case GET_SERVO_SPEED:
+    case GET_SERVO_MOTION_COMPENSATION:
+    case GET_SERVO_TEMPERATURE:
+    case GET_SERVO_ELECTRIC_CURRENT:
+    case GET_SERVO_VOLTAGE:
+    case GET_SERVO_CUR_ANGLE:
+      return SERVO_STATS_READ;
+    default:
+      return SERVO_STATS_CONFIG;
+  }
+}
+
+/**
+ * \par Function
+ *   isSlowCommand
+ * \par Description
+ *   check if the frame in the transmit buffer is a configuration command the servo needs long to answer (e.g. it stores values).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   If the response takes much longer than the one of other configuration commands, return true.
+ * \par Others
+ *   None
+ */
+bool MakeblockSmartServo::isSlowCommand(void)
+{
+  if(txBuffer[2] != SMART_SERVO)
+  {
+    return false;
+  }
+  switch(txBuffer[3])
+  {
+    case SET_SERVO_PID:
+    case SET_SERVO_MOTION_COMPENSATION:
+    case SET_SERVO_INIT_ANGLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * \par Function
+ *   updateRtt
+ * \par Description
+ *   update the smoothed round trip time and its mean deviation with a new measurement (gains 1/8 and 1/4 as in TCP).
+ * \param[in]
+ *   devId - the device id of servo.
+ * \param[in]
+ *   type - the command type.
+ * \param[in]
+ *   rtt - the measured round trip time in us.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Only responses to the first transmission of a frame are measured, the response to a repetition may belong to the first one.
+ */
+void MakeblockSmartServo::updateRtt(uint8_t devId, uint8_t type, uint32_t rtt)
+{
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES) || (type >= SERVO_STATS_TYPES))
+  {
+    return;
+  }
+  servo_rtt_type *estimate = &rttEstimate[devId - 1][type];
+  uint32_t sample = rtt / 10;
+  if(sample == 0)
+  {
+    sample = 1;
+  }
+  if(sample > 0xFFFF)
+  {
+    sample = 0xFFFF;
+  }
+  if(estimate->srtt == 0)
+  {
+    estimate->srtt = sample;
+    estimate->rttvar = sample / 2;
+    return;
+  }
+  uint32_t deviation = (sample > estimate->srtt) ? (sample - estimate->srtt) : (estimate->srtt - sample);
+  estimate->rttvar = (3 * (uint32_t)estimate->rttvar + deviation) / 4;
+  estimate->srtt = (7 * (uint32_t)estimate->srtt + sample) / 8;
+}
+
+/**
+ * \par Function
+ *   pollEvents
+ * \par Description
+ *   This function is used to process messages the servos sent without a request (e.g. the report that a position has been reached).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Does not wait, the messages are also processed while the driver waits for the response to a request.
+ */
+void MakeblockSmartServo::pollEvents(void)
+{
+  smartServoEventHandle();
+}
+
+/**
+ * \par Function
+ *   getPositionReached
+ * \par Description
+ *   This function is used to check if the servo reported that it reached the position of the last moveTo() or move().
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   If the report has been received, return true.
+ * \par Others
+ *   Processes the received messages first (see pollEvents()).
+ */
+bool MakeblockSmartServo::getPositionReached(uint8_t devId)
+{
+  if((devId == 0) || (devId > SMART_SERVO_MAX_DEVICES))
+  {
+    return false;
+  }
+  smartServoEventHandle();
+  return positionReached[devId - 1];
+}
+
+/**
+ * \par Function
+ *   clearPositionReached
+ * \par Description
+ *   This function is used to forget a received report that the position has been reached.
+ * \param[in]
+ *   devId - the device id of servo (ALL_DEVICE for all servos).
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Called by moveTo() and move() for the moved servo.
+ */
+void MakeblockSmartServo::clearPositionReached(uint8_t devId)
+{
+  for(uint8_t i = 0; i < SMART_SERVO_MAX_DEVICES; i++)
+  {
+    if((devId == ALL_DEVICE) || (devId == i + 1))
+    {
+      positionReached[i] = false;
+    }
+  }
+}
@@ -9,10 +9,10 @@
  * 
  * \par Method List:
  *	  0. void beginSerial(Stream* servoPort);
- *    1. uint8_t MakeblockSmartServo::readByte(uint8_t *argv,int16_t idx);
- *    2. short MakeblockSmartServo::readShort(uint8_t *argv,int16_t idx,bool ignore_high);
- *    3. float MakeblockSmartServo::readFloat(uint8_t *argv,int16_t idx);
- *    4. long MakeblockSmartServo::readLong(uint8_t *argv,int idx);
+ *    1. uint8_t MakeblockSmartServo::readByte(const uint8_t *argv,int16_t idx);
+ *    2. short MakeblockSmartServo::readShort(const uint8_t *argv,int16_t idx,bool ignore_high);
+ *    3. float MakeblockSmartServo::readFloat(const uint8_t *argv,int16_t idx);
+ *    4. long MakeblockSmartServo::readLong(const uint8_t *argv,int idx);
  *    5. uint8_t MakeblockSmartServo::sendByte(uint8_t val);
  *    6. uint8_t MakeblockSmartServo::sendShort(int16_t val,bool ignore_high);
  *    7. uint8_t MakeblockSmartServo::sendFloat(float val);
@@ -31,11 +31,41 @@
  *    20. float MakeblockSmartServo::getVoltageRequest(uint8_t devId);
  *    21. float MakeblockSmartServo::getTempRequest(uint8_t devId);
  *    22. float MakeblockSmartServo::getCurrentRequest(uint8_t devId);
- *    23. void MakeblockSmartServo::assignDevIdResponse(void *arg);
- *    24. void MakeblockSmartServo::processSysexMessage(void);
- *    25. void MakeblockSmartServo::smartServoEventHandle(void);
- *    26. void MakeblockSmartServo::errorCodeCheckResponse(void *arg);
- *    27. void MakeblockSmartServo::smartServoCmdResponse(void *arg);
+ *    23. bool MakeblockSmartServo::setPid(uint8_t dev_id, uint8_t mode, float p_value, float i_value, float d_value);
+ *    24. bool MakeblockSmartServo::getPidRequest(uint8_t devId, uint8_t mode, float pid[3]);
+ *    25. bool MakeblockSmartServo::setMotionCompensation(uint8_t dev_id, int16_t comp_value);
+ *    26. bool MakeblockSmartServo::clrMotionCompensation(uint8_t dev_id);
+ *    27. int16_t MakeblockSmartServo::getMotionCompensationRequest(uint8_t devId);
+ *    28. void MakeblockSmartServo::assignDevIdResponse(void *arg);
+ *    29. void MakeblockSmartServo::processSysexMessage(servo_frame_type *frame);
+ *    30. void MakeblockSmartServo::smartServoEventHandle(void);
+ *    31. void MakeblockSmartServo::errorCodeCheckResponse(void *arg);
+ *    32. void MakeblockSmartServo::smartServoCmdResponse(void *arg);
+ *    33. servo_error_type MakeblockSmartServo::getErrorStats(uint8_t devId);
+ *    34. void MakeblockSmartServo::resetErrorStats(uint8_t devId);
+ *    35. uint8_t MakeblockSmartServo::getLastError(uint8_t devId);
+ *    36. void MakeblockSmartServo::writeTx(uint8_t val);
+ *    37. bool MakeblockSmartServo::request(uint8_t devId, uint16_t flag, bool repeatable);
+ *    38. uint8_t MakeblockSmartServo::transmit(uint16_t flag, uint32_t timeout, uint32_t *rtt);
+ *    39. servo_bus_stats_type MakeblockSmartServo::getBusStats(void);
+ *    40. bool MakeblockSmartServo::getRttHistogram(uint8_t devId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]);
+ *    41. void MakeblockSmartServo::resetBusStats(void);
+ *    42. void MakeblockSmartServo::recordRtt(uint32_t rtt);
+ *    43. uint32_t MakeblockSmartServo::getResponseTimeout(uint8_t devId, uint8_t type);
+ *    44. uint8_t MakeblockSmartServo::getCommandType(void);
+ *    45. void MakeblockSmartServo::updateRtt(uint8_t devId, uint8_t type, uint32_t rtt);
+ *    46. void MakeblockSmartServo::assignDevIdStart(void);
+ *    47. uint8_t MakeblockSmartServo::assignDevIdPoll(void);
+ *    48. uint8_t MakeblockSmartServo::getNumDevices(void);
+ *    49. bool MakeblockSmartServo::getVersionRequest(uint8_t devId);
+ *    50. bool MakeblockSmartServo::probeRequest(uint8_t devId);
+ *    51. void MakeblockSmartServo::getVersion(uint8_t devId, char version[SERVO_VERSION_LENGTH + 1]);
+ *    52. void MakeblockSmartServo::readVersionResponse(void *arg);
+ *    53. void MakeblockSmartServo::beginTransport(servoTransport *servoTransport);
+ *    54. void MakeblockSmartServo::pollEvents(void);
+ *    55. bool MakeblockSmartServo::getPositionReached(uint8_t devId);
+ *    56. void MakeblockSmartServo::clearPositionReached(uint8_t devId);
+ *    57. bool MakeblockSmartServo::isSlowCommand(void);
  *
  * \par History:
  * <pre>
@@ -43,6 +73,14 @@
  * Mark Yan         2016/08/23     1.0.0            Build the new.
  * Jakob Hoerbst    2020/01/28     1.0.0			edited
  * Johannes Rauer	2020/11/24	   1.0.0			Adapted for morobot implementation.
+ * Johannes Rauer	2026/10/18	   1.0.0			Added PID and motion compensation commands.
+ * Johannes Rauer	2026/10/18	   1.0.0			Checksum check of responses, retries and error statistics.
+ * Johannes Rauer	2026/10/18	   1.0.0			Round trip time histograms and bus load statistics.
+ * Johannes Rauer	2026/10/18	   1.0.0			Response timeouts adapted to the measured round trip times.
+ * Johannes Rauer	2026/10/18	   1.0.0			Non-blocking assignment of device ids, firmware versions and probing of servos.
+ * Johannes Rauer	2026/10/18	   1.0.0			Communication through exchangeable transports (serial port, ESP32 UART driver).
+ * Johannes Rauer	2026/10/18	   1.0.0			Incremental frame parser (servoFrameParser), no global conversion buffers.
+ * Johannes Rauer	2026/10/18	   1.0.0			Reports of reached positions are stored for each servo.
  * </pre>
  */
 
@@ -54,6 +92,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <Arduino.h>
+#include "transport.h"
+#include "servo_parser.h"
 
 
 #define ALL_DEVICE              0xff    // Broadcast command identifies
@@ -100,6 +140,9 @@
   
   #define SERVO_MAX_SPEED_RPM 50
 
+  #define SERVO_PID_POSITION                     0x00 // PID loops of the servo (mode of SET_SERVO_PID and GET_SERVO_PID)
+  #define SERVO_PID_SPEED                        0x01
+
 #define START_SYSEX             0xF0 // start a MIDI Sysex message
 #define END_SYSEX               0xF7 // end a MIDI Sysex message
 
@@ -110,12 +153,41 @@
 #define WRONG_TYPE_OF_SERVICE   0x12
 
 #define DEFAULT_UART_BUF_SIZE      64
+#define SERVO_RX_CHUNK             16     // Number of bytes read from the transport at once
+#ifndef SMART_SERVO_MAX_DEVICES
+#ifdef NUM_MAX_SERVOS
+#define SMART_SERVO_MAX_DEVICES    NUM_MAX_SERVOS
+#else
+#define SMART_SERVO_MAX_DEVICES    8      // Number of servos the driver stores data for (can be raised with -DNUM_MAX_SERVOS=...)
+#endif
+#endif
 
-typedef struct{
-  uint8_t dev_id;
-  uint8_t srv_id;
-  uint8_t value[DEFAULT_UART_BUF_SIZE - 2];
-}sysex_message_type;
+#define SERVO_RESPONSE_TIMEOUT     200    // Maximum time in ms to wait for a response before the command is repeated (used until the round trip time of a servo is known and for slow commands)
+#define SERVO_MIN_RESPONSE_TIMEOUT 4      // Minimum time in ms to wait for a response
+#define SERVO_RTO_K                4      // The timeout is the smoothed round trip time plus SERVO_RTO_K times its mean deviation
+#define SERVO_ASSIGN_TIMEOUT       1200   // Maximum time in ms to assign the device ids
+#define SERVO_ASSIGN_QUIET_TIME    20     // The assignment of device ids is finished when no servo answered for this time in ms
+#define SERVO_PROBE_TIMEOUT        20     // Time in ms to wait for the answer to probeRequest()
+#define SERVO_VERSION_LENGTH       8      // Number of characters of a firmware version stored by the driver
+#define SERVO_MAX_RETRIES          2      // Number of repetitions of a command which failed
+#define SERVO_RETRY_BACKOFF        5      // Delay in ms before the first repetition (doubled for every further one)
+#define SERVO_TIMEOUT              0x20   // Result of a command without response (besides PROCESS_SUC, PROCESS_BUSY, ...)
+#define SERVO_BAD_CHECKSUM         0x21   // Result of a command whose response was corrupted
+
+#ifndef SMART_SERVO_STATS
+  #if defined(RAMEND) && (RAMEND < 0x1000)
+    #define SMART_SERVO_STATS      0      // Boards with little RAM (e.g. Arduino Uno) do not record bus statistics
+  #else
+    #define SMART_SERVO_STATS      1      // Record round trip times and bus load (see getBusStats())
+  #endif
+#endif
+#define SERVO_STATS_TYPES          4      // Command types with separate round trip time histograms
+#define SERVO_STATS_MOVE           0      // Position commands (absolute, relative)
+#define SERVO_STATS_PWM            1      // PWM commands
+#define SERVO_STATS_READ           2      // Requests of values (angle, speed, voltage, PID, ...)
+#define SERVO_STATS_CONFIG         3      // All other commands (init angle, zero, breaks, LED, set PID, ...)
+#define SERVO_STATS_BUCKETS        8      // Buckets of a histogram, bucket k counts round trip times below SERVO_STATS_FIRST_BUCKET*2^k us, the last one all longer ones
+#define SERVO_STATS_FIRST_BUCKET   500    // Upper limit in us of the first bucket
 
 typedef struct{
   uint8_t service_id;
@@ -123,31 +195,22 @@ typedef struct{
   void (*response_fun)(void *arg);
 }Cmd_list_tab_type;
 
-union sysex_message{
-  uint8_t storedInputData[DEFAULT_UART_BUF_SIZE];
-  sysex_message_type val;
-};
-
-union{
-  uint8_t byteVal[8];
-  double doubleVal;
-}val8byte;
-
-union{
+// Conversion between values and their bytes (each function has its own variable, so the header defines no objects)
+typedef union{
   uint8_t byteVal[4];
   float floatVal;
   long longVal;
-}val4byte;
+}val4byte_type;
 
-union{
+typedef union{
   uint8_t byteVal[2];
   short shortVal;
-}val2byte;
+}val2byte_type;
 
-union{
+typedef union{
   uint8_t byteVal[1];
   uint8_t charVal;
-}val1byte;
+}val1byte_type;
 
 typedef struct
 {
@@ -156,8 +219,36 @@ typedef struct
   float voltage;
   float temperature;
   float current;
+  float pid[3];
+  int16_t motionCompensation;
+  char version[SERVO_VERSION_LENGTH + 1];
 }servo_device_type;
 
+typedef struct
+{
+  uint16_t timeouts;
+  uint16_t badChecksums;
+  uint16_t busy;
+  uint16_t errors;
+  uint16_t retries;
+  uint8_t lastError;
+}servo_error_type;
+
+typedef struct
+{
+  uint32_t transactions;      // frames sent (including repetitions)
+  uint32_t bytesSent;
+  uint32_t bytesReceived;
+  uint32_t waitTime;          // time in us spent waiting for responses
+  uint32_t eventHandleTime;   // time in us spent in smartServoEventHandle()
+}servo_bus_stats_type;
+
+typedef struct
+{
+  uint16_t srtt;              // smoothed round trip time in 10 us (0 if not measured yet)
+  uint16_t rttvar;            // mean deviation of the round trip time in 10 us
+}servo_rtt_type;
+
 typedef void (*smartServoCb)(uint8_t); 
 
 /**
@@ -220,6 +311,22 @@ public:
  */
 void beginSerial(Stream* servoPort);
 
+/**
+ * \par Function
+ *   beginTransport
+ * \par Description
+ *   set the transport for the communication instead of a serial port (e.g. the UART driver of the ESP32, see transport.h).
+ * \param[in]
+ *   *servoTransport - the started transport the robot is connected to.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+void beginTransport(servoTransport *servoTransport);
+
 /**
  * \par Function
  *   readByte
@@ -236,7 +343,7 @@ void beginSerial(Stream* servoPort);
  * \par Others
  *   None
  */
-  uint8_t readByte(uint8_t *argv,int16_t idx);
+  uint8_t readByte(const uint8_t *argv,int16_t idx);
 
 /**
  * \par Function
@@ -256,7 +363,7 @@ void beginSerial(Stream* servoPort);
  * \par Others
  *   None
  */
-  short readShort(uint8_t *argv,int16_t idx,bool ignore_high);
+  short readShort(const uint8_t *argv,int16_t idx,bool ignore_high);
 
 /**
  * \par Function
@@ -274,7 +381,7 @@ void beginSerial(Stream* servoPort);
  * \par Others
  *   None
  */
-  float readFloat(uint8_t *argv,int16_t idx);
+  float readFloat(const uint8_t *argv,int16_t idx);
 
 /**
  * \par Function
@@ -292,7 +399,7 @@ void beginSerial(Stream* servoPort);
  * \par Others
  *   None
  */
-  long readLong(uint8_t *argv,int idx);
+  long readLong(const uint8_t *argv,int idx);
 
 /**
  * \par Function
@@ -364,7 +471,7 @@ void beginSerial(Stream* servoPort);
  * \par Function
  *   assignDevIdRequest
  * \par Description
- *   distribution device ID number to the smart servo link.
+ *   distribution device ID number to the smart servo link. The assignment is finished when no servo answered for SERVO_ASSIGN_QUIET_TIME.
  * \param[in]
  *   None
  * \par Output
@@ -610,6 +717,100 @@ void beginSerial(Stream* servoPort);
  */
   float getCurrentRequest(uint8_t devId);
 
+/**
+ * \par Function
+ *   setPid
+ * \par Description
+ *   This function is used to set the gains of a PID loop of the smart servo.
+ * \param[in]
+ *    dev_id - the device id of servo that we want to set.
+ * \param[in]
+ *    mode - the PID loop (SERVO_PID_POSITION or SERVO_PID_SPEED).
+ * \param[in]
+ *    p_value - proportional gain.
+ * \param[in]
+ *    i_value - integral gain.
+ * \param[in]
+ *    d_value - derivative gain.
+ * \par Output
+ *   None
+ * \return
+ *   If the assignment is successful, return true. 
+ * \par Others
+ *   None
+ */
+  bool setPid(uint8_t dev_id, uint8_t mode, float p_value, float i_value, float d_value);
+
+/**
+ * \par Function
+ *   getPidRequest
+ * \par Description
+ *   This function used to get the gains of a PID loop of the smart servo.
+ * \param[in]
+ *   devId - the device id of servo that we want to read its gains.
+ * \param[in]
+ *   mode - the PID loop (SERVO_PID_POSITION or SERVO_PID_SPEED).
+ * \param[out]
+ *   pid - the proportional, integral and derivative gain.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered, return true.
+ * \par Others
+ *   None
+ */
+  bool getPidRequest(uint8_t devId, uint8_t mode, float pid[3]);
+
+/**
+ * \par Function
+ *   setMotionCompensation
+ * \par Description
+ *   This function is used to set the motion compensation (backlash) of smart servo. The servo adds it to its position when the direction reverses.
+ * \param[in]
+ *    dev_id - the device id of servo that we want to set.
+ * \param[in]
+ *    comp_value - the compensation angle in degrees.
+ * \par Output
+ *   None
+ * \return
+ *   If the assignment is successful, return true. 
+ * \par Others
+ *   None
+ */
+  bool setMotionCompensation(uint8_t dev_id, int16_t comp_value);
+
+/**
+ * \par Function
+ *   clrMotionCompensation
+ * \par Description
+ *   This function is used to clear the motion compensation of smart servo.
+ * \param[in]
+ *    dev_id - the device id of servo that we want to set.
+ * \par Output
+ *   None
+ * \return
+ *   If the assignment is successful, return true. 
+ * \par Others
+ *   None
+ */
+  bool clrMotionCompensation(uint8_t dev_id);
+
+/**
+ * \par Function
+ *   getMotionCompensationRequest
+ * \par Description
+ *   This function used to get the motion compensation of smart servo.
+ * \param[in]
+ *   devId - the device id of servo that we want to read its motion compensation.
+ * \par Output
+ *   None
+ * \return
+ *   the compensation angle in degrees.
+ * \par Others
+ *   None
+ */
+  int16_t getMotionCompensationRequest(uint8_t devId);
+
 /**
  * \par Function
  *   assignDevIdResponse
@@ -664,7 +865,7 @@ void beginSerial(Stream* servoPort);
  * \par Description
  *   This function is used to process protocol messages of smart servo.
  * \param[in]
- *   None
+ *   *frame - the frame received from the parser.
  * \par Output
  *   None
  * \return
@@ -672,7 +873,7 @@ void beginSerial(Stream* servoPort);
  * \par Others
  *   None
  */
-  void processSysexMessage(void);
+  void processSysexMessage(servo_frame_type *frame);
 
 /**
  * \par Function
@@ -690,15 +891,428 @@ void beginSerial(Stream* servoPort);
  */
   void smartServoEventHandle(void);
 
+/**
+ * \par Function
+ *   getErrorStats
+ * \par Description
+ *   This function used to get the communication errors of the smart servo since the last reset.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   the error counters of the servo.
+ * \par Others
+ *   None
+ */
+  servo_error_type getErrorStats(uint8_t devId);
+
+/**
+ * \par Function
+ *   resetErrorStats
+ * \par Description
+ *   This function used to reset the communication error counters.
+ * \param[in]
+ *   devId - the device id of servo (ALL_DEVICE resets all servos).
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+  void resetErrorStats(uint8_t devId);
+
+/**
+ * \par Function
+ *   getLastError
+ * \par Description
+ *   This function used to get the result of the last command sent to the smart servo.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   PROCESS_SUC, PROCESS_BUSY, PROCESS_ERROR, WRONG_TYPE_OF_SERVICE, SERVO_TIMEOUT or SERVO_BAD_CHECKSUM.
+ * \par Others
+ *   None
+ */
+  uint8_t getLastError(uint8_t devId);
+
+/**
+ * \par Function
+ *   getBusStats
+ * \par Description
+ *   This function used to get the load of the bus since the last reset (all zero if SMART_SERVO_STATS is 0).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   the number of transactions, bytes sent and received and the time spent waiting for responses and processing them.
+ * \par Others
+ *   The counters wrap around after 2^32 (about 71 minutes of waiting time).
+ */
+  servo_bus_stats_type getBusStats(void);
+
+/**
+ * \par Function
+ *   getRttHistogram
+ * \par Description
+ *   This function used to get the histogram of the round trip times (command sent until response received) of a smart servo.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \param[in]
+ *   type - the command type (SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ, SERVO_STATS_CONFIG).
+ * \par Output
+ *   histogram - number of responses per bucket (see SERVO_STATS_BUCKETS), commands without response are counted in getErrorStats().
+ * \return
+ *   If the histogram is recorded, return true.
+ * \par Others
+ *   The counters stop at 65535.
+ */
+  bool getRttHistogram(uint8_t devId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]);
+
+/**
+ * \par Function
+ *   resetBusStats
+ * \par Description
+ *   This function used to reset the bus load statistics and the round trip time histograms of all servos.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+  void resetBusStats(void);
+
+/**
+ * \par Function
+ *   getResponseTimeout
+ * \par Description
+ *   This function used to get the time a command waits for the response of a smart servo before it is repeated.
+ *   Like the retransmission timeout of TCP it is the smoothed round trip time plus SERVO_RTO_K times its mean deviation,
+ *   limited to SERVO_MIN_RESPONSE_TIMEOUT ... SERVO_RESPONSE_TIMEOUT.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \param[in]
+ *   type - the command type (SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ, SERVO_STATS_CONFIG).
+ * \par Output
+ *   None
+ * \return
+ *   the timeout in us (SERVO_RESPONSE_TIMEOUT until a round trip time has been measured).
+ * \par Others
+ *   None
+ */
+  uint32_t getResponseTimeout(uint8_t devId, uint8_t type);
+
+/**
+ * \par Function
+ *   assignDevIdStart
+ * \par Description
+ *   start the distribution of device ID numbers to the smart servo link without waiting for the answers (see assignDevIdPoll()).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Used to enumerate the servos of several robots at the same time.
+ */
+  void assignDevIdStart(void);
+
+/**
+ * \par Function
+ *   assignDevIdPoll
+ * \par Description
+ *   process the answers to assignDevIdStart(). The assignment is finished when no servo answered for SERVO_ASSIGN_QUIET_TIME.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   PROCESS_BUSY while the assignment is running, PROCESS_SUC if it is finished, SERVO_TIMEOUT if no servo answered.
+ * \par Others
+ *   None
+ */
+  uint8_t assignDevIdPoll(void);
+
+/**
+ * \par Function
+ *   getNumDevices
+ * \par Description
+ *   This function used to get the highest device id which has been assigned or probed.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   the number of servos of the smart servo link known by the driver.
+ * \par Others
+ *   None
+ */
+  uint8_t getNumDevices(void);
+
+/**
+ * \par Function
+ *   getVersionRequest
+ * \par Description
+ *   This function used to read the firmware version of the smart servo (see getVersion()).
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered with its version, return true.
+ * \par Others
+ *   None
+ */
+  bool getVersionRequest(uint8_t devId);
+
+/**
+ * \par Function
+ *   probeRequest
+ * \par Description
+ *   This function used to check once and with the short timeout SERVO_PROBE_TIMEOUT if a servo with this device id answers,
+ *   e.g. to find out if the servos kept their ids while the microcontroller restarted. The firmware version is read as well.
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered, return true (the device id is known to the driver from now on).
+ * \par Others
+ *   The probe is not repeated and not counted in the error statistics.
+ */
+  bool probeRequest(uint8_t devId);
+
+/**
+ * \par Function
+ *   getVersion
+ * \par Description
+ *   This function used to get the firmware version read by getVersionRequest() or probeRequest().
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   version - the version as zero terminated string (empty if not known).
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+  void getVersion(uint8_t devId, char version[SERVO_VERSION_LENGTH + 1]);
+
+/**
+ * \par Function
+ *   readVersionResponse
+ * \par Description
+ *   This function is used to process the firmware version response of smart servo.
+ * \param[in]
+ *   *arg - address of input parameter.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+  void readVersionResponse(void *arg);
+
+/**
+ * \par Function
+ *   pollEvents
+ * \par Description
+ *   This function is used to process messages the servos sent without a request (e.g. the report that a position has been reached).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Does not wait, the messages are also processed while the driver waits for the response to a request.
+ */
+  void pollEvents(void);
+
+/**
+ * \par Function
+ *   getPositionReached
+ * \par Description
+ *   This function is used to check if the servo reported that it reached the position of the last moveTo() or move().
+ * \param[in]
+ *   devId - the device id of servo.
+ * \par Output
+ *   None
+ * \return
+ *   If the report has been received, return true.
+ * \par Others
+ *   Processes the received messages first (see pollEvents()).
+ */
+  bool getPositionReached(uint8_t devId);
+
+/**
+ * \par Function
+ *   clearPositionReached
+ * \par Description
+ *   This function is used to forget a received report that the position has been reached.
+ * \param[in]
+ *   devId - the device id of servo (ALL_DEVICE for all servos).
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Called by moveTo() and move() for the moved servo.
+ */
+  void clearPositionReached(uint8_t devId);
+
 private:
-  union sysex_message sysex;
-  volatile int16_t sysexBytesRead;
+/**
+ * \par Function
+ *   writeTx
+ * \par Description
+ *   add a byte to the frame in the transmit buffer.
+ * \param[in]
+ *   val - the byte to add.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+  void writeTx(uint8_t val);
+
+/**
+ * \par Function
+ *   request
+ * \par Description
+ *   send the frame in the transmit buffer and wait for the response. Timeouts, corrupted responses, busy and error responses are repeated up to SERVO_MAX_RETRIES times. The timeout is calculated from the round trip times of the servo and doubles with every timeout, busy and error responses are repeated after a delay which doubles as well (starting with SERVO_RETRY_BACKOFF).
+ * \param[in]
+ *   devId - the device id of servo the frame is sent to.
+ * \param[in]
+ *   flag - the bit of resFlag set by the expected response (0x40 for commands answered with an error code).
+ * \param[in]
+ *   repeatable - false if a command must not be repeated after it may have been executed (e.g. relative moves). It is only repeated if the servo was busy.
+ * \par Output
+ *   None
+ * \return
+ *   If the servo answered successfully, return true.
+ * \par Others
+ *   None
+ */
+  bool request(uint8_t devId, uint16_t flag, bool repeatable = true);
+
+/**
+ * \par Function
+ *   transmit
+ * \par Description
+ *   send the frame in the transmit buffer once and wait for the response.
+ * \param[in]
+ *   flag - the bit of resFlag set by the expected response.
+ * \param[in]
+ *   timeout - the time in us to wait for the response.
+ * \par Output
+ *   rtt - the time in us until the response has been received.
+ * \return
+ *   PROCESS_SUC or the error (see getLastError()).
+ * \par Others
+ *   None
+ */
+  uint8_t transmit(uint16_t flag, uint32_t timeout, uint32_t *rtt);
+
+/**
+ * \par Function
+ *   recordRtt
+ * \par Description
+ *   add the round trip time of the frame in the transmit buffer to the histogram of its servo and command type.
+ * \param[in]
+ *   rtt - the round trip time in us.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   None
+ */
+  void recordRtt(uint32_t rtt);
+
+/**
+ * \par Function
+ *   getCommandType
+ * \par Description
+ *   get the command type of the frame in the transmit buffer from its service id and secondary command.
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ or SERVO_STATS_CONFIG.
+ * \par Others
+ *   None
+ */
+  uint8_t getCommandType(void);
+
+/**
+ * \par Function
+ *   isSlowCommand
+ * \par Description
+ *   check if the frame in the transmit buffer is a configuration command the servo needs long to answer (e.g. it stores values).
+ * \param[in]
+ *   None
+ * \par Output
+ *   None
+ * \return
+ *   If the response takes much longer than the one of other configuration commands, return true.
+ * \par Others
+ *   None
+ */
+  bool isSlowCommand(void);
+
+/**
+ * \par Function
+ *   updateRtt
+ * \par Description
+ *   update the smoothed round trip time and its mean deviation with a new measurement (gains 1/8 and 1/4 as in TCP).
+ * \param[in]
+ *   devId - the device id of servo.
+ * \param[in]
+ *   type - the command type.
+ * \param[in]
+ *   rtt - the measured round trip time in us.
+ * \par Output
+ *   None
+ * \return
+ *   None
+ * \par Others
+ *   Only responses to the first transmission of a frame are measured, the response to a repetition may belong to the first one.
+ */
+  void updateRtt(uint8_t devId, uint8_t type, uint32_t rtt);
+
   volatile uint8_t servo_num_max;
   volatile uint16_t resFlag;
-  volatile servo_device_type servo_dev_list[8];
+  volatile servo_device_type servo_dev_list[SMART_SERVO_MAX_DEVICES];
   volatile long cmdTimeOutValue;
-  volatile bool parsingSysex;
+  volatile uint8_t rxStatus;
+  volatile uint8_t rxDevId;
+  unsigned long assignLastResponse;
+  bool assignAnswered;
+  uint8_t txBuffer[DEFAULT_UART_BUF_SIZE];
+  uint8_t txLength;
+  servo_error_type errorStats[SMART_SERVO_MAX_DEVICES];
+  servo_rtt_type rttEstimate[SMART_SERVO_MAX_DEVICES][SERVO_STATS_TYPES];
+#if SMART_SERVO_STATS
+  servo_bus_stats_type busStats;
+  uint16_t rttHistogram[SMART_SERVO_MAX_DEVICES][SERVO_STATS_TYPES][SERVO_STATS_BUCKETS];
+#endif
   smartServoCb _callback;
-  Stream* port;
+  volatile bool positionReached[SMART_SERVO_MAX_DEVICES];
+  servoFrameParser parser;
+  servoTransport *transport;
+  streamTransport serialTransport;
 };
 #endif
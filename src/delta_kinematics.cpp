@@ -0,0 +1,194 @@
+/**
+ *  \class 	deltaKinematics
+ *  \brief 	Forward and inverse kinematics and velocity Jacobian of a delta robot with constants calculated once from its geometry
+ *  @file 	delta_kinematics.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		deltaKinematics(float e, float f, float re, float rf);
+			bool inverse(float x, float y, float z, float angles[3]);
+			bool forward(const float angles[3], float pos[3]);
+			bool calculateJacobian(const float angles[3], const float pos[3], float jacobian[3][3]);
+			bool calculateInverseJacobian(const float angles[3], const float pos[3], float inverse[3][3]);
+			bool calculateJointVelocities(const float angles[3], const float pos[3], const float tcpVel[3], float jointVel[3]);
+		private:
+			bool solveArm(float y, float r2, float invZ, float &theta);
+			void calculateElbows(const float angles[3], float elbows[3][3], float derivatives[3][3]=NULL);
+ */
+
+#include "delta_kinematics.h"
+
+deltaKinematics::deltaKinematics(float e, float f, float re, float rf){
+	_rf = rf;
+	_rf2 = rf*rf;
+	_re2 = re*re;
+	_t = (f-e)*DELTA_TAN30/2;
+	_y1 = -0.5*DELTA_TAN30*f;
+	_shift = 0.5*DELTA_TAN30*e;
+	_ikConst = _shift*_shift + _rf2 - _re2 - _y1*_y1;
+	// The rows of the Jacobian are vectors of length re, the arm terms products of re and rf
+	_minDet = DELTA_MIN_DET*_re2*re;
+	_minArmTerm = DELTA_MIN_DET*re*rf*(float)DEG_TO_RAD;
+}
+
+bool deltaKinematics::inverse(float x, float y, float z, float angles[3]){
+	if (z == 0) return false;
+
+	// The distance to the origin and 1/z do not change when the coordinates are rotated to the other arms
+	float r2 = x*x + y*y + z*z;
+	float invZ = 1/z;
+	if (!solveArm(y, r2, invZ, angles[0])) return false;
+	if (!solveArm(y*DELTA_COS120 - x*DELTA_SIN120, r2, invZ, angles[1])) return false;	// rotate coords to +120 deg
+	if (!solveArm(y*DELTA_COS120 + x*DELTA_SIN120, r2, invZ, angles[2])) return false;	// rotate coords to -120 deg
+	return true;
+}
+
+bool deltaKinematics::forward(const float angles[3], float pos[3]){
+	// Elbows shifted by the effector offset (see calculateElbows(), written out because this runs every control cycle)
+	float theta1 = angles[0]*(float)DEG_TO_RAD;
+	float theta2 = angles[1]*(float)DEG_TO_RAD;
+	float theta3 = angles[2]*(float)DEG_TO_RAD;
+
+	float y1 = -(_t + _rf*cos(theta1));
+	float z1 = -_rf*sin(theta1);
+
+	float y2 = 0.5f*(_t + _rf*cos(theta2));
+	float x2 = y2*DELTA_TAN60;
+	float z2 = -_rf*sin(theta2);
+
+	float y3 = 0.5f*(_t + _rf*cos(theta3));
+	float x3 = -y3*DELTA_TAN60;
+	float z3 = -_rf*sin(theta3);
+
+	float dnm = (y2-y1)*x3-(y3-y1)*x2;
+
+	float w1 = y1*y1 + z1*z1;
+	float w2 = x2*x2 + y2*y2 + z2*z2;
+	float w3 = x3*x3 + y3*y3 + z3*z3;
+
+	// x = (a1*z + b1)/dnm
+	float a1 = (z2-z1)*(y3-y1)-(z3-z1)*(y2-y1);
+	float b1 = -((w2-w1)*(y3-y1)-(w3-w1)*(y2-y1))/2;
+
+	// y = (a2*z + b2)/dnm;
+	float a2 = -(z2-z1)*x3+(z3-z1)*x2;
+	float b2 = ((w2-w1)*x3 - (w3-w1)*x2)/2;
+
+	// a*z^2 + b*z + c = 0
+	float b2y = b2-y1*dnm;
+	float dnm2 = dnm*dnm;
+	float a = a1*a1 + a2*a2 + dnm2;
+	float b = 2*(a1*b1 + a2*b2y - z1*dnm2);
+	float c = b2y*b2y + b1*b1 + dnm2*(z1*z1 - _re2);
+
+	// discriminant
+	float d = b*b - (float)4.0*a*c;
+	if (d < 0) return false;
+
+	pos[2] = -(float)0.5*(b+sqrt(d))/a;
+	pos[0] = (a1*pos[2] + b1)/dnm;
+	pos[1] = (a2*pos[2] + b2)/dnm;
+	return true;
+}
+
+bool deltaKinematics::calculateJacobian(const float angles[3], const float pos[3], float jacobian[3][3]){
+	float elbows[3][3];
+	float derivatives[3][3];
+	calculateElbows(angles, elbows, derivatives);
+
+	// Rows of the matrix: vectors from the elbows to the effector (s_i * v = k_i * dtheta_i/dt)
+	float s[3][3];
+	float k[3];
+	for (uint8_t i=0; i<3; i++) {
+		for (uint8_t j=0; j<3; j++) s[i][j] = pos[j] - elbows[i][j];
+		k[i] = (s[i][0]*derivatives[i][0] + s[i][1]*derivatives[i][1] + s[i][2]*derivatives[i][2]) * (float)DEG_TO_RAD;
+	}
+
+	float det = s[0][0]*(s[1][1]*s[2][2] - s[1][2]*s[2][1])
+			  - s[0][1]*(s[1][0]*s[2][2] - s[1][2]*s[2][0])
+			  + s[0][2]*(s[1][0]*s[2][1] - s[1][1]*s[2][0]);
+	if (fabs(det) < _minDet) return false;
+
+	// jacobian = inverse(s) * diag(k), the inverse is the adjugate divided by the determinant
+	float invDet = 1/det;
+	for (uint8_t j=0; j<3; j++) {
+		uint8_t j1 = (j+1)%3;
+		uint8_t j2 = (j+2)%3;
+		for (uint8_t i=0; i<3; i++) {
+			uint8_t i1 = (i+1)%3;
+			uint8_t i2 = (i+2)%3;
+			jacobian[i][j] = (s[j1][i1]*s[j2][i2] - s[j1][i2]*s[j2][i1]) * invDet * k[j];
+		}
+	}
+	return true;
+}
+
+bool deltaKinematics::calculateInverseJacobian(const float angles[3], const float pos[3], float inverse[3][3]){
+	float elbows[3][3];
+	float derivatives[3][3];
+	calculateElbows(angles, elbows, derivatives);
+
+	for (uint8_t i=0; i<3; i++) {
+		float s[3];
+		for (uint8_t j=0; j<3; j++) s[j] = pos[j] - elbows[i][j];
+		float k = (s[0]*derivatives[i][0] + s[1]*derivatives[i][1] + s[2]*derivatives[i][2]) * (float)DEG_TO_RAD;
+		if (fabs(k) < _minArmTerm) return false;
+		for (uint8_t j=0; j<3; j++) inverse[i][j] = s[j]/k;
+	}
+	return true;
+}
+
+bool deltaKinematics::calculateJointVelocities(const float angles[3], const float pos[3], const float tcpVel[3], float jointVel[3]){
+	float inverse[3][3];
+	if (!calculateInverseJacobian(angles, pos, inverse)) return false;
+	for (uint8_t i=0; i<3; i++) jointVel[i] = inverse[i][0]*tcpVel[0] + inverse[i][1]*tcpVel[1] + inverse[i][2]*tcpVel[2];
+	return true;
+}
+
+/* PRIVATE */
+bool deltaKinematics::solveArm(float y, float r2, float invZ, float &theta){
+	// z = a + b*y, with y shifted from the center to the edge of the effector
+	float a = (r2 - 2*_shift*y + _ikConst)*0.5f*invZ;
+	float b = (_y1 - y + _shift)*invZ;
+	// discriminant
+	float ab = a + b*_y1;
+	float d = _rf2*(b*b + 1) - ab*ab;
+	if (d < 0) return false; // non-existing point
+	float yj = (_y1 - a*b - sqrt(d))/(b*b + 1); // choosing outer point
+	float zj = a + b*yj;
+	theta = (float)RAD_TO_DEG*atan(-zj/(_y1 - yj)) + ((yj>_y1)?180.0f:0.0f);
+	return true;
+}
+
+void deltaKinematics::calculateElbows(const float angles[3], float elbows[3][3], float derivatives[3][3]){
+	// Distance of each elbow to the z-axis and its derivative
+	float r[3];
+	float dr[3];
+	for (uint8_t i=0; i<3; i++) {
+		float theta = angles[i]*(float)DEG_TO_RAD;
+		float c = cos(theta);
+		float s = sin(theta);
+		r[i] = _t + _rf*c;
+		elbows[i][2] = -_rf*s;
+		if (derivatives != NULL) {
+			dr[i] = -_rf*s;
+			derivatives[i][2] = -_rf*c;
+		}
+	}
+
+	// Motor 1 on the negative y-axis, motor 2 and 3 rotated by +-120 degrees (y = r*sin30, x = +-y*tan60)
+	elbows[0][0] = 0;
+	elbows[0][1] = -r[0];
+	elbows[1][1] = 0.5f*r[1];
+	elbows[1][0] = DELTA_TAN60*elbows[1][1];
+	elbows[2][1] = 0.5f*r[2];
+	elbows[2][0] = -DELTA_TAN60*elbows[2][1];
+	if (derivatives == NULL) return;
+	derivatives[0][0] = 0;
+	derivatives[0][1] = -dr[0];
+	derivatives[1][1] = 0.5f*dr[1];
+	derivatives[1][0] = DELTA_TAN60*derivatives[1][1];
+	derivatives[2][1] = 0.5f*dr[2];
+	derivatives[2][0] = -DELTA_TAN60*derivatives[2][1];
+}
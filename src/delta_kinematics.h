@@ -0,0 +1,125 @@
+/**
+ *  \class 	deltaKinematics
+ *  \brief 	Forward and inverse kinematics and velocity Jacobian of a delta robot with constants calculated once from its geometry
+ *  @file 	delta_kinematics.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		deltaKinematics(float e, float f, float re, float rf);
+			bool inverse(float x, float y, float z, float angles[3]);
+			bool forward(const float angles[3], float pos[3]);
+			bool calculateJacobian(const float angles[3], const float pos[3], float jacobian[3][3]);
+			bool calculateInverseJacobian(const float angles[3], const float pos[3], float inverse[3][3]);
+			bool calculateJointVelocities(const float angles[3], const float pos[3], const float tcpVel[3], float jointVel[3]);
+		private:
+			bool solveArm(float y, float r2, float invZ, float &theta);
+			void calculateElbows(const float angles[3], float elbows[3][3], float derivatives[3][3]=NULL);
+ *  \par Coordinates:
+ *  	The origin is in the center of the base triangle, the z-axis points up (the effector has negative z-values). Motor 1 is on the negative y-axis,
+ *  	motor 2 and 3 follow at +120 and -120 degrees. Angles are given in degrees, 0 degrees is a horizontal upper link.
+ *  	Velocities are given in mm/s and degrees/s.
+ *  \par Velocity Jacobian:
+ *  	Each parallelogram keeps the distance between its elbow and the effector constant (re). Differentiating this condition gives
+ *  	s_i * v = (s_i * dE_i/dtheta_i) * dtheta_i/dt for every arm i (s_i: vector from elbow to effector, E_i: elbow position).
+ *  	Each row of the inverse Jacobian is therefore s_i divided by a scalar, the Jacobian needs the inverse of the 3x3 matrix of the s_i.
+ */
+
+#ifndef DELTA_KINEMATICS_H
+#define DELTA_KINEMATICS_H
+
+#include <Arduino.h>
+
+#define DELTA_SIN120	0.8660254f	//!< sin(120 degrees)
+#define DELTA_COS120	-0.5f		//!< cos(120 degrees)
+#define DELTA_TAN60		1.7320508f	//!< tan(60 degrees)
+#define DELTA_TAN30		0.5773503f	//!< tan(30 degrees)
+#define DELTA_MIN_DET	1e-3f		//!< Smallest determinant (relative to re^3) or arm term (relative to re*rf) accepted before a pose is treated as singular
+
+class deltaKinematics {
+	public:
+		/**
+		 *  \brief Constructor of deltaKinematics class. Calculates all constants of the geometry.
+		 *  \param [in] e Length of side of end effector triangle
+		 *  \param [in] f Length of side of base triangle
+		 *  \param [in] re Length of parallelogram link
+		 *  \param [in] rf Length of upper link
+		 */
+		deltaKinematics(float e, float f, float re, float rf);
+
+		/**
+		 *  \brief Calculates the motor angles for a position of the effector (inverse kinematics)
+		 *  \param [in] x Position of the effector
+		 *  \param [in] y Position of the effector
+		 *  \param [in] z Position of the effector (negative, below the base)
+		 *  \param [out] angles Angles of the three motors in degrees
+		 *  \return Returns false if the position can not be reached
+		 */
+		bool inverse(float x, float y, float z, float angles[3]);
+
+		/**
+		 *  \brief Calculates the position of the effector from the motor angles (forward kinematics)
+		 *  \param [in] angles Angles of the three motors in degrees
+		 *  \param [out] pos Position of the effector
+		 *  \return Returns false if the angles do not describe a valid pose
+		 */
+		bool forward(const float angles[3], float pos[3]);
+
+		/**
+		 *  \brief Calculates the velocity Jacobian (velocity of the effector = jacobian * joint velocities)
+		 *  \param [in] angles Angles of the three motors in degrees
+		 *  \param [in] pos Position of the effector at these angles (see forward())
+		 *  \param [out] jacobian Jacobian in mm per degree
+		 *  \return Returns false if the pose is singular
+		 */
+		bool calculateJacobian(const float angles[3], const float pos[3], float jacobian[3][3]);
+
+		/**
+		 *  \brief Calculates the inverse of the velocity Jacobian (joint velocities = inverse * velocity of the effector) without inverting a matrix
+		 *  \param [in] angles Angles of the three motors in degrees
+		 *  \param [in] pos Position of the effector at these angles (see forward())
+		 *  \param [out] inverse Inverse Jacobian in degrees per mm
+		 *  \return Returns false if the pose is singular (an upper link is in line with its parallelogram)
+		 */
+		bool calculateInverseJacobian(const float angles[3], const float pos[3], float inverse[3][3]);
+
+		/**
+		 *  \brief Calculates the joint velocities which move the effector with a given velocity
+		 *  \param [in] angles Angles of the three motors in degrees
+		 *  \param [in] pos Position of the effector at these angles (see forward())
+		 *  \param [in] tcpVel Velocity of the effector in mm/s
+		 *  \param [out] jointVel Velocities of the motors in degrees/s
+		 *  \return Returns false if the pose is singular
+		 */
+		bool calculateJointVelocities(const float angles[3], const float pos[3], const float tcpVel[3], float jointVel[3]);
+	private:
+		/**
+		 *  \brief Calculates the angle of one motor in the plane of its arm (coordinates rotated so the arm lies on the negative y-axis)
+		 *  \param [in] y Rotated position of the effector on the y-axis of the arm (x and z only enter through r2 and invZ)
+		 *  \param [in] r2 Squared distance of the effector to the origin (the same for all arms)
+		 *  \param [in] invZ 1/z (the same for all arms)
+		 *  \param [out] theta Angle of the motor in degrees
+		 *  \return Returns false if the arm can not reach the position
+		 */
+		bool solveArm(float y, float r2, float invZ, float &theta);
+
+		/**
+		 *  \brief Calculates the elbow positions (shifted by the effector offset) and their derivatives by the motor angles
+		 *  \param [in] angles Angles of the three motors in degrees
+		 *  \param [out] elbows Positions of the elbows
+		 *  \param [out] derivatives (Optional) Derivatives of the elbow positions in mm per radian
+		 */
+		void calculateElbows(const float angles[3], float elbows[3][3], float derivatives[3][3]=NULL);
+
+		float _rf;			//!< Length of upper link
+		float _rf2;			//!< Squared length of upper link
+		float _re2;			//!< Squared length of parallelogram link
+		float _t;			//!< Distance between the motor axes and the effector joints projected to the base ((f-e)*tan30/2)
+		float _y1;			//!< Position of the motor axis on the y-axis of an arm (-f/2*tan30)
+		float _shift;		//!< Distance between center and edge of the effector triangle (e/2*tan30)
+		float _ikConst;		//!< Constant part of the inverse kinematics (shift^2 + rf^2 - re^2 - y1^2)
+		float _minDet;		//!< Smallest determinant of the Jacobian accepted (DELTA_MIN_DET*re^3)
+		float _minArmTerm;	//!< Smallest arm term of the inverse Jacobian accepted (DELTA_MIN_DET*re*rf, converted to mm^2 per degree)
+};
+
+#endif
@@ -21,14 +21,22 @@
 				bool moveToAngle(float angle, uint8_t speed=50);
 				bool moveWidth(float width, uint8_t speed=50);
 				bool moveToWidth(float width, uint8_t speed=50);
+				bool startMoveToAngle(float angle, uint8_t speed=50);
+				bool startOpen();
+				bool startClose();
+				bool isFinished();
+				bool waitUntilFinished();
 				bool closeToForce(float maxCurrent=70);
+				bool graspToForce(float targetCurrent=70, uint8_t pwm=GRIPPER_GRASP_PWM);
+				const grasp_trace_type& getGraspTrace();
+				void printGraspTrace();
 				float getCurrentOpeningAngle();
 				float getCurrentOpeningWidth();
 				bool isClosed();
 				bool isOpened();
 			private:
 				bool checkIfAngleValid(float angle);
-				bool waitUntilFinished();
+				void recordGraspSample(unsigned long time, float current, int16_t pwm);
 				bool functionNotImplementedError();
  *  	binaryEEF:
  *  		public:
@@ -37,6 +45,8 @@
  *  			void deactivate();
  *  			bool isActivated();
  *  			bool isDeactivated();
+ *  			static void activateTrigger(void* eef);
+ *  			static void deactivateTrigger(void* eef);
  */
  
 #include "eef.h"
@@ -44,6 +54,11 @@
 gripper::gripper(morobotClass* morobotToAttachTo){
 	_isOpened = false;
 	_isClosed = false;
+	_graspTrace.contactTime = 0;
+	_graspTrace.graspTime = 0;
+	_graspTrace.numSamples = 0;
+	_isMoving = false;
+	_moveSucceeded = true;
 	
 	morobot = morobotToAttachTo;
 }
@@ -162,10 +177,8 @@ bool gripper::moveAngle(float angle, uint8_t speed){
 
 bool gripper::moveToAngle(float angle, uint8_t speed){
 	if (_gripperType == 0){
-		if (checkIfAngleValid(angle) != true) return false;			// Check if angle is valid
 		float oldAngle = getCurrentOpeningAngle();
-		morobot->smartServos.moveTo(_servoID+1, angle, speed);
-		_currentAngle = getCurrentOpeningAngle();
+		if (startMoveToAngle(angle, speed) == false) return false;
 		if (abs(oldAngle-angle) > 10) return waitUntilFinished();	// Only wait for bigger movements
 	} else if (_gripperType == 1) {
 		angle = angle * _gearRatio + _degClosed;					// Calculate angle in motor-degrees
@@ -213,6 +226,80 @@ bool gripper::moveToWidth(float width, uint8_t speed){
 	}
 }
 
+bool gripper::startMoveToAngle(float angle, uint8_t speed){
+	if (_gripperType != 0) return functionNotImplementedError();
+	if (checkIfAngleValid(angle) != true) return false;			// Check if angle is valid
+	
+	if (morobot->smartServos.moveTo(_servoID+1, angle, speed) == false) {
+		Serial.println(F("ERROR: Gripper does not respond"));
+		return false;
+	}
+	_targetAngle = angle;
+	_isMoving = true;
+	_moveSucceeded = true;
+	_moveStartTime = millis();
+	_lastPollTime = _moveStartTime;
+	_lastPollAngle = _currentAngle;
+	_isOpened = false;
+	_isClosed = false;
+	return true;
+}
+
+bool gripper::startOpen(){
+	if (_gripperType != 0) {
+		open();
+		return true;
+	}
+	if (startMoveToAngle(_degOpen, _speed[0]) == false) return false;
+	_isOpened = true;
+	return true;
+}
+
+bool gripper::startClose(){
+	if (_gripperType != 0) {
+		close();
+		return true;
+	}
+	if (startMoveToAngle(_degClosed, _speed[1]) == false) return false;
+	_isClosed = true;
+	return true;
+}
+
+bool gripper::isFinished(){
+	if (_isMoving == false) return true;
+	
+	// The motor reports when it reached the goal, one reading confirms it (the report could belong to an older movement)
+	if (morobot->smartServos.getPositionReached(_servoID+1)) {
+		long angle = morobot->smartServos.getAngleRequest(_servoID+1);
+		if (labs(angle - _targetAngle) <= POSITION_REACHED_TOLERANCE) {
+			_currentAngle = angle;
+			_isMoving = false;
+			return true;
+		}
+	}
+	
+	// If an object stops the gripper, there is no report: the movement has finished when the angle does not change anymore
+	if ((millis() - _lastPollTime) >= GRIPPER_POLL_PERIOD) {
+		long angle = morobot->smartServos.getAngleRequest(_servoID+1);
+		_lastPollTime = millis();
+		if (angle == _lastPollAngle) {
+			_currentAngle = angle;
+			_isMoving = false;
+			return true;
+		}
+		_lastPollAngle = angle;
+	}
+	
+	// Stop waiting if the gripper is not finished after a timeout occurs
+	if ((millis() - _moveStartTime) > TIMEOUT_DELAY_GRIPPER) {
+		Serial.println(F("TIMEOUT OCCURED WHILE WAITING FOR GRIPPER TO FINISH MOVEMENT!"));
+		_isMoving = false;
+		_moveSucceeded = false;
+		return true;
+	}
+	return false;
+}
+
 bool gripper::closeToForce(float maxCurrent){
 	if (_gripperType == 0){
 		float closingStep = -5;
@@ -243,6 +330,95 @@ bool gripper::closeToForce(float maxCurrent){
 	return false;
 }
 
+bool gripper::graspToForce(float targetCurrent, uint8_t pwm){
+	if (_gripperType != 0) return functionNotImplementedError();
+	
+	int8_t direction = -1;
+	if (_closingDirectionIsPositive == true) direction = 1;		// Define rotation direction
+	_graspTrace.contactTime = 0;
+	_graspTrace.graspTime = 0;
+	_graspTrace.numSamples = 0;
+	
+	float command = pwm;
+	float filtered = 0;
+	bool contact = false;
+	uint8_t settleSamples = 0;
+	unsigned long startTime = millis();
+	unsigned long nextSample = startTime;
+	if (morobot->smartServos.setPwmMove(_servoID+1, direction * pwm) == false) {
+		Serial.println(F("ERROR: Gripper does not respond"));
+		return false;
+	}
+	
+	while (true){
+		// Read the current at a fixed rate while the motor keeps moving
+		while ((long)(millis() - nextSample) < 0);
+		nextSample += GRIPPER_GRASP_PERIOD;
+		unsigned long time = millis() - startTime;
+		filtered += GRIPPER_GRASP_FILTER * (morobot->smartServos.getCurrentRequest(_servoID+1) - filtered);
+		recordGraspSample(time, filtered, direction * (int16_t)command);
+		
+		if (contact == false) {
+			if (filtered > targetCurrent && time > GRIPPER_GRASP_STARTUP) {
+				contact = true;
+				_graspTrace.contactTime = time;
+			}
+		} else {
+			// The motor is stalled, so the current follows the PWM: adapt the PWM until the current matches the target
+			command += GRIPPER_GRASP_PWM_GAIN * (targetCurrent - filtered);
+			if (command < 0) command = 0;
+			if (command > 255) command = 255;
+			morobot->smartServos.setPwmMove(_servoID+1, direction * (int16_t)command);
+			settleSamples++;
+			if (settleSamples >= GRIPPER_GRASP_SETTLE) {
+				_graspTrace.graspTime = millis() - startTime;
+				Serial.println(F("Grasped object"));
+				_currentAngle = getCurrentOpeningAngle();
+				_isOpened = false;
+				_isClosed = true;
+				return true;
+			}
+		}
+		
+		// Stop if the gripper is not finished after a timeout occurs
+		if (time > TIMEOUT_DELAY_GRIPPER) {
+			morobot->smartServos.setPwmMove(_servoID+1, 0);
+			Serial.println(F("TIMEOUT OCCURED WHILE WAITING FOR GRIPPER TO FINISH MOVEMENT!"));
+			return false;
+		}
+	}
+}
+
+const grasp_trace_type& gripper::getGraspTrace(){
+	return _graspTrace;
+}
+
+void gripper::printGraspTrace(){
+	Serial.print(F("Contact after "));
+	Serial.print(_graspTrace.contactTime);
+	Serial.print(F("ms, grasped after "));
+	Serial.print(_graspTrace.graspTime);
+	Serial.print(F("ms, readings: "));
+	Serial.println(_graspTrace.numSamples);
+	
+	// Print the stored readings from the oldest to the newest one
+	uint16_t first = 0;
+	uint16_t count = _graspTrace.numSamples;
+	if (count > GRIPPER_TRACE_LENGTH) {
+		first = _graspTrace.numSamples % GRIPPER_TRACE_LENGTH;
+		count = GRIPPER_TRACE_LENGTH;
+	}
+	Serial.println(F("Time [ms]\tCurrent\tPWM"));
+	for (uint16_t i=0; i<count; i++){
+		uint16_t index = (first + i) % GRIPPER_TRACE_LENGTH;
+		Serial.print(_graspTrace.time[index]);
+		Serial.print(F("\t"));
+		Serial.print(_graspTrace.current[index]);
+		Serial.print(F("\t"));
+		Serial.println(_graspTrace.pwm[index]);
+	}
+}
+
 float gripper::getCurrentOpeningAngle(){
 	if (_gripperType == 0) {
 		_currentAngle = morobot->smartServos.getAngleRequest(_servoID+1);
@@ -276,17 +452,16 @@ bool gripper::checkIfAngleValid(float angle){
 }
 
 bool gripper::waitUntilFinished(){
-	unsigned long startTime = millis();
-	while (true){
-		long startPos = getCurrentOpeningAngle();
-		delay(50);
-		if (startPos == getCurrentOpeningAngle()) return true;	// If after 50ms the position is still the same, the gripper has reached the goal
-		// Stop waiting if the gripper is not finished after a timeout occurs
-		if ((millis() - startTime) > TIMEOUT_DELAY_GRIPPER) {
-			Serial.println(F("TIMEOUT OCCURED WHILE WAITING FOR GRIPPER TO FINISH MOVEMENT!"));
-			return false;
-		}
-	}
+	while (isFinished() == false);
+	return _moveSucceeded;
+}
+
+void gripper::recordGraspSample(unsigned long time, float current, int16_t pwm){
+	uint16_t index = _graspTrace.numSamples % GRIPPER_TRACE_LENGTH;
+	_graspTrace.time[index] = time;
+	_graspTrace.current[index] = current;
+	_graspTrace.pwm[index] = pwm;
+	if (_graspTrace.numSamples < 0xFFFF) _graspTrace.numSamples++;
 }
 
 bool gripper::functionNotImplementedError(){
@@ -319,3 +494,11 @@ bool binaryEEF::isDeactivated(){
 	return !_isActive;
 }
 
+void binaryEEF::activateTrigger(void* eef){
+	((binaryEEF*)eef)->activate();
+}
+
+void binaryEEF::deactivateTrigger(void* eef){
+	((binaryEEF*)eef)->deactivate();
+}
+
@@ -21,14 +21,22 @@
 				bool moveToAngle(float angle, uint8_t speed=50);
 				bool moveWidth(float width, uint8_t speed=50);
 				bool moveToWidth(float width, uint8_t speed=50);
+				bool startMoveToAngle(float angle, uint8_t speed=50);
+				bool startOpen();
+				bool startClose();
+				bool isFinished();
+				bool waitUntilFinished();
 				bool closeToForce(float maxCurrent=70);
+				bool graspToForce(float targetCurrent=70, uint8_t pwm=GRIPPER_GRASP_PWM);
+				const grasp_trace_type& getGraspTrace();
+				void printGraspTrace();
 				float getCurrentOpeningAngle();
 				float getCurrentOpeningWidth();
 				bool isClosed();
 				bool isOpened();
 			private:
 				bool checkIfAngleValid(float angle);
-				bool waitUntilFinished();
+				void recordGraspSample(unsigned long time, float current, int16_t pwm);
 				bool functionNotImplementedError();
  *  	binaryEEF:
  *  		public:
@@ -37,6 +45,8 @@
  *  			void deactivate();
  *  			bool isActivated();
  *  			bool isDeactivated();
+ *  			static void activateTrigger(void* eef);
+ *  			static void deactivateTrigger(void* eef);
  */
 
 #if defined(ESP32)
@@ -52,6 +62,26 @@
 #include "morobot.h"
 
 #define TIMEOUT_DELAY_GRIPPER 25000		//!< Delay after which the gripper stops moving when closeToForce() is used
+#define GRIPPER_POLL_PERIOD 50			//!< Time in ms between two angle readings while isFinished() waits for a movement without report of the motor
+
+#define GRIPPER_GRASP_PWM			150		//!< Default PWM with which graspToForce() closes the gripper
+#define GRIPPER_GRASP_PERIOD		10		//!< Time in ms between two current readings in graspToForce()
+#define GRIPPER_GRASP_FILTER		0.3		//!< Weight of a new current reading in the low-pass filter of graspToForce()
+#define GRIPPER_GRASP_STARTUP		60		//!< Time in ms after the start of graspToForce() in which no contact is detected (starting current of the motor)
+#define GRIPPER_GRASP_SETTLE		15		//!< Number of readings after the contact in which graspToForce() adapts the PWM to the force target
+#define GRIPPER_GRASP_PWM_GAIN		0.5		//!< Change of the PWM per unit of current difference while the grasp settles
+#ifndef GRIPPER_TRACE_LENGTH
+#define GRIPPER_TRACE_LENGTH		32		//!< Number of readings stored by graspToForce() (the last ones of the grasp)
+#endif
+
+typedef struct {
+	unsigned long contactTime;				//!< Time in ms from the start of the grasp until the contact has been detected (0 if no contact)
+	unsigned long graspTime;				//!< Time in ms from the start of the grasp until the force target is held (0 if not finished)
+	uint16_t numSamples;					//!< Number of readings taken (only the last GRIPPER_TRACE_LENGTH are stored)
+	uint16_t time[GRIPPER_TRACE_LENGTH];	//!< Time of the reading in ms since the start of the grasp
+	float current[GRIPPER_TRACE_LENGTH];	//!< Filtered current
+	int16_t pwm[GRIPPER_TRACE_LENGTH];		//!< PWM applied when the current was read
+} grasp_trace_type;
 
 class gripper {
 	public:
@@ -157,6 +187,41 @@ class gripper {
 		 */
 		bool moveToWidth(float width, uint8_t speed=50);
 		
+		/**
+		 *  \brief Starts moving the gripper to a defined angle (absolute) and returns immediately, so the robot can move meanwhile. Only implemented for smart-servo.
+		 *  \details The end of the movement is detected by isFinished(). Other commands to the robot can be sent in the meantime.
+		 *  \param [in] angle Angle to move the gripper to
+		 *  \param [in] speed Speed to use for movement (Default: maximum speed)
+		 *  \return Returns true if the movement has been started
+		 */
+		bool startMoveToAngle(float angle, uint8_t speed=50);
+		
+		/**
+		 *  \brief Starts opening the gripper without waiting (see startMoveToAngle()). The servo-gripper opens blocking.
+		 *  \return Returns true if the movement has been started
+		 */
+		bool startOpen();
+		
+		/**
+		 *  \brief Starts closing the gripper without waiting (see startMoveToAngle()). The servo-gripper closes blocking.
+		 *  \return Returns true if the movement has been started
+		 */
+		bool startClose();
+		
+		/**
+		 *  \brief Checks if the last movement of the gripper has finished, without waiting.
+		 *  \details The movement is finished as soon as the motor reports that it reached the goal. If an object stops the gripper before,
+		 *  		 the movement is finished when the angle does not change for GRIPPER_POLL_PERIOD ms.
+		 *  \return Returns true if the gripper does not move (or a timeout occured)
+		 */
+		bool isFinished();
+		
+		/**
+		 *  \brief Makes sure the program does not continue until smart-servo-gripper has stopped moving (see isFinished())
+		 *  \return True is the gripper reached the target position, false otherwise
+		 */
+		bool waitUntilFinished();
+		
 		/**
 		 *  \brief Closes the gripper until a defined force (current) is reached. Only implemented for smart-servo.
 		 *  \param [in] maxCurrent Current at which the movement should stop
@@ -164,6 +229,27 @@ class gripper {
 		 */
 		bool closeToForce(float maxCurrent=70);
 		
+		/**
+		 *  \brief Closes the gripper with a constant PWM until the filtered current reaches the target and holds the object with this current. Only implemented for smart-servo.
+		 *  \details The current is read every GRIPPER_GRASP_PERIOD ms while the motor keeps moving, so the grasp is only limited by the speed of the gripper.
+		 *  After the contact the PWM of the stalled motor is adapted until the current matches the target. The motor keeps the PWM (call open() or moveToAngle() to release the object).
+		 *  The readings are stored in a trace (see getGraspTrace() and printGraspTrace()).
+		 *  \param [in] targetCurrent Current at which the contact is detected and which is held afterwards (defines the gripping force)
+		 *  \param [in] pwm (Optional) PWM to close the gripper with (0-255)
+		 *  \return Returns true if the object is grasped, false if the gripper does not respond or no contact has been detected before the timeout
+		 */
+		bool graspToForce(float targetCurrent=70, uint8_t pwm=GRIPPER_GRASP_PWM);
+		
+		/**
+		 *  \brief Returns the trace of the last call of graspToForce()
+		 */
+		const grasp_trace_type& getGraspTrace();
+		
+		/**
+		 *  \brief Prints contact time, grasp time and the stored readings (time, current, PWM) of the last call of graspToForce()
+		 */
+		void printGraspTrace();
+		
 		/**
 		 *  \brief Calculates and return current opening angle of the gripper
 		 *  \return Current opening angle of the gripper
@@ -199,10 +285,9 @@ class gripper {
 		bool checkIfAngleValid(float angle);
 		
 		/**
-		 *  \brief Makes sure the program does not continue until smart-servo-gripper has stopped moving
-		 *  \return True is the gripper reached the target position, false otherwise
+		 *  \brief Stores a reading of graspToForce() in the trace (the oldest one is overwritten if the trace is full)
 		 */
-		bool waitUntilFinished();
+		void recordGraspSample(unsigned long time, float current, int16_t pwm);
 		
 		/**
 		 *  \brief Prints a message and return false if the function is not implemented for this gripper-type
@@ -225,6 +310,13 @@ class gripper {
 		float _closingWidthOffset;	//!< If gripper is completely closed, it has this gripping width
 		float _tcpOffset[3];	//!< Position of the TCP (tool center point) with respect to the center of the flange of the last robot axis
 		int8_t _servoID;		//!< ID of the smart-servo
+		grasp_trace_type _graspTrace;	//!< Readings of the last call of graspToForce()
+		bool _isMoving;				//!< True if a movement has been started and isFinished() has not detected its end yet
+		bool _moveSucceeded;		//!< False if the last movement ended with a timeout
+		long _targetAngle;			//!< Goal of the current movement (motor-angle)
+		long _lastPollAngle;		//!< Angle of the last reading while the movement is checked
+		unsigned long _moveStartTime;	//!< Start of the current movement (millis())
+		unsigned long _lastPollTime;	//!< Time of the last reading while the movement is checked (millis())
 };
 
 class binaryEEF {
@@ -256,6 +348,18 @@ class binaryEEF {
 		 *  \return Returns false if the eef is activate, true otherwise
 		 */
 		bool isDeactivated();
+		
+		/**
+		 *  \brief Activates the endeffector given as argument (callback for a pathTrigger)
+		 *  \param [in] eef Pointer to the binaryEEF
+		 */
+		static void activateTrigger(void* eef);
+		
+		/**
+		 *  \brief Deactivates the endeffector given as argument (callback for a pathTrigger)
+		 *  \param [in] eef Pointer to the binaryEEF
+		 */
+		static void deactivateTrigger(void* eef);
 	private:
 		int8_t _pin;					//!< Pin to which the endeffector (relais) is connected to
 		bool _isActive = false;			//!< True if eef is activated, false otherwise
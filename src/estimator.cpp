@@ -0,0 +1,128 @@
+/**
+ *  \class 	jointStateEstimator
+ *  \brief 	Alpha-beta filter which estimates angle and velocity of one joint between sparse readings from the bus
+ *  @file 	estimator.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		jointStateEstimator();
+			void reset();
+			void setGains(float alpha, float beta, float speedGain);
+			void setCommandedVelocity(float velocity, unsigned long time);
+			void clearCommandedVelocity(unsigned long time);
+			void updateAngle(float angle, unsigned long time);
+			void updateVelocity(float velocity, unsigned long time);
+			joint_estimate_type getEstimate(unsigned long time);
+			bool isValid();
+		private:
+			void predict(unsigned long time, float* angle, float* velocity);
+ */
+
+#include "estimator.h"
+
+jointStateEstimator::jointStateEstimator(){
+	_alpha = ESTIMATOR_ALPHA;
+	_beta = ESTIMATOR_BETA;
+	_speedGain = ESTIMATOR_SPEED_GAIN;
+	reset();
+}
+
+void jointStateEstimator::reset(){
+	_angle = 0;
+	_velocity = 0;
+	_time = 0;
+	_lastReading = 0;
+	_commandedVelocity = 0;
+	_hasCommand = false;
+	_valid = false;
+}
+
+void jointStateEstimator::setGains(float alpha, float beta, float speedGain){
+	_alpha = alpha;
+	_beta = beta;
+	_speedGain = speedGain;
+}
+
+void jointStateEstimator::setCommandedVelocity(float velocity, unsigned long time){
+	if (_valid) {
+		predict(time, &_angle, &_velocity);
+		_time = time;
+	}
+	_commandedVelocity = velocity;
+	_hasCommand = true;
+}
+
+void jointStateEstimator::clearCommandedVelocity(unsigned long time){
+	if (_valid) {
+		predict(time, &_angle, &_velocity);
+		_time = time;
+	}
+	_hasCommand = false;
+}
+
+void jointStateEstimator::updateAngle(float angle, unsigned long time){
+	if (!_valid) {
+		_angle = angle;
+		_velocity = _hasCommand ? _commandedVelocity : 0;
+		_time = time;
+		_lastReading = time;
+		_valid = true;
+		return;
+	}
+
+	float predictedAngle, predictedVelocity;
+	predict(time, &predictedAngle, &predictedVelocity);
+	float residual = angle - predictedAngle;
+	float dt = (time - _lastReading) / 1000000.0;
+	if (dt < ESTIMATOR_MIN_DT) dt = ESTIMATOR_MIN_DT;
+
+	_angle = predictedAngle + _alpha * residual;
+	_velocity = predictedVelocity + _beta * residual / dt;
+	_time = time;
+	_lastReading = time;
+}
+
+void jointStateEstimator::updateVelocity(float velocity, unsigned long time){
+	if (!_valid) return;
+	predict(time, &_angle, &_velocity);
+	_velocity += _speedGain * (velocity - _velocity);
+	_time = time;
+}
+
+joint_estimate_type jointStateEstimator::getEstimate(unsigned long time){
+	joint_estimate_type estimate;
+	predict(time, &estimate.angle, &estimate.velocity);
+	estimate.time = time;
+	estimate.age = time - _lastReading;
+	return estimate;
+}
+
+bool jointStateEstimator::isValid(){
+	return _valid;
+}
+
+/* PRIVATE */
+void jointStateEstimator::predict(unsigned long time, float* angle, float* velocity){
+	// Without new readings the velocity is not trusted forever
+	unsigned long horizon = _lastReading + (unsigned long)(ESTIMATOR_MAX_EXTRAPOLATION * 1000000);
+	if ((long)(time - horizon) > 0) time = horizon;
+	float dt = (long)(time - _time) / 1000000.0;
+	if (!_valid || dt <= 0) {
+		*angle = _angle;
+		*velocity = _velocity;
+		return;
+	}
+
+	if (!_hasCommand) {
+		*angle = _angle + _velocity * dt;
+		*velocity = _velocity;
+		return;
+	}
+
+	// First order lag towards the commanded velocity
+	float decay = exp(-dt / ESTIMATOR_TIME_CONSTANT);
+	float difference = _velocity - _commandedVelocity;
+	*velocity = _commandedVelocity + difference * decay;
+	*angle = _angle + _commandedVelocity * dt + difference * ESTIMATOR_TIME_CONSTANT * (1 - decay);
+}
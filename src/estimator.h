@@ -0,0 +1,126 @@
+/**
+ *  \class 	jointStateEstimator
+ *  \brief 	Alpha-beta filter which estimates angle and velocity of one joint between sparse readings from the bus
+ *  @file 	estimator.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		jointStateEstimator();
+			void reset();
+			void setGains(float alpha, float beta, float speedGain);
+			void setCommandedVelocity(float velocity, unsigned long time);
+			void clearCommandedVelocity(unsigned long time);
+			void updateAngle(float angle, unsigned long time);
+			void updateVelocity(float velocity, unsigned long time);
+			joint_estimate_type getEstimate(unsigned long time);
+			bool isValid();
+		private:
+			void predict(unsigned long time, float* angle, float* velocity);
+ *  \par Model:
+ *  	Between readings the joint moves with the estimated velocity. The angle is extrapolated at most ESTIMATOR_MAX_EXTRAPOLATION after the last reading.
+ *  	If a velocity is commanded (e.g. PWM movements) the estimated velocity approaches the commanded velocity with the time constant ESTIMATOR_TIME_CONSTANT.
+ *  	Angle readings correct angle (alpha) and velocity (beta), speed readings correct the velocity (speedGain).
+ *  	All times are given in microseconds (micros()), angles in degrees and velocities in degrees per second.
+ */
+
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+#include <Arduino.h>
+
+#define ESTIMATOR_ALPHA				0.5		//!< Default gain of angle readings on the angle
+#define ESTIMATOR_BETA				0.1		//!< Default gain of angle readings on the velocity
+#define ESTIMATOR_SPEED_GAIN		0.5		//!< Default gain of speed readings on the velocity
+#define ESTIMATOR_TIME_CONSTANT		0.1		//!< Time constant in s in which a motor follows a commanded velocity
+#define ESTIMATOR_MIN_DT			0.001	//!< Minimum time in s between two readings used to correct the velocity
+#define ESTIMATOR_MAX_EXTRAPOLATION	0.25	//!< Maximum time in s after the last reading the angle is extrapolated with the velocity
+
+typedef struct {
+	float angle;			//!< Estimated angle in degrees
+	float velocity;			//!< Estimated velocity in degrees per second
+	unsigned long time;		//!< Time of the estimate (micros())
+	unsigned long age;		//!< Time in us since the last angle reading
+} joint_estimate_type;
+
+class jointStateEstimator {
+	public:
+		/**
+		 *  \brief Constructor of jointStateEstimator class
+		 */
+		jointStateEstimator();
+
+		/**
+		 *  \brief Drops the estimate, the next angle reading initializes it again
+		 */
+		void reset();
+
+		/**
+		 *  \brief Sets the gains of the filter
+		 *  \param [in] alpha Gain of angle readings on the angle (0..1)
+		 *  \param [in] beta Gain of angle readings on the velocity (0..1)
+		 *  \param [in] speedGain Gain of speed readings on the velocity (0..1)
+		 */
+		void setGains(float alpha, float beta, float speedGain);
+
+		/**
+		 *  \brief Sets the velocity the motor has been commanded to (e.g. by a PWM value)
+		 *  \param [in] velocity Commanded velocity in degrees per second
+		 *  \param [in] time Time of the command (micros())
+		 */
+		void setCommandedVelocity(float velocity, unsigned long time);
+
+		/**
+		 *  \brief Removes the commanded velocity (e.g. for position controlled movements). The estimate continues with the estimated velocity.
+		 *  \param [in] time Time of the command (micros())
+		 */
+		void clearCommandedVelocity(unsigned long time);
+
+		/**
+		 *  \brief Corrects the estimate with an angle reading
+		 *  \param [in] angle Angle read from the motor in degrees
+		 *  \param [in] time Time of the reading (micros())
+		 */
+		void updateAngle(float angle, unsigned long time);
+
+		/**
+		 *  \brief Corrects the estimate with a speed reading
+		 *  \param [in] velocity Velocity read from the motor in degrees per second
+		 *  \param [in] time Time of the reading (micros())
+		 */
+		void updateVelocity(float velocity, unsigned long time);
+
+		/**
+		 *  \brief Returns the estimated state at a given time. Does not change the filter.
+		 *  \param [in] time Time to get the estimate for (micros())
+		 *  \return Estimated angle and velocity with timestamp
+		 */
+		joint_estimate_type getEstimate(unsigned long time);
+
+		/**
+		 *  \brief Checks if the estimate has been initialized by an angle reading
+		 */
+		bool isValid();
+
+	private:
+		/**
+		 *  \brief Predicts angle and velocity at a given time from the current state
+		 *  \param [in] time Time to predict the state for (micros())
+		 *  \param [out] angle Predicted angle
+		 *  \param [out] velocity Predicted velocity
+		 */
+		void predict(unsigned long time, float* angle, float* velocity);
+
+		float _angle;					//!< Estimated angle at _time
+		float _velocity;				//!< Estimated velocity at _time
+		unsigned long _time;			//!< Time of the current state
+		unsigned long _lastReading;		//!< Time of the last angle reading
+		float _commandedVelocity;		//!< Commanded velocity (only used if _hasCommand is true)
+		bool _hasCommand;				//!< True if a velocity is commanded
+		bool _valid;					//!< True after the first angle reading
+		float _alpha;					//!< Gain of angle readings on the angle
+		float _beta;					//!< Gain of angle readings on the velocity
+		float _speedGain;				//!< Gain of speed readings on the velocity
+};
+
+#endif
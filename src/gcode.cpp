@@ -0,0 +1,454 @@
+/**
+ *  \class 	gcodeInterpreter
+ *  \brief 	Streaming G-code interpreter with lookahead buffer for morobots with pens or dispensing tools
+ *  @file 	gcode.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		gcodeInterpreter(morobotClass* morobotToControl, binaryEEF* tool=NULL);
+			void begin(Stream* stream);
+			void update();
+			bool isIdle();
+			uint8_t getNumBufferedBlocks();
+			void setResolution(float resolution);
+			void setAcceleration(float acceleration);
+		private:
+			void readInput();
+			bool parseLine(char* line);
+			bool queueBlock(gcode_block_type* block, const float startDir[3], const float endDir[3]);
+			void recalculatePlan();
+			void execute();
+			void waitUntilFinished();
+			void startBlock();
+			void stepBlock();
+			void finishBlock();
+			float getSpeedAt(gcode_block_type* block, float s, float exitSpeed);
+			void getPointAt(gcode_block_type* block, float s, float point[3]);
+			uint8_t nextIndex(uint8_t index);
+			bool reportError(const __FlashStringHelper* message);
+ */
+
+#include "gcode.h"
+
+gcodeInterpreter::gcodeInterpreter(morobotClass* morobotToControl, binaryEEF* tool){
+	_morobot = morobotToControl;
+	_tool = tool;
+	_stream = NULL;
+	_lineLength = 0;
+	_lineOverflow = false;
+	_tail = 0;
+	_count = 0;
+	_absolute = true;
+	_feed = GCODE_DEFAULT_FEED / 60.0;
+	_resolution = GCODE_RESOLUTION;
+	_acceleration = GCODE_ACCELERATION;
+	_blockActive = false;
+	_speed = 0;
+	for (uint8_t i=0; i<3; i++) {
+		_position[i] = 0;
+		_blockStart[i] = 0;
+		_lastExitDir[i] = 0;
+	}
+}
+
+void gcodeInterpreter::begin(Stream* stream){
+	_stream = stream;
+	_position[0] = _morobot->getActPosition('x');
+	_position[1] = _morobot->getActPosition('y');
+	_position[2] = _morobot->getActPosition('z');
+	for (uint8_t i=0; i<3; i++) _blockStart[i] = _position[i];
+	_nextPointTime = micros();
+}
+
+void gcodeInterpreter::update(){
+	readInput();
+	execute();
+}
+
+bool gcodeInterpreter::isIdle(){
+	return _count == 0 && !_blockActive;
+}
+
+uint8_t gcodeInterpreter::getNumBufferedBlocks(){
+	return _count;
+}
+
+void gcodeInterpreter::setResolution(float resolution){
+	if (resolution > 0) _resolution = resolution;
+}
+
+void gcodeInterpreter::setAcceleration(float acceleration){
+	if (acceleration > 0) _acceleration = acceleration;
+}
+
+/* PRIVATE */
+void gcodeInterpreter::readInput(){
+	// Only read as long as there is space for a block, the host waits for the "ok"
+	while (_count < GCODE_BUFFER_SIZE && _stream->available() > 0) {
+		char c = _stream->read();
+		if (c == '\n' || c == '\r') {
+			if (_lineOverflow) reportError(F("line too long"));
+			else if (_lineLength > 0) {
+				_line[_lineLength] = '\0';
+				if (parseLine(_line) == true) _stream->println(F("ok"));
+			}
+			_lineLength = 0;
+			_lineOverflow = false;
+		} else if (_lineLength < GCODE_LINE_LENGTH-1) {
+			_line[_lineLength++] = c;
+		} else {
+			_lineOverflow = true;
+		}
+	}
+}
+
+bool gcodeInterpreter::parseLine(char* line){
+	// Split the line into words (letter + number), ignore comments and checksums
+	float value[26];
+	uint32_t seen = 0;
+	char* p = line;
+	while (*p != '\0') {
+		char letter = toupper(*p);
+		if (letter == ';' || letter == '*') break;
+		if (letter == '(') {
+			while (*p != '\0' && *p != ')') p++;
+			if (*p != '\0') p++;
+			continue;
+		}
+		if (letter == ' ' || letter == '\t') {
+			p++;
+			continue;
+		}
+		if (letter < 'A' || letter > 'Z') return reportError(F("invalid character"));
+		char* end;
+		float v = strtod(p+1, &end);
+		if (end == p+1) return reportError(F("missing value"));
+		value[letter-'A'] = v;
+		seen |= 1UL << (letter-'A');
+		p = end;
+	}
+	#define HAS(letter) ((seen & (1UL << ((letter)-'A'))) != 0)
+	#define VALUE(letter) value[(letter)-'A']
+
+	if (HAS('F')) {
+		if (VALUE('F') <= 0) return reportError(F("invalid feed rate"));
+		_feed = VALUE('F') / 60.0;
+	}
+	if (HAS('G') && HAS('M')) return reportError(F("only one G or M command per line"));
+
+	gcode_block_type block;
+	block.length = 0;
+	block.nominalSpeed = 0;
+	block.sweep = 0;
+	block.dwell = 0;
+	for (uint8_t i=0; i<3; i++) block.target[i] = _position[i];
+	float startDir[3] = {0, 0, 0};
+	float endDir[3] = {0, 0, 0};
+
+	if (HAS('G')) {
+		int code = (int)VALUE('G');
+		switch (code) {
+			case 0:
+			case 1:
+			case 2:
+			case 3: {
+				const char axes[3] = {'X', 'Y', 'Z'};
+				for (uint8_t i=0; i<3; i++) {
+					if (!HAS(axes[i])) continue;
+					if (_absolute) block.target[i] = VALUE(axes[i]);
+					else block.target[i] = _position[i] + VALUE(axes[i]);
+				}
+				float delta[3];
+				for (uint8_t i=0; i<3; i++) delta[i] = block.target[i] - _position[i];
+
+				if (code == 0) {
+					block.type = GCODE_BLOCK_RAPID;
+				} else if (code == 1) {
+					block.type = GCODE_BLOCK_LINEAR;
+					block.length = sqrt(delta[0]*delta[0] + delta[1]*delta[1] + delta[2]*delta[2]);
+					if (block.length < 0.01) return true;	// Nothing to do
+					for (uint8_t i=0; i<3; i++) {
+						startDir[i] = delta[i] / block.length;
+						endDir[i] = startDir[i];
+					}
+				} else {
+					if (HAS('R')) return reportError(F("arcs with R are not supported, use I/J"));
+					if (!HAS('I') && !HAS('J')) return reportError(F("arc without I/J"));
+					block.type = (code == 2) ? GCODE_BLOCK_ARC_CW : GCODE_BLOCK_ARC_CCW;
+					block.center[0] = _position[0] + (HAS('I') ? VALUE('I') : 0);
+					block.center[1] = _position[1] + (HAS('J') ? VALUE('J') : 0);
+					float radius = hypot(_position[0]-block.center[0], _position[1]-block.center[1]);
+					float endRadius = hypot(block.target[0]-block.center[0], block.target[1]-block.center[1]);
+					if (radius < 0.01 || fabs(radius-endRadius) > 0.5) return reportError(F("invalid arc"));
+
+					// Angle of the arc, start == end is a full circle
+					float startAngle = atan2(_position[1]-block.center[1], _position[0]-block.center[0]);
+					float endAngle = atan2(block.target[1]-block.center[1], block.target[0]-block.center[0]);
+					block.sweep = endAngle - startAngle;
+					if (block.type == GCODE_BLOCK_ARC_CW && block.sweep >= -1e-6) block.sweep -= 2*M_PI;
+					if (block.type == GCODE_BLOCK_ARC_CCW && block.sweep <= 1e-6) block.sweep += 2*M_PI;
+
+					float arcLength = fabs(block.sweep) * radius;
+					block.length = sqrt(arcLength*arcLength + delta[2]*delta[2]);
+					// Tangents at the start and the end of the arc
+					float sign = (block.sweep > 0) ? 1 : -1;
+					float xyFactor = sign * arcLength / block.length;
+					startDir[0] = -sin(startAngle) * xyFactor;
+					startDir[1] = cos(startAngle) * xyFactor;
+					endDir[0] = -sin(startAngle+block.sweep) * xyFactor;
+					endDir[1] = cos(startAngle+block.sweep) * xyFactor;
+					startDir[2] = delta[2] / block.length;
+					endDir[2] = startDir[2];
+				}
+				if (block.length > 0) block.nominalSpeed = _feed;
+				break;
+			}
+			case 4:
+				block.type = GCODE_BLOCK_DWELL;
+				if (HAS('P')) block.dwell = VALUE('P');
+				else if (HAS('S')) block.dwell = VALUE('S') * 1000;
+				break;
+			case 28:
+				waitUntilFinished();
+				_morobot->moveHome();
+				_position[0] = _morobot->getActPosition('x');
+				_position[1] = _morobot->getActPosition('y');
+				_position[2] = _morobot->getActPosition('z');
+				for (uint8_t i=0; i<3; i++) _blockStart[i] = _position[i];
+				return true;
+			case 90:
+				_absolute = true;
+				return true;
+			case 91:
+				_absolute = false;
+				return true;
+			default:
+				return reportError(F("unsupported G command"));
+		}
+	} else if (HAS('M')) {
+		int code = (int)VALUE('M');
+		switch (code) {
+			case 3:
+			case 4:
+			case 5:
+				if (_tool == NULL) return reportError(F("no tool attached"));
+				block.type = (code == 5) ? GCODE_BLOCK_TOOL_OFF : GCODE_BLOCK_TOOL_ON;
+				break;
+			case 17:
+				block.type = GCODE_BLOCK_BREAKS_ON;
+				break;
+			case 18:
+			case 84:
+				block.type = GCODE_BLOCK_BREAKS_OFF;
+				break;
+			case 114:
+				_stream->print(F("X:"));
+				_stream->print(_position[0]);
+				_stream->print(F(" Y:"));
+				_stream->print(_position[1]);
+				_stream->print(F(" Z:"));
+				_stream->println(_position[2]);
+				return true;
+			case 400:
+				waitUntilFinished();
+				return true;
+			default:
+				return reportError(F("unsupported M command"));
+		}
+	} else {
+		return true;	// Empty line, comment or only F
+	}
+	#undef HAS
+	#undef VALUE
+
+	if (queueBlock(&block, startDir, endDir) == false) return reportError(F("buffer full"));
+	for (uint8_t i=0; i<3; i++) _position[i] = block.target[i];
+	return true;
+}
+
+bool gcodeInterpreter::queueBlock(gcode_block_type* block, const float startDir[3], const float endDir[3]){
+	if (_count >= GCODE_BUFFER_SIZE) return false;
+
+	// Speed at the junction with the previous block depends on the change of direction
+	block->maxEntrySpeed = 0;
+	if (_count > 0 && block->length > 0) {
+		gcode_block_type* previous = &_blocks[(_tail + _count - 1) % GCODE_BUFFER_SIZE];
+		if (previous->length > 0) {
+			float cosAngle = _lastExitDir[0]*startDir[0] + _lastExitDir[1]*startDir[1] + _lastExitDir[2]*startDir[2];
+			if (cosAngle > 1) cosAngle = 1;
+			else if (cosAngle < -1) cosAngle = -1;
+			float angle = acos(cosAngle) * 180.0 / M_PI;
+			if (angle < GCODE_JUNCTION_ANGLE) {
+				block->maxEntrySpeed = min(block->nominalSpeed, previous->nominalSpeed) * (1 - angle/GCODE_JUNCTION_ANGLE);
+			}
+		}
+	}
+	block->entrySpeed = 0;
+
+	_blocks[(_tail + _count) % GCODE_BUFFER_SIZE] = *block;
+	_count++;
+	for (uint8_t i=0; i<3; i++) _lastExitDir[i] = endDir[i];
+
+	recalculatePlan();
+	return true;
+}
+
+void gcodeInterpreter::recalculatePlan(){
+	if (_count == 0) return;
+
+	// Backward pass: the robot must be able to stop at the end of the newest block. The entry speed of the active block is fixed.
+	float nextEntrySpeed = 0;
+	uint8_t first = _blockActive ? 1 : 0;
+	for (int8_t i=_count-1; i>=first; i--) {
+		gcode_block_type* block = &_blocks[(_tail + i) % GCODE_BUFFER_SIZE];
+		float maxSpeed = sqrt(nextEntrySpeed*nextEntrySpeed + 2*_acceleration*block->length);
+		block->entrySpeed = min(block->maxEntrySpeed, maxSpeed);
+		nextEntrySpeed = block->entrySpeed;
+	}
+
+	// Forward pass: every entry speed must be reachable from the entry speed of the previous block
+	for (uint8_t i=1; i<_count; i++) {
+		gcode_block_type* previous = &_blocks[(_tail + i - 1) % GCODE_BUFFER_SIZE];
+		gcode_block_type* block = &_blocks[(_tail + i) % GCODE_BUFFER_SIZE];
+		float maxSpeed = sqrt(previous->entrySpeed*previous->entrySpeed + 2*_acceleration*previous->length);
+		if (block->entrySpeed > maxSpeed) block->entrySpeed = maxSpeed;
+	}
+}
+
+void gcodeInterpreter::execute(){
+	if (!_blockActive) {
+		if (_count == 0) return;
+		startBlock();
+	}
+	stepBlock();
+}
+
+void gcodeInterpreter::waitUntilFinished(){
+	while (!isIdle()) execute();
+	_morobot->waitUntilIsReady();
+}
+
+void gcodeInterpreter::startBlock(){
+	gcode_block_type* block = &_blocks[_tail];
+	_blockActive = true;
+	_blockPos = 0;
+	if (block->entrySpeed <= 0) _nextPointTime = micros();
+	recalculatePlan();
+
+	switch (block->type) {
+		case GCODE_BLOCK_RAPID:
+			if (_morobot->moveToPose(block->target[0], block->target[1], block->target[2]) == false) {
+				reportError(F("position not reachable"));
+				for (uint8_t i=0; i<3; i++) block->target[i] = _blockStart[i];
+			}
+			break;
+		case GCODE_BLOCK_DWELL:
+			_morobot->waitUntilIsReady();
+			_nextPointTime = micros() + (unsigned long)block->dwell * 1000;
+			break;
+		case GCODE_BLOCK_TOOL_ON:
+			_tool->activate();
+			break;
+		case GCODE_BLOCK_TOOL_OFF:
+			_tool->deactivate();
+			break;
+		case GCODE_BLOCK_BREAKS_ON:
+			_morobot->setBreaks();
+			break;
+		case GCODE_BLOCK_BREAKS_OFF:
+			_morobot->releaseBreaks();
+			break;
+	}
+}
+
+void gcodeInterpreter::stepBlock(){
+	if ((long)(micros() - _nextPointTime) < 0) return;
+
+	gcode_block_type* block = &_blocks[_tail];
+	if (_blockPos >= block->length) {
+		finishBlock();
+		return;
+	}
+
+	// Distribute the remaining distance evenly on points which are at most _resolution apart
+	float remaining = block->length - _blockPos;
+	float ds = remaining / ceil(remaining / _resolution);
+	float exitSpeed = (_count > 1) ? _blocks[nextIndex(_tail)].entrySpeed : 0;
+	_speed = getSpeedAt(block, _blockPos + ds/2, exitSpeed);
+	_blockPos += ds;
+	if (block->length - _blockPos < 0.001) _blockPos = block->length;
+
+	float point[3];
+	getPointAt(block, _blockPos, point);
+	if (_morobot->moveToPoseTimed(point[0], point[1], point[2], ds/_speed) == false) {
+		// Drop all buffered blocks, the host has to send the path again
+		reportError(F("position not reachable"));
+		_morobot->waitUntilIsReady();
+		for (uint8_t i=0; i<3; i++) {
+			_position[i] = _morobot->getActPosition('x'+i);
+			_blockStart[i] = _position[i];
+		}
+		_count = 0;
+		_blockActive = false;
+		_speed = 0;
+		return;
+	}
+	_nextPointTime += (unsigned long)(ds / _speed * 1000000.0);
+}
+
+void gcodeInterpreter::finishBlock(){
+	gcode_block_type* block = &_blocks[_tail];
+	bool chainable = block->length > 0;
+	bool moved = chainable || block->type == GCODE_BLOCK_RAPID;
+	for (uint8_t i=0; i<3; i++) _blockStart[i] = block->target[i];
+	_tail = nextIndex(_tail);
+	_count--;
+	_blockActive = false;
+
+	if (chainable && _count > 0 && _blocks[_tail].entrySpeed > 0) {
+		// Continue with the next block without stopping, it can not start faster than the robot moves at the moment
+		if (_blocks[_tail].entrySpeed > _speed) _blocks[_tail].entrySpeed = _speed;
+	} else {
+		if (moved) _morobot->waitUntilIsReady();
+		_nextPointTime = micros();
+		_speed = 0;
+		if (_count > 0) _blocks[_tail].entrySpeed = 0;
+	}
+}
+
+float gcodeInterpreter::getSpeedAt(gcode_block_type* block, float s, float exitSpeed){
+	float speed = block->nominalSpeed;
+	float accelerating = sqrt(block->entrySpeed*block->entrySpeed + 2*_acceleration*s);
+	float decelerating = sqrt(exitSpeed*exitSpeed + 2*_acceleration*(block->length - s));
+	if (accelerating < speed) speed = accelerating;
+	if (decelerating < speed) speed = decelerating;
+	if (speed < GCODE_MIN_SPEED) speed = GCODE_MIN_SPEED;
+	return speed;
+}
+
+void gcodeInterpreter::getPointAt(gcode_block_type* block, float s, float point[3]){
+	float fraction = s / block->length;
+	if (block->type == GCODE_BLOCK_LINEAR) {
+		for (uint8_t i=0; i<3; i++) point[i] = _blockStart[i] + (block->target[i] - _blockStart[i]) * fraction;
+	} else {
+		float radius = hypot(_blockStart[0]-block->center[0], _blockStart[1]-block->center[1]);
+		float angle = atan2(_blockStart[1]-block->center[1], _blockStart[0]-block->center[0]) + block->sweep * fraction;
+		point[0] = block->center[0] + radius * cos(angle);
+		point[1] = block->center[1] + radius * sin(angle);
+		point[2] = _blockStart[2] + (block->target[2] - _blockStart[2]) * fraction;
+	}
+	if (fraction >= 1) {
+		for (uint8_t i=0; i<3; i++) point[i] = block->target[i];
+	}
+}
+
+uint8_t gcodeInterpreter::nextIndex(uint8_t index){
+	return (index + 1) % GCODE_BUFFER_SIZE;
+}
+
+bool gcodeInterpreter::reportError(const __FlashStringHelper* message){
+	_stream->print(F("error: "));
+	_stream->println(message);
+	return false;
+}
@@ -0,0 +1,226 @@
+/**
+ *  \class 	gcodeInterpreter
+ *  \brief 	Streaming G-code interpreter with lookahead buffer for morobots with pens or dispensing tools
+ *  @file 	gcode.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		gcodeInterpreter(morobotClass* morobotToControl, binaryEEF* tool=NULL);
+			void begin(Stream* stream);
+			void update();
+			bool isIdle();
+			uint8_t getNumBufferedBlocks();
+			void setResolution(float resolution);
+			void setAcceleration(float acceleration);
+		private:
+			void readInput();
+			bool parseLine(char* line);
+			bool queueBlock(gcode_block_type* block, const float startDir[3], const float endDir[3]);
+			void recalculatePlan();
+			void execute();
+			void waitUntilFinished();
+			void startBlock();
+			void stepBlock();
+			void finishBlock();
+			float getSpeedAt(gcode_block_type* block, float s, float exitSpeed);
+			void getPointAt(gcode_block_type* block, float s, float point[3]);
+			uint8_t nextIndex(uint8_t index);
+			bool reportError(const __FlashStringHelper* message);
+ *  \par Supported G-code:
+ *  	G0 (rapid, joint interpolated), G1 (linear), G2/G3 (arc in XY-plane with I/J center offsets, optional Z for helix),
+ *  	G4 (dwell, P in ms or S in s), G28 (home), G90/G91 (absolute/relative), F (feed rate in mm/min),
+ *  	M3/M4 (tool on), M5 (tool off), M17 (set breaks), M18/M84 (release breaks), M114 (report programmed position), M400 (wait until finished).
+ *  	G28 and M400 are executed synchronously: the answer is sent after all buffered blocks have been executed.
+ *  \par Flow control:
+ *  	Each line is answered with "ok" as soon as it has been stored in the lookahead buffer (or "error: ..." if it is invalid).
+ *  	While the buffer is full no further lines are read, so the host may send the next line whenever it receives an "ok".
+ *  	With GCODE_BUFFER_SIZE blocks in the buffer the planner can chain segments without stopping.
+ */
+
+#ifndef GCODE_H
+#define GCODE_H
+
+#include "morobot.h"
+
+#define GCODE_BUFFER_SIZE		8		//!< Number of blocks in the lookahead buffer
+#define GCODE_LINE_LENGTH		64		//!< Maximum length of one line of G-code
+#define GCODE_DEFAULT_FEED		1200	//!< Default feed rate in mm/min
+#define GCODE_MIN_SPEED			2.0		//!< Minimum planned speed in mm/s (the robot does not crawl at the start/end of a path)
+#define GCODE_JUNCTION_ANGLE	30.0	//!< Maximum change of direction in degrees between two blocks which are executed without stopping
+#define GCODE_RESOLUTION		2.0		//!< Default distance between interpolated points in mm
+#define GCODE_ACCELERATION		200.0	//!< Default path acceleration in mm/s^2
+
+#define GCODE_BLOCK_RAPID		0		//!< G0
+#define GCODE_BLOCK_LINEAR		1		//!< G1
+#define GCODE_BLOCK_ARC_CW		2		//!< G2
+#define GCODE_BLOCK_ARC_CCW		3		//!< G3
+#define GCODE_BLOCK_DWELL		4		//!< G4
+#define GCODE_BLOCK_TOOL_ON		5		//!< M3/M4
+#define GCODE_BLOCK_TOOL_OFF	6		//!< M5
+#define GCODE_BLOCK_BREAKS_ON	7		//!< M17
+#define GCODE_BLOCK_BREAKS_OFF	8		//!< M18/M84
+
+typedef struct {
+	uint8_t type;			//!< Type of block (GCODE_BLOCK_...)
+	float target[3];		//!< End position of the block in mm
+	float center[2];		//!< Center of an arc (absolute x, y)
+	float sweep;			//!< Angle of an arc in radians (negative for clockwise arcs)
+	float length;			//!< Length of the path in mm (0 for blocks without movement)
+	float nominalSpeed;		//!< Programmed feed rate in mm/s
+	float maxEntrySpeed;	//!< Maximum speed at the junction with the previous block in mm/s
+	float entrySpeed;		//!< Planned speed at the start of the block in mm/s
+	uint16_t dwell;			//!< Dwell time in ms
+} gcode_block_type;
+
+class gcodeInterpreter {
+	public:
+		/**
+		 *  \brief Constructor of gcodeInterpreter class
+		 *  \param [in] morobotToControl Pointer to the morobot which executes the G-code
+		 *  \param [in] tool (Optional) Binary endeffector (pen-lifter, dispenser, laser, ...) switched by M3/M4/M5
+		 */
+		gcodeInterpreter(morobotClass* morobotToControl, binaryEEF* tool=NULL);
+
+		/**
+		 *  \brief Starts the interpreter. The morobot must already be started (begin()).
+		 *  \param [in] stream Stream the G-code is received from and the answers are sent to (e.g. &Serial)
+		 */
+		void begin(Stream* stream);
+
+		/**
+		 *  \brief Reads new lines and executes the buffered blocks. Call this function as often as possible (e.g. in loop()).
+		 *  \details The function does not block while a linear or circular block is executed.
+		 */
+		void update();
+
+		/**
+		 *  \brief Checks if all received blocks have been executed
+		 *  \return Returns true if the buffer is empty and no block is executed at the moment
+		 */
+		bool isIdle();
+
+		/**
+		 *  \brief Returns the number of blocks in the lookahead buffer (including the block executed at the moment)
+		 */
+		uint8_t getNumBufferedBlocks();
+
+		/**
+		 *  \brief Sets the distance between interpolated points
+		 *  \param [in] resolution Distance in mm
+		 */
+		void setResolution(float resolution);
+
+		/**
+		 *  \brief Sets the acceleration used by the planner
+		 *  \param [in] acceleration Acceleration in mm/s^2
+		 */
+		void setAcceleration(float acceleration);
+
+	private:
+		/**
+		 *  \brief Reads characters from the stream until a line is complete or the buffer is full
+		 */
+		void readInput();
+
+		/**
+		 *  \brief Parses a line of G-code and stores the resulting block(s) in the buffer
+		 *  \param [in] line Line to parse (changed by the function)
+		 *  \return Returns true if the line is valid
+		 */
+		bool parseLine(char* line);
+
+		/**
+		 *  \brief Stores a block in the buffer and recalculates the planned speeds
+		 *  \param [in] block Block to store
+		 *  \param [in] startDir Direction of movement at the start of the block (unit vector, zero for blocks without movement)
+		 *  \param [in] endDir Direction of movement at the end of the block
+		 *  \return Returns true if the block has been stored
+		 */
+		bool queueBlock(gcode_block_type* block, const float startDir[3], const float endDir[3]);
+
+		/**
+		 *  \brief Calculates the entry speeds of all buffered blocks so the robot can always stop at the end of the buffer
+		 */
+		void recalculatePlan();
+
+		/**
+		 *  \brief Starts the next block or continues the active one
+		 */
+		void execute();
+
+		/**
+		 *  \brief Executes all buffered blocks and waits until the robot stopped
+		 */
+		void waitUntilFinished();
+
+		/**
+		 *  \brief Starts the execution of the oldest block in the buffer
+		 */
+		void startBlock();
+
+		/**
+		 *  \brief Sends the next interpolated point of the active block if it is due
+		 */
+		void stepBlock();
+
+		/**
+		 *  \brief Finishes the active block and removes it from the buffer. Waits for the robot to stop if the next block can not be chained.
+		 */
+		void finishBlock();
+
+		/**
+		 *  \brief Returns the planned speed at a given distance from the start of a block
+		 *  \param [in] block Block to get the speed of
+		 *  \param [in] s Distance from the start of the block in mm
+		 *  \param [in] exitSpeed Planned speed at the end of the block
+		 */
+		float getSpeedAt(gcode_block_type* block, float s, float exitSpeed);
+
+		/**
+		 *  \brief Calculates the point on the path of the active block at a given distance from its start
+		 *  \param [in] block Block to get the point of
+		 *  \param [in] s Distance from the start of the block in mm
+		 *  \param [out] point Calculated point
+		 */
+		void getPointAt(gcode_block_type* block, float s, float point[3]);
+
+		/**
+		 *  \brief Returns the following index in the ring buffer
+		 */
+		uint8_t nextIndex(uint8_t index);
+
+		/**
+		 *  \brief Sends an error message to the host
+		 *  \param [in] message Error message
+		 *  \return Returns always false
+		 */
+		bool reportError(const __FlashStringHelper* message);
+
+		morobotClass* _morobot;			//!< Robot executing the G-code
+		binaryEEF* _tool;				//!< Tool switched by M3/M4/M5 (may be NULL)
+		Stream* _stream;				//!< Stream to read G-code from and send answers to
+
+		char _line[GCODE_LINE_LENGTH];	//!< Line received at the moment
+		uint8_t _lineLength;			//!< Number of characters in _line
+		bool _lineOverflow;				//!< True if the current line is too long
+
+		gcode_block_type _blocks[GCODE_BUFFER_SIZE];	//!< Lookahead buffer
+		uint8_t _tail;					//!< Index of the oldest block (executed at the moment if _blockActive)
+		uint8_t _count;					//!< Number of blocks in the buffer
+		float _lastExitDir[3];			//!< Direction at the end of the newest block in the buffer
+
+		bool _absolute;					//!< True for absolute positions (G90), false for relative positions (G91)
+		float _feed;					//!< Current feed rate in mm/s
+		float _position[3];				//!< Programmed position at the end of the newest block
+		float _resolution;				//!< Distance between interpolated points in mm
+		float _acceleration;			//!< Path acceleration in mm/s^2
+
+		bool _blockActive;				//!< True while the block at _tail is executed
+		float _blockStart[3];			//!< Start position of the active block
+		float _blockPos;				//!< Distance already covered in the active block in mm
+		float _speed;					//!< Speed of the last interpolated point in mm/s
+		unsigned long _nextPointTime;	//!< Time (micros) at which the next point is due
+};
+
+#endif
@@ -0,0 +1,394 @@
+/**
+ *  \class 	morobotServer
+ *  \brief 	Binary command/response protocol which allows a host (PC, PLC, cell controller) to control a morobot over a serial port
+ *  @file 	host_server.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		morobotServer(morobotClass* morobotToControl, gripper* gripperToControl=NULL);
+			void begin(Stream* stream);
+			void update();
+			void setStatusPeriod(uint16_t period);
+			uint8_t getNumQueuedCommands();
+		private:
+			void receive();
+			void handleFrame();
+			bool startCommand(server_command_type* command);
+			bool checkMotionDone();
+			void sendFrame(uint8_t seq, uint8_t cmd, const uint8_t* payload, uint8_t length);
+			void sendAck(uint8_t seq, uint8_t status);
+			void sendDone(uint8_t seq, uint8_t result);
+			void sendStatus(uint8_t seq);
+			void sendBusStats(uint8_t seq, uint8_t servoId);
+			uint8_t crc8(uint8_t crc, uint8_t data);
+			int16_t readShort(const uint8_t* data);
+			uint8_t writeValue(uint8_t* data, uint32_t value, uint8_t size);
+ */
+
+#include "host_server.h"
+
+#define RX_SYNC		0	//!< Waiting for SERVER_SYNC
+#define RX_LENGTH	1	//!< Waiting for length
+#define RX_SEQ		2	//!< Waiting for sequence number
+#define RX_CMD		3	//!< Waiting for command
+#define RX_PAYLOAD	4	//!< Receiving payload
+#define RX_CRC		5	//!< Waiting for checksum
+
+morobotServer::morobotServer(morobotClass* morobotToControl, gripper* gripperToControl){
+	_morobot = morobotToControl;
+	_gripper = gripperToControl;
+	_stream = NULL;
+	_rxState = RX_SYNC;
+	_lastQueued = false;
+	_tail = 0;
+	_count = 0;
+	_active = false;
+	_statusPeriod = 0;
+	_pushSeq = 0;
+}
+
+void morobotServer::begin(Stream* stream){
+	_stream = stream;
+	_lastStatus = millis();
+}
+
+void morobotServer::update(){
+	receive();
+
+	// Finish the active command
+	if (_active && (millis() - _activeStart) >= _activeTime && (!_activeMotion || checkMotionDone() == true) && (!_activeGripper || _gripper->isFinished() == true)) {
+		server_command_type* command = &_queue[_tail];
+		_active = false;
+		_tail = (_tail + 1) % SERVER_QUEUE_SIZE;
+		_count--;
+		sendDone(command->seq, SERVER_DONE_OK);
+	}
+
+	// Start the next command
+	if (!_active && _count > 0) {
+		server_command_type* command = &_queue[_tail];
+		if (startCommand(command) == true) {
+			_active = true;
+			_activeStart = millis();
+			_lastPoll = _activeStart;
+		} else {
+			_tail = (_tail + 1) % SERVER_QUEUE_SIZE;
+			_count--;
+			sendDone(command->seq, SERVER_DONE_FAILED);
+		}
+	}
+
+	// Status push
+	if (_statusPeriod > 0 && (millis() - _lastStatus) >= _statusPeriod) {
+		_lastStatus = millis();
+		sendStatus(_pushSeq++);
+	}
+}
+
+void morobotServer::setStatusPeriod(uint16_t period){
+	_statusPeriod = period;
+}
+
+uint8_t morobotServer::getNumQueuedCommands(){
+	return _count;
+}
+
+/* PRIVATE */
+void morobotServer::receive(){
+	// Drop incomplete frames, the host will repeat the command after a missing ACK
+	if (_rxState != RX_SYNC && (millis() - _rxTime) > SERVER_RX_TIMEOUT) _rxState = RX_SYNC;
+
+	while (_stream->available() > 0) {
+		uint8_t value = _stream->read();
+		_rxTime = millis();
+		switch (_rxState) {
+			case RX_SYNC:
+				if (value == SERVER_SYNC) {
+					_rxCrc = 0;
+					_rxState = RX_LENGTH;
+				}
+				break;
+			case RX_LENGTH:
+				if (value > SERVER_MAX_PAYLOAD) {
+					_rxState = RX_SYNC;
+					break;
+				}
+				_rx.length = value;
+				_rxCrc = crc8(_rxCrc, value);
+				_rxState = RX_SEQ;
+				break;
+			case RX_SEQ:
+				_rx.seq = value;
+				_rxCrc = crc8(_rxCrc, value);
+				_rxState = RX_CMD;
+				break;
+			case RX_CMD:
+				_rx.cmd = value;
+				_rxCrc = crc8(_rxCrc, value);
+				_rxIndex = 0;
+				_rxState = (_rx.length > 0) ? RX_PAYLOAD : RX_CRC;
+				break;
+			case RX_PAYLOAD:
+				_rx.payload[_rxIndex++] = value;
+				_rxCrc = crc8(_rxCrc, value);
+				if (_rxIndex >= _rx.length) _rxState = RX_CRC;
+				break;
+			case RX_CRC:
+				_rxState = RX_SYNC;
+				if (value != _rxCrc) sendAck(_rx.seq, SERVER_ACK_CRC);
+				else handleFrame();
+				break;
+		}
+	}
+}
+
+void morobotServer::handleFrame(){
+	// The host repeats a frame with the same seq if the ACK got lost
+	bool repeated = (_lastQueued && _rx.seq == _lastSeq && _rx.cmd == _lastCmd);
+	_lastSeq = _rx.seq;
+	_lastCmd = _rx.cmd;
+	_lastQueued = false;
+
+	// Immediate commands
+	switch (_rx.cmd) {
+		case SERVER_CMD_PING:
+			sendAck(_rx.seq, SERVER_ACK_OK);
+			return;
+		case SERVER_CMD_GET_STATUS:
+			sendAck(_rx.seq, SERVER_ACK_OK);
+			sendStatus(_rx.seq);
+			return;
+		case SERVER_CMD_SET_STATUS_PERIOD:
+			if (_rx.length != 2) {
+				sendAck(_rx.seq, SERVER_ACK_LENGTH);
+				return;
+			}
+			setStatusPeriod((uint16_t)readShort(_rx.payload));
+			sendAck(_rx.seq, SERVER_ACK_OK);
+			return;
+		case SERVER_CMD_STOP: {
+			// Drop everything except the active command
+			uint8_t keep = _active ? 1 : 0;
+			while (_count > keep) {
+				_count--;
+				sendDone(_queue[(_tail + _count) % SERVER_QUEUE_SIZE].seq, SERVER_DONE_FAILED);
+			}
+			sendAck(_rx.seq, SERVER_ACK_OK);
+			return;
+		}
+		case SERVER_CMD_GET_BUS_STATS:
+			if (_rx.length != 1) {
+				sendAck(_rx.seq, SERVER_ACK_LENGTH);
+				return;
+			}
+			if (_rx.payload[0] >= _morobot->getNumSmartServos()) {
+				sendAck(_rx.seq, SERVER_ACK_RANGE);
+				return;
+			}
+			sendAck(_rx.seq, SERVER_ACK_OK);
+			sendBusStats(_rx.seq, _rx.payload[0]);
+			return;
+		case SERVER_CMD_RESET_BUS_STATS:
+			_morobot->resetBusStats();
+			_morobot->resetBusErrors();
+			sendAck(_rx.seq, SERVER_ACK_OK);
+			return;
+	}
+
+	// Queued commands
+	uint8_t expectedLength;
+	switch (_rx.cmd) {
+		case SERVER_CMD_MOVE_POSE:
+		case SERVER_CMD_MOVE_LINEAR:
+			expectedLength = 6;
+			break;
+		case SERVER_CMD_MOVE_ANGLES:
+			expectedLength = 1 + 2*_morobot->getNumSmartServos();
+			if (_rx.length > 0 && _rx.payload[0] != _morobot->getNumSmartServos()) expectedLength = 0xFF;
+			break;
+		case SERVER_CMD_SET_SPEED:
+			expectedLength = 1;
+			break;
+		case SERVER_CMD_MOVE_HOME:
+		case SERVER_CMD_GRIPPER_OPEN:
+		case SERVER_CMD_GRIPPER_CLOSE:
+		case SERVER_CMD_SET_BREAKS:
+		case SERVER_CMD_RELEASE_BREAKS:
+			expectedLength = 0;
+			break;
+		default:
+			sendAck(_rx.seq, SERVER_ACK_UNKNOWN);
+			return;
+	}
+	if (_rx.length != expectedLength) {
+		sendAck(_rx.seq, SERVER_ACK_LENGTH);
+		return;
+	}
+	if (repeated) {
+		_lastQueued = true;
+		sendAck(_rx.seq, SERVER_ACK_OK);
+		return;
+	}
+	if (_count >= SERVER_QUEUE_SIZE) {
+		sendAck(_rx.seq, SERVER_ACK_QUEUE_FULL);
+		return;
+	}
+	_queue[(_tail + _count) % SERVER_QUEUE_SIZE] = _rx;
+	_count++;
+	_lastQueued = true;
+	sendAck(_rx.seq, SERVER_ACK_OK);
+}
+
+bool morobotServer::startCommand(server_command_type* command){
+	_activeTime = 0;
+	_activeMotion = false;
+	_activeGripper = false;
+
+	switch (command->cmd) {
+		case SERVER_CMD_MOVE_POSE:
+		case SERVER_CMD_MOVE_LINEAR: {
+			float pose[3];
+			for (uint8_t i=0; i<3; i++) pose[i] = readShort(&command->payload[2*i]) / 10.0;
+			if (command->cmd == SERVER_CMD_MOVE_LINEAR) _morobot->moveLinear(pose);
+			else if (_morobot->moveToPose(pose[0], pose[1], pose[2]) == false) return false;
+			_activeTime = SERVER_SETTLE_TIME;
+			_activeMotion = true;
+			return true;
+		}
+		case SERVER_CMD_MOVE_ANGLES: {
+			long angles[NUM_MAX_SERVOS];
+			for (uint8_t i=0; i<_morobot->getNumSmartServos(); i++) angles[i] = readShort(&command->payload[1+2*i]);
+			_morobot->moveToAngles(angles);
+			_activeTime = SERVER_SETTLE_TIME;
+			_activeMotion = true;
+			return true;
+		}
+		case SERVER_CMD_SET_SPEED:
+			_morobot->setSpeedRPM(command->payload[0]);
+			return true;
+		case SERVER_CMD_MOVE_HOME:
+			_morobot->moveHome();
+			return true;
+		case SERVER_CMD_GRIPPER_OPEN:
+		case SERVER_CMD_GRIPPER_CLOSE:
+			if (_gripper == NULL) return false;
+			if (command->cmd == SERVER_CMD_GRIPPER_OPEN) {
+				if (_gripper->startOpen() == false) return false;
+			} else if (_gripper->startClose() == false) return false;
+			_activeGripper = true;
+			return true;
+		case SERVER_CMD_SET_BREAKS:
+			_morobot->setBreaks();
+			return true;
+		case SERVER_CMD_RELEASE_BREAKS:
+			_morobot->releaseBreaks();
+			return true;
+	}
+	return false;
+}
+
+bool morobotServer::checkMotionDone(){
+	if ((millis() - _lastPoll) < SERVER_POLL_INTERVAL) return false;
+	_lastPoll = millis();
+	for (uint8_t i=0; i<_morobot->getNumSmartServos(); i++) {
+		if (fabs(_morobot->getSpeed(i)) > 0.5) return false;
+	}
+	_morobot->setIdle();
+	return true;
+}
+
+void morobotServer::sendFrame(uint8_t seq, uint8_t cmd, const uint8_t* payload, uint8_t length){
+	uint8_t crc = 0;
+	crc = crc8(crc, length);
+	crc = crc8(crc, seq);
+	crc = crc8(crc, cmd);
+	for (uint8_t i=0; i<length; i++) crc = crc8(crc, payload[i]);
+
+	_stream->write(SERVER_SYNC);
+	_stream->write(length);
+	_stream->write(seq);
+	_stream->write(cmd);
+	_stream->write(payload, length);
+	_stream->write(crc);
+}
+
+void morobotServer::sendAck(uint8_t seq, uint8_t status){
+	uint8_t payload[2] = {status, (uint8_t)(SERVER_QUEUE_SIZE - _count)};
+	sendFrame(seq, SERVER_RSP_ACK, payload, 2);
+}
+
+void morobotServer::sendDone(uint8_t seq, uint8_t result){
+	uint8_t payload[2] = {result, (uint8_t)(SERVER_QUEUE_SIZE - _count)};
+	sendFrame(seq, SERVER_RSP_DONE, payload, 2);
+}
+
+void morobotServer::sendStatus(uint8_t seq){
+	uint8_t payload[3 + 2*NUM_MAX_SERVOS + 6];
+	uint8_t numServos = _morobot->getNumSmartServos();
+	uint8_t length = 0;
+	payload[length++] = _active ? SERVER_STATUS_BUSY : 0;
+	payload[length++] = _count;
+	payload[length++] = numServos;
+	for (uint8_t i=0; i<numServos; i++) {
+		int16_t angle = _morobot->getActAngle(i);
+		payload[length++] = angle & 0xFF;
+		payload[length++] = (angle >> 8) & 0xFF;
+	}
+	// Reading the pose waits until the robot stopped, so only add it while idle
+	if (!_active) {
+		payload[0] |= SERVER_STATUS_POSE_VALID;
+		const char axes[3] = {'x', 'y', 'z'};
+		for (uint8_t i=0; i<3; i++) {
+			int16_t value = _morobot->getActPosition(axes[i]) * 10;
+			payload[length++] = value & 0xFF;
+			payload[length++] = (value >> 8) & 0xFF;
+		}
+	}
+	sendFrame(seq, SERVER_RSP_STATUS, payload, length);
+}
+
+void morobotServer::sendBusStats(uint8_t seq, uint8_t servoId){
+	uint8_t payload[SERVER_BUS_STATS_SIZE];
+	uint8_t length = 0;
+	servo_bus_stats_type stats = _morobot->getBusStats();
+	servo_error_type errors = _morobot->getBusErrors(servoId);
+	uint16_t histogram[SERVO_STATS_BUCKETS];
+
+	payload[length++] = servoId;
+	payload[length++] = SERVO_STATS_TYPES;
+	payload[length++] = SERVO_STATS_BUCKETS;
+	length += writeValue(&payload[length], stats.transactions, 4);
+	length += writeValue(&payload[length], stats.bytesSent, 4);
+	length += writeValue(&payload[length], stats.bytesReceived, 4);
+	length += writeValue(&payload[length], stats.waitTime, 4);
+	length += writeValue(&payload[length], stats.eventHandleTime, 4);
+	length += writeValue(&payload[length], errors.timeouts, 2);
+	length += writeValue(&payload[length], errors.badChecksums, 2);
+	length += writeValue(&payload[length], errors.busy, 2);
+	length += writeValue(&payload[length], errors.errors, 2);
+	length += writeValue(&payload[length], errors.retries, 2);
+	for (uint8_t type=0; type<SERVO_STATS_TYPES; type++) {
+		_morobot->getRttHistogram(servoId, type, histogram);	// all zero if not recorded
+		for (uint8_t k=0; k<SERVO_STATS_BUCKETS; k++) length += writeValue(&payload[length], histogram[k], 2);
+	}
+	sendFrame(seq, SERVER_RSP_BUS_STATS, payload, length);
+}
+
+uint8_t morobotServer::crc8(uint8_t crc, uint8_t data){
+	crc ^= data;
+	for (uint8_t i=0; i<8; i++) {
+		if (crc & 0x80) crc = (crc << 1) ^ 0x07;
+		else crc <<= 1;
+	}
+	return crc;
+}
+
+int16_t morobotServer::readShort(const uint8_t* data){
+	return (int16_t)(data[0] | ((uint16_t)data[1] << 8));
+}
+
+uint8_t morobotServer::writeValue(uint8_t* data, uint32_t value, uint8_t size){
+	for (uint8_t i=0; i<size; i++) data[i] = (value >> (8*i)) & 0xFF;
+	return size;
+}
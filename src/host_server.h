@@ -0,0 +1,230 @@
+/**
+ *  \class 	morobotServer
+ *  \brief 	Binary command/response protocol which allows a host (PC, PLC, cell controller) to control a morobot over a serial port
+ *  @file 	host_server.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		morobotServer(morobotClass* morobotToControl, gripper* gripperToControl=NULL);
+			void begin(Stream* stream);
+			void update();
+			void setStatusPeriod(uint16_t period);
+			uint8_t getNumQueuedCommands();
+		private:
+			void receive();
+			void handleFrame();
+			bool startCommand(server_command_type* command);
+			bool checkMotionDone();
+			void sendFrame(uint8_t seq, uint8_t cmd, const uint8_t* payload, uint8_t length);
+			void sendAck(uint8_t seq, uint8_t status);
+			void sendDone(uint8_t seq, uint8_t result);
+			void sendStatus(uint8_t seq);
+			void sendBusStats(uint8_t seq, uint8_t servoId);
+			uint8_t crc8(uint8_t crc, uint8_t data);
+			int16_t readShort(const uint8_t* data);
+			uint8_t writeValue(uint8_t* data, uint32_t value, uint8_t size);
+ *  \par Frame format:
+ *  	SERVER_SYNC, uint8 length (of payload), uint8 seq, uint8 cmd, payload[length], uint8 crc8 (polynomial 0x07 over length, seq, cmd and payload)
+ *  	All multi-byte values are little-endian, positions are given in 1/10 mm, angles in degrees.
+ *  \par Commands (host to robot):
+ *  	Motion commands (SERVER_CMD_MOVE_POSE ... SERVER_CMD_RELEASE_BREAKS) are queued and executed in order.
+ *  	Every command frame is answered immediately with SERVER_RSP_ACK (status, free queue slots = credits).
+ *  	If the host does not receive an ACK it sends the frame again with the same sequence number. A queued command which repeats the seq and cmd
+ *  	of the last frame is acknowledged again, but not queued twice. A host should start with SERVER_CMD_PING, so the first command of a new
+ *  	session is not taken for a repetition of the last command of the previous one.
+ *  	The host must not send more queued commands than it has credits. When a queued command has been finished SERVER_RSP_DONE is sent.
+ *  	SERVER_CMD_PING, SERVER_CMD_GET_STATUS, SERVER_CMD_SET_STATUS_PERIOD, SERVER_CMD_STOP and the bus statistics commands are executed immediately and are not queued.
+ *  	Status frames (SERVER_RSP_STATUS) are sent on request and periodically if a status period is set.
+ *  	Keep SERVER_QUEUE_SIZE small enough so all frames the host may send fit into the receive buffer of the serial port.
+ *  	SERVER_CMD_MOVE_LINEAR, SERVER_CMD_MOVE_HOME (and the gripper commands of a servo-gripper) block update() until they finished, frames sent meanwhile are answered afterwards.
+ *  	The host should wait for the DONE of these commands before it sends the next frame (all other commands run in the background).
+ */
+
+#ifndef HOST_SERVER_H
+#define HOST_SERVER_H
+
+#include "morobot.h"
+
+#define SERVER_SYNC					0xA5	//!< First byte of every frame
+#define SERVER_QUEUE_SIZE			4		//!< Number of queued commands (credits of the host)
+#define SERVER_MAX_PAYLOAD			(1 + 2*NUM_MAX_SERVOS)	//!< Maximum payload of a frame
+#define SERVER_POLL_INTERVAL		50		//!< Interval in ms to check if a movement has finished
+#define SERVER_SETTLE_TIME			200		//!< Minimum time in ms after starting a movement before it can be finished
+#define SERVER_RX_TIMEOUT			100		//!< Time in ms after which an incomplete frame is dropped
+
+// Commands (host to robot)
+#define SERVER_CMD_PING				0x00	//!< Answered with ACK only
+#define SERVER_CMD_MOVE_POSE		0x01	//!< int16 x, y, z - moveToPose()
+#define SERVER_CMD_MOVE_ANGLES		0x02	//!< uint8 n, int16 angles[n] - moveToAngles()
+#define SERVER_CMD_MOVE_LINEAR		0x03	//!< int16 x, y, z - moveLinear()
+#define SERVER_CMD_SET_SPEED		0x04	//!< uint8 rpm - setSpeedRPM()
+#define SERVER_CMD_MOVE_HOME		0x05	//!< moveHome()
+#define SERVER_CMD_GRIPPER_OPEN		0x06	//!< gripper::startOpen()
+#define SERVER_CMD_GRIPPER_CLOSE	0x07	//!< gripper::startClose()
+#define SERVER_CMD_SET_BREAKS		0x08	//!< setBreaks()
+#define SERVER_CMD_RELEASE_BREAKS	0x09	//!< releaseBreaks()
+#define SERVER_CMD_GET_STATUS		0x10	//!< Answered with ACK and STATUS
+#define SERVER_CMD_SET_STATUS_PERIOD	0x11	//!< uint16 period in ms (0 = no status pushes)
+#define SERVER_CMD_STOP				0x12	//!< Drops all queued commands (the active movement is finished)
+#define SERVER_CMD_GET_BUS_STATS	0x13	//!< uint8 servoId - Answered with ACK and BUS_STATS
+#define SERVER_CMD_RESET_BUS_STATS	0x14	//!< resetBusStats() and resetBusErrors()
+
+// Responses (robot to host)
+#define SERVER_RSP_ACK				0x80	//!< uint8 status, uint8 credits - seq of the acknowledged command
+#define SERVER_RSP_DONE				0x81	//!< uint8 result, uint8 credits - seq of the finished command
+#define SERVER_RSP_STATUS			0x82	//!< uint8 flags, uint8 queued, uint8 n, int16 angles[n], int16 x, y, z (if SERVER_STATUS_POSE_VALID)
+#define SERVER_RSP_BUS_STATS		0x83	//!< uint8 servoId, uint8 types, uint8 buckets, uint32 transactions, bytesSent, bytesReceived, waitTime, eventHandleTime, uint16 timeouts, badChecksums, busy, errors, retries, uint16 histogram[types][buckets]
+#define SERVER_BUS_STATS_SIZE		(3 + 5*4 + 5*2 + 2*SERVO_STATS_TYPES*SERVO_STATS_BUCKETS)	//!< Payload of SERVER_RSP_BUS_STATS
+
+// Status of ACK
+#define SERVER_ACK_OK				0		//!< Command accepted
+#define SERVER_ACK_QUEUE_FULL		1		//!< No credits left, command dropped
+#define SERVER_ACK_CRC				2		//!< Checksum invalid, command dropped
+#define SERVER_ACK_UNKNOWN			3		//!< Unknown command
+#define SERVER_ACK_LENGTH			4		//!< Invalid payload length
+#define SERVER_ACK_RANGE			5		//!< Invalid value (e.g. number of motor)
+
+// Result of DONE
+#define SERVER_DONE_OK				0		//!< Command executed
+#define SERVER_DONE_FAILED			1		//!< Command failed (e.g. position not reachable, no gripper)
+
+// Flags of STATUS
+#define SERVER_STATUS_BUSY			0x01	//!< A command is executed
+#define SERVER_STATUS_POSE_VALID	0x02	//!< TCP pose is appended (only while the robot does not move)
+
+typedef struct {
+	uint8_t seq;							//!< Sequence number of the command
+	uint8_t cmd;							//!< Command (SERVER_CMD_...)
+	uint8_t length;							//!< Length of the payload
+	uint8_t payload[SERVER_MAX_PAYLOAD];	//!< Payload
+} server_command_type;
+
+class morobotServer {
+	public:
+		/**
+		 *  \brief Constructor of morobotServer class
+		 *  \param [in] morobotToControl Pointer to the morobot controlled by the host
+		 *  \param [in] gripperToControl (Optional) Pointer to the gripper controlled by the host
+		 */
+		morobotServer(morobotClass* morobotToControl, gripper* gripperToControl=NULL);
+
+		/**
+		 *  \brief Starts the server. The morobot (and gripper) must already be started.
+		 *  \param [in] stream Port the host is connected to (e.g. &Serial). Must not be the port of the robot.
+		 */
+		void begin(Stream* stream);
+
+		/**
+		 *  \brief Receives commands, executes them and sends responses. Call this function as often as possible (e.g. in loop()).
+		 */
+		void update();
+
+		/**
+		 *  \brief Sets the interval of the status pushes
+		 *  \param [in] period Interval in ms (0 = no status pushes)
+		 */
+		void setStatusPeriod(uint16_t period);
+
+		/**
+		 *  \brief Returns the number of queued commands (including the command executed at the moment)
+		 */
+		uint8_t getNumQueuedCommands();
+
+	private:
+		/**
+		 *  \brief Reads available bytes and handles complete frames
+		 */
+		void receive();
+
+		/**
+		 *  \brief Handles a received frame: executes immediate commands or queues motion commands
+		 */
+		void handleFrame();
+
+		/**
+		 *  \brief Starts the execution of a queued command
+		 *  \param [in] command Command to execute
+		 *  \return Returns true if the command has been started successfully
+		 */
+		bool startCommand(server_command_type* command);
+
+		/**
+		 *  \brief Checks (at most every SERVER_POLL_INTERVAL) if the robot stopped moving
+		 *  \return Returns true if no motor moves
+		 */
+		bool checkMotionDone();
+
+		/**
+		 *  \brief Sends a frame to the host
+		 *  \param [in] seq Sequence number
+		 *  \param [in] cmd Response type (SERVER_RSP_...)
+		 *  \param [in] payload Payload bytes
+		 *  \param [in] length Number of payload bytes
+		 */
+		void sendFrame(uint8_t seq, uint8_t cmd, const uint8_t* payload, uint8_t length);
+
+		/**
+		 *  \brief Sends SERVER_RSP_ACK with the number of free queue slots
+		 */
+		void sendAck(uint8_t seq, uint8_t status);
+
+		/**
+		 *  \brief Sends SERVER_RSP_DONE for a finished command
+		 */
+		void sendDone(uint8_t seq, uint8_t result);
+
+		/**
+		 *  \brief Reads the joint angles (and the pose if the robot does not move) and sends SERVER_RSP_STATUS
+		 */
+		void sendStatus(uint8_t seq);
+
+		/**
+		 *  \brief Sends SERVER_RSP_BUS_STATS with the bus load and the error counters and round trip time histograms of a motor
+		 */
+		void sendBusStats(uint8_t seq, uint8_t servoId);
+
+		/**
+		 *  \brief Updates a CRC-8 (polynomial 0x07) with one byte
+		 */
+		uint8_t crc8(uint8_t crc, uint8_t data);
+
+		/**
+		 *  \brief Reads a little-endian 16 bit value
+		 */
+		int16_t readShort(const uint8_t* data);
+
+		/**
+		 *  \brief Writes a little-endian value with size bytes and returns size
+		 */
+		uint8_t writeValue(uint8_t* data, uint32_t value, uint8_t size);
+
+		morobotClass* _morobot;		//!< Robot controlled by the host
+		gripper* _gripper;			//!< Gripper controlled by the host (may be NULL)
+		Stream* _stream;			//!< Port the host is connected to
+
+		server_command_type _rx;	//!< Frame received at the moment
+		uint8_t _rxState;			//!< State of the receiver (which byte of the frame is expected next)
+		uint8_t _rxIndex;			//!< Number of payload bytes received
+		uint8_t _rxCrc;				//!< CRC of the received bytes
+		unsigned long _rxTime;		//!< Time the last byte has been received
+		uint8_t _lastSeq;			//!< Sequence number of the last valid frame
+		uint8_t _lastCmd;			//!< Command of the last valid frame
+		bool _lastQueued;			//!< True if the last valid frame has been queued (a repetition is only acknowledged)
+
+		server_command_type _queue[SERVER_QUEUE_SIZE];	//!< Queued commands
+		uint8_t _tail;				//!< Index of the oldest queued command
+		uint8_t _count;				//!< Number of queued commands
+		bool _active;				//!< True while the oldest command is executed
+		unsigned long _activeStart;	//!< Time the active command has been started
+		unsigned long _activeTime;	//!< Minimum duration of the active command in ms
+		bool _activeMotion;			//!< True if the active command is finished when the motors stopped
+		bool _activeGripper;		//!< True if the active command is finished when the gripper stopped
+		unsigned long _lastPoll;	//!< Time of the last check if the robot moves
+
+		uint16_t _statusPeriod;		//!< Interval of status pushes in ms (0 = off)
+		unsigned long _lastStatus;	//!< Time of the last status push
+		uint8_t _pushSeq;			//!< Sequence number of status pushes
+};
+
+#endif
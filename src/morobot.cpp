@@ -6,8 +6,16 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobotClass(uint8_t numSmartServos);
-			void begin(const char* stream);
+ *  		void begin(const char* stream);
+			void begin(Stream& port);
+			void begin(servoTransport& transport);
+			bool beginFast(const char* stream, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			bool beginFast(Stream& port, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			bool beginFast(servoTransport& transport, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			static bool beginAll(morobotClass* robots[], const char* streams[], uint8_t numRobots, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			static bool beginAll(morobotClass* robots[], Stream* ports[], uint8_t numRobots, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			unsigned long getBootTime();
+			void printTopology();
 			void setZero();
 			void moveHome();
 			void setSpeedRPM(uint8_t speed);
@@ -20,9 +28,20 @@
 			void setBusy();
 			void setIdle();
 			void waitUntilIsReady();
+			bool waitUntilNear(float distance);
 			bool checkIfMotorMoves(uint8_t servoId);
+			void invalidateJointState();
+			servo_error_type getBusErrors(uint8_t servoId);
+			void resetBusErrors();
+			void printBusErrors();
+			servo_bus_stats_type getBusStats();
+			bool getRttHistogram(uint8_t servoId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]);
+			void resetBusStats();
+			void printBusStats();
 			
 			long getActAngle(uint8_t servoId);
+			long getKnownAngle(uint8_t servoId);
+			joint_estimate_type getEstimate(uint8_t servoId);
 			float getActPosition(char axis);
 			float getActOrientation(char axis);
 			float getSpeed(uint8_t servoId);
@@ -42,118 +61,370 @@
 			void moveAngles(long angles[]);
 			void moveAngles(long angles[], uint8_t speedRPM);
 			bool moveToPose(float x, float y, float z);
+			bool moveToPoseTimed(float x, float y, float z, float duration);
 			bool moveXYZ(float xOffset, float yOffset, float zOffset);
 			bool moveInDirection(char axis, float value);
 
 			void trajectoryPlanning(float points[][3], int nrPoints, int continuousMovement = 0, int polynomOrder = 3);
+			void trajectoryPlanning(pathSource* path, int continuousMovement=0, int polynomOrder=3);
 			void moveLinear(float goalPoint[], int continuousMovement=1, float resolution=5,int useTrajectoryPlanning = 0);
-			float calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime);
-			float calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime);
+			void followPath(pathSource* path, int continuousMovement=1);
+			bool moveLinearTracked(float goalPoint[], float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR);
+			virtual bool moveAlongPath(pathSource* path, float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR)=0;
+			bool moveCircular(float point[], float goalPoint[], uint8_t mode=ARC_CENTER_CCW, float tcpSpeed=LINE_TRACKING_SPEED);
+			bool moveSpline(float points[][3], uint16_t nrPoints, uint8_t type=SPLINE_CATMULL_ROM, float tcpSpeed=LINE_TRACKING_SPEED);
+			tracking_stats_type getTrackingStats();
+			virtual bool checkPath(pathSource* path, float tcpSpeed=0, path_check_type* report=NULL)=0;
+			float calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId=-1);
+			float calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId=-1);
 			float calcIntermediateVelocity(float time, float q0, float q1, float q2);
+			float calcTrapezoidalProfile(float time, float length, float maxVel, float acc);
 			float calcPwm(float deg_per_sec);
+			float calcVelocity(float pwm);
+			float calcPwm(uint8_t servoId, float deg_per_sec);
+			float calcVelocity(uint8_t servoId, float pwm);
+			bool identifyPwmModel(uint8_t servoId);
+			bool savePwmModels(uint16_t address=STORAGE_PWM_ADDRESS);
+			bool loadPwmModels(uint16_t address=STORAGE_PWM_ADDRESS);
+			void printPwmModel(uint8_t servoId);
+			
+			bool setPid(uint8_t servoId, pid_gains_type gains);
+			bool getPid(uint8_t servoId, pid_gains_type* gains);
+			bool tunePid(uint8_t servoId);
+			bool savePidProfiles(uint16_t address=STORAGE_PID_ADDRESS);
+			bool loadPidProfiles(uint16_t address=STORAGE_PID_ADDRESS);
+			bool calibrateBacklash(uint8_t servoId);
+			bool setBacklash(uint8_t servoId, float backlash);
+			float getBacklash(uint8_t servoId);
+			bool setBacklashCompensation(uint8_t mode);
+			bool saveBacklash(uint16_t address=STORAGE_BACKLASH_ADDRESS);
+			bool loadBacklash(uint16_t address=STORAGE_BACKLASH_ADDRESS);
 			
 			void printAngles(long angles[]);
 			void printTCPpose();
 			float convertToDeg(float angle);
 			float convertToRad(float angle);
-			virtual String getType();
+			virtual const char* getType();
+			virtual uint8_t getTypeId();
 		protected:
 			virtual bool calculateAngles(float x, float y, float z);
 			virtual void updateTCPpose(bool output);
 			void autoCalibrateLinearAxis(uint8_t servoId, uint8_t maxMotorCurrent=25);
+			void markJointCommanded(uint8_t servoId, long angle, bool angleIsKnown=true);
+			void sendPwm(uint8_t servoId, float pwm);
+			bool seedEstimators();
+			bool calculatePathAngles(const float point[3], long angles[]);
+			virtual bool calculateGoalAngles(const float point[3]);
+			bool measureStepResponse(uint8_t servoId, long goal, unsigned long* settleTime, float* overshoot);
+			long getBacklashOffset(uint8_t servoId, long goalAngle);
+			bool checkServoResponse(uint8_t servoId, bool success);
+			static Stream* openPort(const char* stream);
+			void attachPort(Stream& port);
+			void startMotors(unsigned long startTime);
+			bool startMotorsFast(unsigned long startTime, uint16_t address);
+			bool probeTopology(uint16_t address);
+			bool storeTopology(uint16_t address);
+			void finishBegin(unsigned long startTime, bool cached);
+			template <uint8_t N> void attachJointStorage(morobotJointStorage<N>* storage);
+			void initJointStorage();
 		private:
+			morobotClass(uint8_t numSmartServos);
 			bool isReady();
  */
 
 #include "morobot.h"
 
 morobotClass::morobotClass(uint8_t numSmartServos){
-	if (numSmartServos > NUM_MAX_SERVOS){
-		Serial.print(F("Too many motors! Maximum number of motors: "));
-		Serial.println(NUM_MAX_SERVOS);
-	}
 	_numSmartServos = numSmartServos;
+	_backlashMode = BACKLASH_OFF;
+	_port = NULL;
 }
 
 void morobotClass::begin(const char* stream){
+	Stream* port = openPort(stream);
+	if (port != NULL) begin(*port);
+}
+
+void morobotClass::begin(Stream& port){
+	unsigned long startTime = millis();
+	attachPort(port);
+	startMotors(startTime);
+}
+
+void morobotClass::begin(servoTransport& transport){
+	unsigned long startTime = millis();
+	_port = NULL;
+	smartServos.beginTransport(&transport);
+	startMotors(startTime);
+}
+
+void morobotClass::startMotors(unsigned long startTime){
+	delay(5);
+	smartServos.assignDevIdRequest();
+	delay(50);
+	
+	setTCPoffset(0, 0, 0);
+	setSpeedRPM(25);
+	updateTCPpose();
+	finishBegin(startTime, false);
+}
+
+bool morobotClass::beginFast(const char* stream, uint16_t address){
+	Stream* port = openPort(stream);
+	if (port == NULL) return false;
+	return beginFast(*port, address);
+}
+
+bool morobotClass::beginFast(Stream& port, uint16_t address){
+	unsigned long startTime = millis();
+	attachPort(port);
+	return startMotorsFast(startTime, address);
+}
+
+bool morobotClass::beginFast(servoTransport& transport, uint16_t address){
+	unsigned long startTime = millis();
+	_port = NULL;
+	smartServos.beginTransport(&transport);
+	return startMotorsFast(startTime, address);
+}
+
+bool morobotClass::startMotorsFast(unsigned long startTime, uint16_t address){
+	bool cached = probeTopology(address);
+	bool success = true;
+	if (!cached) success = smartServos.assignDevIdRequest() && storeTopology(address);
+	setTCPoffset(0, 0, 0);
+	setSpeedRPM(25);
+	finishBegin(startTime, cached);
+	return success;
+}
+
+bool morobotClass::beginAll(morobotClass* robots[], const char* streams[], uint8_t numRobots, uint16_t address){
+	Stream* ports[NUM_MAX_ROBOTS];
+	if (numRobots > NUM_MAX_ROBOTS) {
+		Serial.print(F("ERROR: Too many robots! Maximum number of robots: "));
+		Serial.println(NUM_MAX_ROBOTS);
+		return false;
+	}
+	for (uint8_t i=0; i<numRobots; i++) ports[i] = openPort(streams[i]);
+	return beginAll(robots, ports, numRobots, address);
+}
+
+bool morobotClass::beginAll(morobotClass* robots[], Stream* ports[], uint8_t numRobots, uint16_t address){
+	const uint16_t recordSize = sizeof(servo_topology_type) + STORAGE_HEADER_SIZE;
+	unsigned long startTime = millis();
+	uint8_t status[NUM_MAX_ROBOTS];
+	bool success = true;
+	
+	if (numRobots > NUM_MAX_ROBOTS) {
+		Serial.print(F("ERROR: Too many robots! Maximum number of robots: "));
+		Serial.println(NUM_MAX_ROBOTS);
+		return false;
+	}
+	
+	// Probing a robot takes a few ms, the enumeration of a robot starts right after its probe failed
+	for (uint8_t i=0; i<numRobots; i++) {
+		status[i] = PROCESS_SUC;
+		if (ports[i] == NULL) {
+			status[i] = PROCESS_ERROR;
+			success = false;
+			continue;
+		}
+		robots[i]->attachPort(*ports[i]);
+		robots[i]->_bootCached = robots[i]->probeTopology(address + i*recordSize);
+		if (!robots[i]->_bootCached) {
+			robots[i]->smartServos.assignDevIdStart();
+			status[i] = PROCESS_BUSY;
+		}
+	}
+	
+	// The enumerations of all robots run at the same time
+	bool busy = true;
+	while (busy) {
+		busy = false;
+		for (uint8_t i=0; i<numRobots; i++) {
+			if (status[i] != PROCESS_BUSY) continue;
+			status[i] = robots[i]->smartServos.assignDevIdPoll();
+			if (status[i] == PROCESS_BUSY) busy = true;
+		}
+	}
+	
+	for (uint8_t i=0; i<numRobots; i++) {
+		if (status[i] == PROCESS_ERROR) continue;
+		if (!robots[i]->_bootCached) {
+			if (status[i] != PROCESS_SUC || !robots[i]->storeTopology(address + i*recordSize)) success = false;
+		}
+		robots[i]->setTCPoffset(0, 0, 0);
+		robots[i]->setSpeedRPM(25);
+		robots[i]->finishBegin(startTime, robots[i]->_bootCached);
+	}
+	Serial.print(F("All robots initialized after "));
+	Serial.print(millis() - startTime);
+	Serial.println(F(" ms"));
+	return success;
+}
+
+unsigned long morobotClass::getBootTime(){
+	return _bootTime;
+}
+
+void morobotClass::printTopology(){
+	char version[SERVO_VERSION_LENGTH+1];
+	Serial.print(_numSmartServos);
+	Serial.print(F(" motors, started in "));
+	Serial.print(_bootTime);
+	if (_bootCached) Serial.println(F(" ms (stored motors)"));
+	else Serial.println(F(" ms (enumerated)"));
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		smartServos.getVersion(i+1, version);
+		Serial.print(F("Motor "));
+		Serial.print(i);
+		Serial.print(F(": firmware "));
+		if (version[0] == 0) Serial.println(F("unknown"));
+		else Serial.println(version);
+	}
+}
+
+Stream* morobotClass::openPort(const char* stream){
+	Stream* port = NULL;
 	Serial.begin(115200);
 	#if defined(ARDUINO_AVR_MEGA) || defined(ARDUINO_AVR_MEGA2560)
-		if (stream == "Serial") {
+		if (strcmp(stream, "Serial") == 0) {
 			Serial.println(F("WARNING: Serial on Arduino Mega is connected to the USB-Controller, so you may get strange bytestings in the serial monitor!"));
-			_port = &Serial;
-		} else if (stream == "Serial1") {
+			port = &Serial;
+		} else if (strcmp(stream, "Serial1") == 0) {
 			Serial1.begin(115200);
-			_port = &Serial1;
-		} else if (stream == "Serial2") {
+			port = &Serial1;
+		} else if (strcmp(stream, "Serial2") == 0) {
 			Serial2.begin(115200);
-			_port = &Serial2;
-		} else if (stream == "Serial3") {
+			port = &Serial2;
+		} else if (strcmp(stream, "Serial3") == 0) {
 			Serial3.begin(115200);
-			_port = &Serial3;
+			port = &Serial3;
 		} else {
 			Serial.println(F("ERROR: Serial-Parameter not valid. Choose 'Serial', 'Serial1', 'Serial2' or 'Serial3'."));
 		}
 		
 	#elif defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MINI) || defined (ARDUINO_AVR_NANO)
-		if (stream == "Serial") {
+		if (strcmp(stream, "Serial") == 0) {
 			Serial.println(F("WARNING: Serial on Arduino UNO is connected to the USB-Controller, so you may get strange bytestings in the serial monitor!"));
-			_port = &Serial;
+			port = &Serial;
 		} else {
 			Serial.println(F("ERROR: Serial-Parameter not valid. Only 'Serial' possible."));
 		}
 		
 	#elif defined(ARDUINO_AVR_LEONARDO) || defined(ARDUINO_AVR_MICRO) || defined(ARDUINO_AVR_YUN)
-		if (stream == "Serial1") {
+		if (strcmp(stream, "Serial1") == 0) {
 			Serial1.begin(115200);
-			_port = &Serial1;
+			port = &Serial1;
 		} else {
 			Serial.println(F("ERROR: Serial-Parameter not valid. Only 'Serial1' possible."));
 		}
 		
 	#elif defined(ESP32)
-		if (stream == "Serial") {
+		if (strcmp(stream, "Serial") == 0) {
 			Serial.println(F("WARNING: Serial on ESP32 is connected to the USB-Controller, so you may get strange bytestings in the serial monitor!"));
-			_port = &Serial;
-		} else if (stream == "Serial1") {
+			port = &Serial;
+		} else if (strcmp(stream, "Serial1") == 0) {
 			Serial1.begin(115200, SERIAL_8N1, 18, 19);		// Map the serial pins to different pins since 9/10 are not mapped
-			_port = &Serial1;
-		} else if (stream == "Serial2") {
+			port = &Serial1;
+		} else if (strcmp(stream, "Serial2") == 0) {
 			Serial2.begin(115200);
-			_port = &Serial2;
+			port = &Serial2;
 		} else {
 			Serial.println(F("ERROR: Serial-Parameter not valid. Choose 'Serial1' or 'Serial2'."));
 		}
 		
 	#elif defined(ESP8266)
-		if (stream == "Serial") {
+		if (strcmp(stream, "Serial") == 0) {
 			Serial.println(F("WARNING: Serial on ESP32 is connected to the USB-Controller, so you may get strange bytestings in the serial monitor!"));
-			_port = &Serial;
+			port = &Serial;
 		} else {
 			Serial.println(F("ERROR: Serial-Parameter not valid. Only 'Serial' possible."));
 		}	
 	#else
 		#error "Board not supported"
 	#endif
-		
+	
+	return port;
+}
+
+void morobotClass::attachPort(Stream& port){
+	_port = &port;
 	smartServos.beginSerial(_port);
-	delay(5);
-	smartServos.assignDevIdRequest();
-	delay(50);
+}
+
+bool morobotClass::probeTopology(uint16_t address){
+	servo_topology_type topology;
+	char version[SERVO_VERSION_LENGTH+1];
+	if (!morobotStorage::read(address, STORAGE_TYPE_TOPOLOGY, &topology, sizeof(servo_topology_type))) return false;
+	if (topology.numServos != _numSmartServos || _numSmartServos == 0) return false;
 	
-	setTCPoffset(0, 0, 0);
-	setSpeedRPM(25);
-	updateTCPpose();
+	// The IDs are assigned along the chain, so if the last motor has its ID all others have one too
+	if (!smartServos.probeRequest(_numSmartServos)) return false;
+	smartServos.getVersion(_numSmartServos, version);
+	return strncmp(version, topology.version[_numSmartServos-1], SERVO_VERSION_LENGTH) == 0;
+}
 
-	Serial.println(F("Morobot initialized. Connection to motors established"));
+bool morobotClass::storeTopology(uint16_t address){
+	servo_topology_type topology;
+	servo_topology_type stored;
+	char version[SERVO_VERSION_LENGTH+1];
+	memset(&topology, 0, sizeof(servo_topology_type));
+	
+	topology.numServos = smartServos.getNumDevices();
+	if (topology.numServos < _numSmartServos) {
+		Serial.print(F("ERROR: Only "));
+		Serial.print(topology.numServos);
+		Serial.print(F(" of "));
+		Serial.print(_numSmartServos);
+		Serial.println(F(" motors found"));
+		return false;
+	}
+	topology.numServos = _numSmartServos;
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		// Firmwares without version answer with an error code, only missing answers are a problem
+		if (!smartServos.getVersionRequest(i+1)) {
+			uint8_t error = smartServos.getLastError(i+1);
+			if (error == SERVO_TIMEOUT || error == SERVO_BAD_CHECKSUM) return checkServoResponse(i, false);
+		}
+		smartServos.getVersion(i+1, version);
+		strncpy(topology.version[i], version, SERVO_VERSION_LENGTH);
+	}
+	
+	// Do not wear out the EEPROM if the robot is started with the same motors again
+	if (morobotStorage::read(address, STORAGE_TYPE_TOPOLOGY, &stored, sizeof(servo_topology_type))) {
+		if (memcmp(&stored, &topology, sizeof(servo_topology_type)) == 0) return true;
+	}
+	return morobotStorage::write(address, STORAGE_TYPE_TOPOLOGY, &topology, sizeof(servo_topology_type));
+}
+
+void morobotClass::finishBegin(unsigned long startTime, bool cached){
+	_bootTime = millis() - startTime;
+	_bootCached = cached;
+	Serial.print(F("Morobot initialized. Connection to motors established after "));
+	Serial.print(_bootTime);
+	if (cached) Serial.println(F(" ms (stored motors)"));
+	else Serial.println(F(" ms"));
+}
+
+void morobotClass::initJointStorage(){
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		_pwmModelIsValid[i] = false;
+		_backlash[i] = 0;
+	}
+	invalidateJointState();
 }
 
 void morobotClass::setZero(){
-	for (uint8_t i=0; i<_numSmartServos; i++) smartServos.setZero(i+1);
-	_tcpPoseIsValid = false;
+	for (uint8_t i=0; i<_numSmartServos; i++) checkServoResponse(i, smartServos.setZero(i+1));
+	invalidateJointState();
 }
 
 void morobotClass::moveHome(){
-	for (uint8_t i=0; i<_numSmartServos; i++) smartServos.setInitAngle(i+1, 0, 15);
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		markJointCommanded(i, 0, checkServoResponse(i, smartServos.setInitAngle(i+1, 0, 15)));
+		_backlashOffset[i] = 0;
+	}
 	waitUntilIsReady();
 	_tcpPoseIsValid = false;
 }
@@ -170,12 +441,12 @@ void morobotClass::setSpeedRPM(uint8_t speed){
 
 /* BREAKS */
 void morobotClass::setBreaks(){
-	for (uint8_t i=0; i<_numSmartServos; i++) smartServos.setBreak(i+1, BREAK_BRAKED);
+	for (uint8_t i=0; i<_numSmartServos; i++) checkServoResponse(i, smartServos.setBreak(i+1, BREAK_BRAKED));
 }
 
 void morobotClass::releaseBreaks(){
-	for (uint8_t i=0; i<_numSmartServos; i++) smartServos.setBreak(i+1, BREAK_LOOSE);
-	_tcpPoseIsValid = false;
+	for (uint8_t i=0; i<_numSmartServos; i++) checkServoResponse(i, smartServos.setBreak(i+1, BREAK_LOOSE));
+	invalidateJointState();
 }
 
 
@@ -193,7 +464,6 @@ void morobotClass::waitUntilIsReady(){
 		setIdle();
 		return;
 	}
-	setBusy();
 	unsigned long startTime = millis();
 	while (true){
 		// Check if the robot is ready yet
@@ -206,17 +476,146 @@ void morobotClass::waitUntilIsReady(){
 	}
 }
 
+bool morobotClass::waitUntilNear(float distance){
+	unsigned long startTime = millis();
+	while (true){
+		long remaining = 0;
+		for (uint8_t i=0; i<_numSmartServos; i++) {
+			if (_commandedIsValid[i] == false) return true;
+			long diff = labs(_commandedAngles[i] + _backlashOffset[i] - getActAngle(i));
+			if (diff > remaining) remaining = diff;
+		}
+		if (_moveJointSpan == 0 || remaining * _moveDistance <= distance * _moveJointSpan) return true;
+		
+		if ((millis() - startTime) > TIMEOUT_DELAY) {
+			Serial.println(F("TIMEOUT OCCURED WHILE WAITING FOR ROBOT TO APPROACH ITS GOAL!"));
+			return false;
+		}
+	}
+}
+
 bool morobotClass::checkIfMotorMoves(uint8_t servoId){
 	long startPos = getActAngle(servoId);
 	delay(150);
-	if (startPos != getActAngle(servoId)) return true;
+	long endPos = getActAngle(servoId);
+	if (startPos != endPos) return true;
+	
+	// The motor stands still, so the angle stays valid until the motor is moved again (stored without the backlash offset of the last command)
+	_measuredAngles[servoId] = endPos - _backlashOffset[servoId];
+	_measuredIsValid[servoId] = true;
+	_estimators[servoId].setCommandedVelocity(0, micros());
 	return false;
 }
 
+void morobotClass::invalidateJointState(){
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		_commandedIsValid[i] = false;
+		_measuredIsValid[i] = false;
+		_angleReached[i] = false;
+		_estimators[i].reset();
+		_backlashDirection[i] = 0;
+		_backlashOffset[i] = 0;
+	}
+	_tcpPoseIsValid = false;
+}
+
+servo_error_type morobotClass::getBusErrors(uint8_t servoId){
+	return smartServos.getErrorStats(servoId+1);
+}
+
+void morobotClass::resetBusErrors(){
+	smartServos.resetErrorStats(ALL_DEVICE);
+}
+
+void morobotClass::printBusErrors(){
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		servo_error_type errors = getBusErrors(i);
+		Serial.print(F("Motor "));
+		Serial.print(i);
+		Serial.print(F(": timeouts "));
+		Serial.print(errors.timeouts);
+		Serial.print(F(", bad checksums "));
+		Serial.print(errors.badChecksums);
+		Serial.print(F(", busy "));
+		Serial.print(errors.busy);
+		Serial.print(F(", errors "));
+		Serial.print(errors.errors);
+		Serial.print(F(", retries "));
+		Serial.println(errors.retries);
+	}
+}
+
+servo_bus_stats_type morobotClass::getBusStats(){
+	return smartServos.getBusStats();
+}
+
+bool morobotClass::getRttHistogram(uint8_t servoId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]){
+	return smartServos.getRttHistogram(servoId+1, type, histogram);
+}
+
+void morobotClass::resetBusStats(){
+	smartServos.resetBusStats();
+}
+
+void morobotClass::printBusStats(){
+	servo_bus_stats_type stats = getBusStats();
+	Serial.print(F("Bus: transactions "));
+	Serial.print(stats.transactions);
+	Serial.print(F(", bytes sent "));
+	Serial.print(stats.bytesSent);
+	Serial.print(F(", bytes received "));
+	Serial.print(stats.bytesReceived);
+	Serial.print(F(", waiting [us] "));
+	Serial.print(stats.waitTime);
+	Serial.print(F(", processing [us] "));
+	Serial.println(stats.eventHandleTime);
+
+	const char* const types[SERVO_STATS_TYPES] = {"move", "pwm", "read", "config"};
+	uint16_t histogram[SERVO_STATS_BUCKETS];
+	Serial.print(F("Round trip times [us]:"));
+	for (uint8_t k=0; k<SERVO_STATS_BUCKETS-1; k++) {
+		Serial.print(F(" <"));
+		Serial.print((uint32_t)SERVO_STATS_FIRST_BUCKET << k);
+	}
+	Serial.print(F(" >="));
+	Serial.println((uint32_t)SERVO_STATS_FIRST_BUCKET << (SERVO_STATS_BUCKETS-2));
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		for (uint8_t type=0; type<SERVO_STATS_TYPES; type++) {
+			if (!getRttHistogram(i, type, histogram)) {
+				Serial.println(F("Round trip times are not recorded (SMART_SERVO_STATS)"));
+				return;
+			}
+			Serial.print(F("Motor "));
+			Serial.print(i);
+			Serial.print(F(" "));
+			Serial.print(types[type]);
+			Serial.print(F(":"));
+			for (uint8_t k=0; k<SERVO_STATS_BUCKETS; k++) {
+				Serial.print(F(" "));
+				Serial.print(histogram[k]);
+			}
+			Serial.print(F(", timeout [us] "));
+			Serial.println(smartServos.getResponseTimeout(i+1, type));
+		}
+	}
+}
+
 
 /* GETTERS */
 long morobotClass::getActAngle(uint8_t servoId){
-	return smartServos.getAngleRequest(servoId+1);
+	long angle = smartServos.getAngleRequest(servoId+1);
+	if (checkServoResponse(servoId, smartServos.getLastError(servoId+1) == PROCESS_SUC)) _estimators[servoId].updateAngle(angle, micros());
+	return angle;
+}
+
+long morobotClass::getKnownAngle(uint8_t servoId){
+	if (_measuredIsValid[servoId]) return _measuredAngles[servoId];
+	if (_commandedIsValid[servoId]) return _commandedAngles[servoId];
+	return getActAngle(servoId) - _backlashOffset[servoId];
+}
+
+joint_estimate_type morobotClass::getEstimate(uint8_t servoId){
+	return _estimators[servoId].getEstimate(micros());
 }
 
 float morobotClass::getActPosition(char axis){
@@ -238,7 +637,9 @@ float morobotClass::getActOrientation(char axis){
 }
 
 float morobotClass::getSpeed(uint8_t servoId){
-	return smartServos.getSpeedRequest(servoId+1);
+	float speed = smartServos.getSpeedRequest(servoId+1);
+	if (checkServoResponse(servoId, smartServos.getLastError(servoId+1) == PROCESS_SUC)) _estimators[servoId].updateVelocity(speed*6, micros());	// RPM to degrees per second
+	return speed;
 }
 
 float morobotClass::getTemp(uint8_t servoId){
@@ -270,18 +671,15 @@ uint8_t morobotClass::getNumSmartServos(){
 /* MOVEMENTS */
 void morobotClass::moveToAngle(uint8_t servoId, long angle){
 	if (checkIfAngleValid(servoId, angle) == true) {
-		smartServos.moveTo(servoId+1, angle, _speedRPM);
-		_tcpPoseIsValid = false;
+		bool success = smartServos.moveTo(servoId+1, angle + getBacklashOffset(servoId, angle), _speedRPM);
+		markJointCommanded(servoId, angle, checkServoResponse(servoId, success));
 	}
 }
 
 void morobotClass::moveToAngle(uint8_t servoId, long angle, uint8_t speedRPM, bool checkValidity){
-	if (checkValidity == false) {
-		smartServos.moveTo(servoId+1, angle, speedRPM);
-		_tcpPoseIsValid = false;
-	} else if (checkIfAngleValid(servoId, angle) == true) {
-		smartServos.moveTo(servoId+1, angle, speedRPM);
-		_tcpPoseIsValid = false;
+	if (checkValidity == false || checkIfAngleValid(servoId, angle) == true) {
+		bool success = smartServos.moveTo(servoId+1, angle + getBacklashOffset(servoId, angle), speedRPM);
+		markJointCommanded(servoId, angle, checkServoResponse(servoId, success));
 	}
 }
 
@@ -307,19 +705,20 @@ void morobotClass::moveToAngles(long phi0, long phi1, long phi2){
 }
 
 void morobotClass::moveAngle(uint8_t servoId, long angle){
-	if (checkIfAngleValid(servoId, getActAngle(servoId)+angle) == true) {
-		smartServos.move(servoId+1, angle, _speedRPM);
-		_tcpPoseIsValid = false;
+	long goalAngle = getKnownAngle(servoId) + angle;
+	long lastOffset = _backlashOffset[servoId];
+	if (checkIfAngleValid(servoId, goalAngle) == true) {
+		bool success = smartServos.move(servoId+1, angle + getBacklashOffset(servoId, goalAngle) - lastOffset, _speedRPM);
+		markJointCommanded(servoId, goalAngle, checkServoResponse(servoId, success));
 	}
 }
 
 void morobotClass::moveAngle(uint8_t servoId, long angle, uint8_t speedRPM, bool checkValidity){
-	if (checkValidity == false) {
-		smartServos.move(servoId+1, angle, speedRPM);
-		_tcpPoseIsValid = false;
-	} else if (checkIfAngleValid(servoId, getActAngle(servoId)+angle) == true) {
-		smartServos.move(servoId+1, angle, speedRPM);
-		_tcpPoseIsValid = false;
+	long goalAngle = getKnownAngle(servoId) + angle;
+	long lastOffset = _backlashOffset[servoId];
+	if (checkValidity == false || checkIfAngleValid(servoId, goalAngle) == true) {
+		bool success = smartServos.move(servoId+1, angle + getBacklashOffset(servoId, goalAngle) - lastOffset, speedRPM);
+		markJointCommanded(servoId, goalAngle, checkServoResponse(servoId, success));
 	}
 }
 
@@ -351,6 +750,14 @@ bool morobotClass::moveToPose(float x, float y, float z){
 	updateTCPpose();
 	if (calculateAngles(x, y, z) == false) return false;
 	
+	// Remember the size of the movement for waitUntilNear()
+	_moveDistance = sqrt(pow(x - _actPos[0], 2) + pow(y - _actPos[1], 2) + pow(z - _actPos[2], 2));
+	_moveJointSpan = 0;
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		long span = labs((long)_goalAngles[i] - getKnownAngle(i));
+		if (span > _moveJointSpan) _moveJointSpan = span;
+	}
+	
 	for (uint8_t i=0; i<_numSmartServos; i++) moveToAngle(i, _goalAngles[i]);
 	
 	// Update TCP-Pose
@@ -362,6 +769,32 @@ bool morobotClass::moveToPose(float x, float y, float z){
 	return true;
 }
 
+bool morobotClass::moveToPoseTimed(float x, float y, float z, float duration){
+	// Angles the motors start from (the goal angles of the previous point while streaming)
+	long startAngles[NUM_MAX_SERVOS];
+	for (uint8_t i=0; i<_numSmartServos; i++) startAngles[i] = getKnownAngle(i);
+	
+	const float point[3] = {x, y, z};
+	if (calculateGoalAngles(point) == false) return false;
+	if (duration <= 0) duration = 0.001;
+	
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		// Rounds per minute needed to cover the angle difference within the duration
+		float rpm = fabs(_goalAngles[i] - startAngles[i]) / (6.0 * duration);
+		if (rpm < 1) rpm = 1;
+		else if (rpm > SERVO_MAX_SPEED_RPM) rpm = SERVO_MAX_SPEED_RPM;
+		bool success = smartServos.moveTo(i+1, _goalAngles[i] + getBacklashOffset(i, _goalAngles[i]), (uint8_t)(rpm + 0.5));
+		markJointCommanded(i, _goalAngles[i], checkServoResponse(i, success));
+	}
+	
+	_actPos[0] = x;
+	_actPos[1] = y;
+	_actPos[2] = z;
+	_tcpPoseIsValid = true;
+	
+	return true;
+}
+
 bool morobotClass::moveXYZ(float xOffset, float yOffset, float zOffset){
 	updateTCPpose();
 	return moveToPose(_actPos[0]+xOffset, _actPos[1]+yOffset, _actPos[2]+zOffset);
@@ -400,7 +833,211 @@ float morobotClass::calcPwm(float deg_per_sec){
 	return pwm;
 }
 
-float morobotClass::calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime){
+float morobotClass::calcVelocity(float pwm){
+	float k=4.6109;
+	float d=9.1866;
+	float deg_per_sec=0;
+	
+	//calculate the velocity from the PWM value (small PWM values do not move the motor)
+	if(pwm<0){
+		deg_per_sec=pwm*k+d;
+		if(deg_per_sec>0) deg_per_sec=0;
+	}else if(pwm>0){
+		d=12;
+		deg_per_sec=pwm*k-d;
+		if(deg_per_sec<0) deg_per_sec=0;
+	}
+	
+	return deg_per_sec;
+}
+
+float morobotClass::calcPwm(uint8_t servoId, float deg_per_sec){
+	if(!_pwmModelIsValid[servoId]) return calcPwm(deg_per_sec);
+	if(deg_per_sec==0) return 0;
+
+	uint8_t dir = (deg_per_sec>0) ? 1 : 0;
+	float sign = (deg_per_sec>0) ? 1 : -1;
+	float vel = fabs(deg_per_sec)*10;	// the model stores 1/10 degrees per second
+	pwm_model_type* model = &_pwmModels[servoId];
+
+	//interpolate between the measured points starting at the deadband (small velocities get a PWM value just above the deadband)
+	float pwm0 = model->deadband[dir];
+	float vel0 = 0;
+	for(uint8_t k=0; k<PWM_MODEL_SIZE; k++){
+		float pwm1 = model->pwm[dir][k];
+		float vel1 = model->velocity[dir][k];
+		if(vel <= vel1 || k == PWM_MODEL_SIZE-1){
+			float pwm = pwm1;
+			if(vel1 > vel0) pwm = pwm0 + (vel-vel0)*(pwm1-pwm0)/(vel1-vel0);	//extrapolated above the last point
+			if(pwm > 255) pwm = 255;
+			return sign*pwm;
+		}
+		pwm0 = pwm1;
+		vel0 = vel1;
+	}
+	return sign*pwm0;
+}
+
+float morobotClass::calcVelocity(uint8_t servoId, float pwm){
+	if(!_pwmModelIsValid[servoId]) return calcVelocity(pwm);
+
+	uint8_t dir = (pwm>0) ? 1 : 0;
+	float sign = (pwm>0) ? 1 : -1;
+	pwm = fabs(pwm);
+	pwm_model_type* model = &_pwmModels[servoId];
+	if(pwm <= model->deadband[dir]) return 0;
+
+	float pwm0 = model->deadband[dir];
+	float vel0 = 0;
+	for(uint8_t k=0; k<PWM_MODEL_SIZE; k++){
+		float pwm1 = model->pwm[dir][k];
+		float vel1 = model->velocity[dir][k];
+		if(pwm <= pwm1 || k == PWM_MODEL_SIZE-1){
+			float vel = vel1;
+			if(pwm1 > pwm0) vel = vel0 + (pwm-pwm0)*(vel1-vel0)/(pwm1-pwm0);
+			return sign*vel/10;
+		}
+		pwm0 = pwm1;
+		vel0 = vel1;
+	}
+	return sign*vel0/10;
+}
+
+bool morobotClass::identifyPwmModel(uint8_t servoId){
+	const uint8_t steps[PWM_MODEL_SIZE] = PWM_MODEL_STEPS;
+	long lower = getJointLimit(servoId, 0) + PWM_MODEL_MARGIN;
+	long upper = getJointLimit(servoId, 1) - PWM_MODEL_MARGIN;
+	pwm_model_type model;
+
+	if(upper-lower < 3*PWM_MODEL_MIN_TRAVEL){
+		Serial.println(F("ERROR: Joint range too small to identify the motor"));
+		return false;
+	}
+
+	Serial.print(F("Identifying PWM model of motor "));
+	Serial.println(servoId);
+
+	for(uint8_t dir=0; dir<2; dir++){
+		//the motor moves from one joint limit towards the other
+		int sign = (dir==1) ? 1 : -1;
+		long start = (dir==1) ? lower : upper;
+		long end = (dir==1) ? upper : lower;
+
+		//step 1: increase the PWM value until the motor starts moving (deadband)
+		moveToAngle(servoId, start);
+		waitUntilIsReady();
+		model.deadband[dir] = 0;
+		for(uint8_t pwm=1; pwm<=PWM_MODEL_MAX_DEADBAND; pwm++){
+			long startAngle = getActAngle(servoId);
+			sendPwm(servoId, sign*pwm);
+			delay(PWM_MODEL_SETTLE_TIME);
+			if(sign*(getActAngle(servoId)-startAngle) >= PWM_MODEL_MIN_TRAVEL){
+				model.deadband[dir] = pwm;
+				break;
+			}
+		}
+		sendPwm(servoId, 0);
+		if(model.deadband[dir] == 0){
+			Serial.println(F("ERROR: Motor did not move"));
+			return false;
+		}
+
+		//step 2: measure the velocity at PWM values above the deadband
+		for(uint8_t k=0; k<PWM_MODEL_SIZE; k++){
+			uint16_t pwm = model.deadband[dir] + steps[k];
+			if(pwm > 255) pwm = 255;
+			model.pwm[dir][k] = pwm;
+
+			moveToAngle(servoId, start);
+			waitUntilIsReady();
+			sendPwm(servoId, sign*(float)pwm);
+
+			//let the motor accelerate, at high PWM values it may already reach the other joint limit meanwhile
+			long settleAngle = getActAngle(servoId);
+			unsigned long settleTime = micros();
+			long startAngle = settleAngle;
+			unsigned long startTime = settleTime;
+			while(sign*(end-startAngle) > 0 && startTime-settleTime < PWM_MODEL_SETTLE_TIME*1000UL){
+				startAngle = getActAngle(servoId);
+				startTime = micros();
+			}
+
+			//measure until the motor reaches the other joint limit or the time is over
+			long angle = startAngle;
+			unsigned long time = startTime;
+			while(sign*(end-angle) > 0 && time-startTime < PWM_MODEL_MEASURE_TIME*1000UL){
+				angle = getActAngle(servoId);
+				time = micros();
+			}
+			sendPwm(servoId, 0);
+
+			//if the limit has been reached while accelerating, the velocity includes the acceleration (a little too low)
+			if(time == startTime){
+				startAngle = settleAngle;
+				startTime = settleTime;
+			}
+
+			float vel = 0;
+			if(time != startTime) vel = sign*(angle-startAngle)*1e6/(time-startTime);
+			if(vel < 0) vel = 0;
+			if(k > 0 && vel*10 < model.velocity[dir][k-1]) vel = model.velocity[dir][k-1]/10.0;	//the velocity must not decrease with the PWM value
+			model.velocity[dir][k] = vel*10;
+		}
+	}
+
+	moveToAngle(servoId, constrain(0L, lower, upper));
+	waitUntilIsReady();
+
+	_pwmModels[servoId] = model;
+	_pwmModelIsValid[servoId] = true;
+	printPwmModel(servoId);
+	return true;
+}
+
+bool morobotClass::savePwmModels(uint16_t address){
+	for(uint8_t i=0; i<_numSmartServos; i++){
+		if(!_pwmModelIsValid[i]){
+			Serial.print(F("ERROR: PWM model of motor "));
+			Serial.print(i);
+			Serial.println(F(" has not been identified"));
+			return false;
+		}
+	}
+	return morobotStorage::write(address, STORAGE_TYPE_PWM, _pwmModels, _numSmartServos*sizeof(pwm_model_type));
+}
+
+bool morobotClass::loadPwmModels(uint16_t address){
+	if(!morobotStorage::read(address, STORAGE_TYPE_PWM, _pwmModels, _numSmartServos*sizeof(pwm_model_type))){
+		Serial.println(F("No PWM models stored, using default model"));
+		return false;
+	}
+	for(uint8_t i=0; i<_numSmartServos; i++) _pwmModelIsValid[i] = true;
+	return true;
+}
+
+void morobotClass::printPwmModel(uint8_t servoId){
+	Serial.print(F("PWM model of motor "));
+	Serial.print(servoId);
+	if(!_pwmModelIsValid[servoId]){
+		Serial.println(F(": not identified"));
+		return;
+	}
+	Serial.println(F(" (PWM: velocity [deg/s])"));
+	for(uint8_t dir=0; dir<2; dir++){
+		if(dir==1) Serial.print(F("  positive, deadband "));
+		else Serial.print(F("  negative, deadband "));
+		Serial.print(_pwmModels[servoId].deadband[dir]);
+		for(uint8_t k=0; k<PWM_MODEL_SIZE; k++){
+			Serial.print(F(", "));
+			Serial.print(_pwmModels[servoId].pwm[dir][k]);
+			Serial.print(F(": "));
+			Serial.print(_pwmModels[servoId].velocity[dir][k]/10.0);
+		}
+		Serial.println();
+	}
+}
+
+float morobotClass::calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId){
 	float diff = endAngle-startAngle;
 	
 	//set the start velocity
@@ -427,10 +1064,11 @@ float morobotClass::calcPolynomThirdOrder(int startAngle, int endAngle, float st
 	}
 	
 	//calculate pwm value
+	if(servoId>=0) return calcPwm(servoId, theta_v);
 	return calcPwm(theta_v);
 }
 
-float morobotClass::calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime){
+float morobotClass::calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId){
 	float diff = endAngle-startAngle;
 	
 	//set the start velocity
@@ -459,6 +1097,7 @@ float morobotClass::calcPolynomFifthOrder(int startAngle, int endAngle, float st
 	}
 
 	//calculate pwm value
+	if(servoId>=0) return calcPwm(servoId, theta_v);
 	return calcPwm(theta_v);
 }
 
@@ -475,35 +1114,60 @@ float morobotClass::calcIntermediateVelocity(float time, float q0, float q1, flo
 	return v;
 }
 
+float morobotClass::calcTrapezoidalProfile(float time, float length, float maxVel, float acc){
+	// Triangular profile if the maximum velocity can not be reached
+	if(maxVel*maxVel > length*acc) maxVel = sqrt(length*acc);
+	
+	float accTime = maxVel/acc;
+	float totalTime = accTime + length/maxVel;
+	
+	if(time <= 0) return 0;
+	if(time >= totalTime) return length;
+	if(time < accTime) return 0.5*acc*time*time;							// accelerate
+	if(time <= totalTime-accTime) return maxVel*(time-0.5*accTime);		// constant velocity
+	float remainingTime = totalTime-time;
+	return length - 0.5*acc*remainingTime*remainingTime;					// decelerate
+}
+
 void morobotClass::trajectoryPlanning(float points[][3], int nrPoints, int continuousMovement = 0, int polynomOrder = 3){
-	int jointValues[nrPoints][_numSmartServos]={};	//array for joint angles for all points
-	float jointVelocities[_numSmartServos]={};		//array for joint velocities
-	int startJointAngles[_numSmartServos]={};		//array for start angles	
-	int nrIterations = 10; 
+	waypointPath path(points, nrPoints);
+	trajectoryPlanning(&path, continuousMovement, polynomOrder);
+}
+
+void morobotClass::trajectoryPlanning(pathSource* path, int continuousMovement, int polynomOrder){
+	long jointValues[NUM_MAX_SERVOS]={};			//joint angles of the point approached at the moment
+	long nextJointValues[NUM_MAX_SERVOS]={};		//joint angles of the following point
+	float jointVelocities[NUM_MAX_SERVOS]={};		//array for joint velocities
+	int startJointAngles[NUM_MAX_SERVOS]={};		//array for start angles
+	float point[3];
+	int nrPoints = path->getNumPoints();
+	int nrIterations = 10;
 	float minPwmVel=25.58854; //[°/sec]
 	int k=0;
 	static uint32_t starttime=millis();
 
-	//step 1: calculate inverse kinematics to get joint angles for all points
-	for(int i=0; i<nrPoints; ++i){
-		calculateAngles(points[i][0], points[i][1], points[i][2]);	//calculate inverse kinematics for the x,y and z pose
-		Serial.print(i);
-		Serial.print(":");
-		for(int j=0;j<_numSmartServos; ++j){	//loop over the motors 
-			jointValues[i][j]=_goalAngles[j];	//save the calculated motor angle in jointValues
-			Serial.print(" ");
-			Serial.print(jointValues[i][j]);
-		}
-		Serial.print("\n");
-	}
+	//step 1: check the whole path, then calculate inverse kinematics of the first point (the following points are calculated when they are needed)
+	//the joint velocities follow from the angles between the points, there is no TCP speed to check
+	if(!checkPath(path)) return;
+	path->reset();
+	if(!path->next(point) || !calculatePathAngles(point, nextJointValues)) return;
 
 	float max_total_time=0;
 	int min_dis=360;
 	int joint = 0;
-	float end_vel[_numSmartServos]={};		//continuous movment - end velocity 
-	float start_vel[_numSmartServos]={};	//continuous movment - start velocity 
+	float end_vel[NUM_MAX_SERVOS]={};		//continuous movment - end velocity
+	float start_vel[NUM_MAX_SERVOS]={};	//continuous movment - start velocity
 
 	for(int i=0; i< nrPoints; ++i){	//loop over all points
+		for(int j=0; j<_numSmartServos; ++j) jointValues[j]=nextJointValues[j];
+		if(i!=nrPoints-1){
+			//calculate inverse kinematics of the following point
+			if(!path->next(point) || !calculatePathAngles(point, nextJointValues)){
+				for(int j=0; j<_numSmartServos; ++j) sendPwm(j, 0);
+				return;
+			}
+		}
+
 		Serial.print("\n\npoint: ");
 		Serial.println(i+1);
 		min_dis=360;
@@ -521,11 +1185,11 @@ void morobotClass::trajectoryPlanning(float points[][3], int nrPoints, int conti
 			Serial.print(" start: ");
 			Serial.print(startJointAngles[j]);
 			Serial.print(" end: ");
-			Serial.print(jointValues[i][j]);
+			Serial.print(jointValues[j]);
 			Serial.print(" diff: ");
-			Serial.println(jointValues[i][j]-startJointAngles[j]);
-			if(abs(startJointAngles[j]-jointValues[i][j])<min_dis && abs(startJointAngles[j]-jointValues[i][j])!=0){	//find the min distance that has to be travelled by a joint
-				min_dis=abs(startJointAngles[j]-jointValues[i][j]);
+			Serial.println(jointValues[j]-startJointAngles[j]);
+			if(abs(startJointAngles[j]-jointValues[j])<min_dis && abs(startJointAngles[j]-jointValues[j])!=0){	//find the min distance that has to be travelled by a joint
+				min_dis=abs(startJointAngles[j]-jointValues[j]);
 				joint = j;
 			}
 		}
@@ -536,13 +1200,13 @@ void morobotClass::trajectoryPlanning(float points[][3], int nrPoints, int conti
 		Serial.print(max_total_time);
 		Serial.print(" joint: ");
 		Serial.println(joint);
-		
+
 		//step 2a: continuous movment - calculate start and end-velocity
 		if(continuousMovement==1){
 			for(int j=0; j<_numSmartServos; ++j){
 				start_vel[j]=end_vel[j];
 				if(i!=nrPoints-1){
-					end_vel[j] = calcIntermediateVelocity(max_total_time, startJointAngles[j], jointValues[i][j], jointValues[i+1][j]);
+					end_vel[j] = calcIntermediateVelocity(max_total_time, startJointAngles[j], jointValues[j], nextJointValues[j]);
 				}else{
 					end_vel[j] = 0;
 				}
@@ -557,31 +1221,32 @@ void morobotClass::trajectoryPlanning(float points[][3], int nrPoints, int conti
 
 		//step 3: calculate velocities with trajectory planning methods
 		starttime=millis();
-		while(k<nrIterations){	//loop over timeslots per point	
-			if((millis()-starttime)>((max_total_time/nrIterations)*1000)){	//calculate the joint velocities at the start of every time slot (max_total_time/nrIterations)			
+		while(k<nrIterations){	//loop over timeslots per point
+			if((millis()-starttime)>((max_total_time/nrIterations)*1000)){	//calculate the joint velocities at the start of every time slot (max_total_time/nrIterations)
 				starttime=millis();
 
 				for(int j=0; j<_numSmartServos;++j){ //loop over servos
 					//calculate velocity for current time slot
 					if(polynomOrder==5){
 						if(continuousMovement==1){
-							jointVelocities[j]=calcPolynomFifthOrder(startJointAngles[j], jointValues[i][j], start_vel[j], end_vel[j], max_total_time/nrIterations*(k+1), max_total_time);
+							jointVelocities[j]=calcPolynomFifthOrder(startJointAngles[j], jointValues[j], start_vel[j], end_vel[j], max_total_time/nrIterations*(k+1), max_total_time, j);
 						}else{
-							jointVelocities[j]=calcPolynomFifthOrder(startJointAngles[j], jointValues[i][j], 24, 10, max_total_time/nrIterations*(k+1), max_total_time); 
+							jointVelocities[j]=calcPolynomFifthOrder(startJointAngles[j], jointValues[j], 24, 10, max_total_time/nrIterations*(k+1), max_total_time, j);
 						}
 					}else{
 						if(continuousMovement==1){
-							jointVelocities[j]=calcPolynomThirdOrder(startJointAngles[j], jointValues[i][j], start_vel[j], end_vel[j], max_total_time/nrIterations*(k+1), max_total_time);
+							jointVelocities[j]=calcPolynomThirdOrder(startJointAngles[j], jointValues[j], start_vel[j], end_vel[j], max_total_time/nrIterations*(k+1), max_total_time, j);
 						}else{
-							jointVelocities[j]=calcPolynomThirdOrder(startJointAngles[j], jointValues[i][j], 24, 0, max_total_time/nrIterations*(k+1), max_total_time); 
+							jointVelocities[j]=calcPolynomThirdOrder(startJointAngles[j], jointValues[j], 24, 0, max_total_time/nrIterations*(k+1), max_total_time, j);
 						}
 					}
-					
-					smartServos.setPwmMove(j+1, jointVelocities[j]);	//send velocity to servo
+
+					sendPwm(j, jointVelocities[j]);	//send velocity to servo
+					markJointCommanded(j, jointValues[j], false);
 				}
 				++k;
 			}
-			
+
 		}
 		k=0;
 
@@ -596,92 +1261,81 @@ void morobotClass::trajectoryPlanning(float points[][3], int nrPoints, int conti
 }
 
 void morobotClass::moveLinear(float goalPoint[], int continuousMovement=1, float resolution=5,int useTrajectoryPlanning = 0){
+	//closed-loop tracking of the line (does not need intermediate points)
+	if(useTrajectoryPlanning == 2){
+		moveLinearTracked(goalPoint);
+		return;
+	}
+
 	//Step 1: calculate straight line in 3D-Space:
 	//X(s)=A+sv, where A=Startpoint, V=Goalpoint-Startpoint (direction), s=Intervall*(1/numberOfIntervalls)
-	float A[3]={}; 
-	float v[3]={}; 
-
 	updateTCPpose();
 	for(int i=0; i<3; ++i){
-		A[i]=_actPos[i];
-		v[i]=goalPoint[i]-_actPos[i];
 		Serial.print(i);
 		Serial.print(" akt: ");
 		Serial.print(_actPos[i]);
 		Serial.print(" distance ");
 		Serial.print(": ");
-		Serial.println(v[i]);
+		Serial.println(goalPoint[i]-_actPos[i]);
 	}
 
-	//Step 2: calculate length of line
-	float len = sqrt(pow(v[0],2)+pow(v[1],2)+pow(v[2],2));
+	//Step 2: calculate length of line and number of intervalls (the points are calculated when they are approached)
+	linePath path(_actPos, goalPoint, resolution);
 	Serial.print("Length of line: ");
-	Serial.println(len);
-
-	//Step 3: determine number of intervalls and calculate s
-	int nrIntervalls = len/resolution;
-	float s = 1/float(nrIntervalls);
-
+	Serial.println(path.getLength());
 	Serial.print("Number of intervalls: ");
-	Serial.println(nrIntervalls);
-
-	//Step 4: create Points
-	float points[nrIntervalls][3] = {};
-	Serial.println("---\nPoints - (i: x, y, z)");
-	for(int i=0; i<nrIntervalls; ++i){
-		Serial.print(i);
-		Serial.print(":");
-		for(int j=0; j<3; ++j){
-			points[i][j] = A[j]+(i+1)*s*v[j];
-			Serial.print(" ");
-			Serial.print(points[i][j]);
-		}
-		Serial.print("\n");
-	}
+	Serial.println(path.getNumPoints());
 
 	//--------------------------------------
 	//use trajectory planning for the movment
 	if(useTrajectoryPlanning == 1){
-		trajectoryPlanning(points, sizeof(points)/sizeof(points[0]), 1, 3);
+		trajectoryPlanning(&path, 1, 3);
 		return;
 	}
 
 	//--------------------------------------
-	//Step 5: calculate inverse kinematics for every point
-	int jointValues[nrIntervalls+1][_numSmartServos]={};
-	Serial.println("\nAngles - (i: 1 2 3 [°])");
-	for(int i=0; i<nrIntervalls; ++i){
-		calculateAngles(points[i][0], points[i][1], points[i][2]);	//calculate inverse kinematics for the x,y and rot_z pose
-		Serial.print(i);
-		Serial.print(":");
-		for(int j=0;j<_numSmartServos; ++j){	//loop over the motors 
-			jointValues[i][j]=_goalAngles[j];	//save the calculated motor angle in jointValues
-			//print angles
-			//Serial.print(j);
-			Serial.print(" ");
-			Serial.print(jointValues[i][j]);
-		}
-		Serial.print("\n");
-	}
+	//Step 3: move between points
+	followPath(&path, continuousMovement);
+}
 
-	//Step 6: move between points
+void morobotClass::followPath(pathSource* path, int continuousMovement){
+	long jointValues[NUM_MAX_SERVOS]={};	//joint angles of the point approached at the moment
+	float point[3];
+	int nrIntervalls = path->getNumPoints();
 	float minPwmVel=25.58854; //[°/sec]
 	float max_total_time=0;
 	int max_dis=0;
 	int unfinished = 0;	//number of motors that have not reached their target position
 	int joint_max_dis=0;
-	int dis[_numSmartServos]={0};
-	float jointDistances[_numSmartServos]={0};
-	int startJointAngles[_numSmartServos]={};
+	int dis[NUM_MAX_SERVOS]={0};
+	float jointDistances[NUM_MAX_SERVOS]={0};
+	int startJointAngles[NUM_MAX_SERVOS]={};
 	static uint32_t starttime=millis();
 	bool while_loop=true;
 
+	//check the whole path before the robot moves (all joints move with the minimum PWM velocity, there is no TCP speed to check)
+	if(!checkPath(path)) return;
+
 	//loop over points
+	path->reset();
 	for(int i=0; i<nrIntervalls; ++i){
+		//calculate the point and its inverse kinematics
+		path->next(point);
+		if(!calculatePathAngles(point, jointValues)){
+			for(int j=0; j<_numSmartServos; ++j) sendPwm(j, 0);
+			return;
+		}
+
 		//calculate max distance
 		max_dis=0;
 		Serial.print("-------\nintervall: ");
-		Serial.println(i);
+		Serial.print(i);
+		Serial.print(" point:");
+		for(int j=0; j<3; ++j){
+			Serial.print(" ");
+			Serial.print(point[j]);
+		}
+		Serial.print("\n");
 
 		for(int j=0; j<_numSmartServos;++j){ 	//loop over all joints
 			startJointAngles[j]=getActAngle(j); //get current angle
@@ -690,29 +1344,37 @@ void morobotClass::moveLinear(float goalPoint[], int continuousMovement=1, float
 			Serial.print(" start: ");
 			Serial.print(startJointAngles[j]);
 			Serial.print(" end: ");
-			Serial.print(jointValues[i][j]);
+			Serial.print(jointValues[j]);
 			Serial.print(" diff: ");
-			Serial.println(startJointAngles[j]-jointValues[i][j]);
-			jointDistances[j]=jointValues[i][j]-startJointAngles[j];
+			Serial.println(startJointAngles[j]-jointValues[j]);
+			jointDistances[j]=jointValues[j]-startJointAngles[j];
 
 			if(abs(jointDistances[j])>max_dis){	//find the max distance that has to be travelled by a joint
 				max_dis=abs(jointDistances[j]);
 				joint_max_dis=j;
 			}
 		}
-		
+
 		//"joint_max_dis" takes the longest
 		Serial.print("joint with max distance: ");
 		Serial.println(joint_max_dis);
 
+		//the loop below works with the estimated angles, so every motor must have been read successfully
+		if(!seedEstimators()){
+			for(int j=0; j<_numSmartServos; ++j) sendPwm(j, 0);
+			return;
+		}
+
 		//send velocities to motors
 		for(int j=0;j<_numSmartServos;++j){
+			//rounded, so both directions get the same PWM value (+-8 without identified model)
 			if(jointDistances[j]>0){
-				smartServos.setPwmMove(j+1, 8);
+				sendPwm(j, round(calcPwm(j, minPwmVel)));
 			}else{
-				smartServos.setPwmMove(j+1, -8);
+				sendPwm(j, round(calcPwm(j, -minPwmVel)));
 			}
-			
+			markJointCommanded(j, jointValues[j], false);
+
 		}
 
 		//helper: discontinuous movement - set values in the array to 1 - once a motor has reached its intermediate goal position, the value is set to zero
@@ -722,29 +1384,34 @@ void morobotClass::moveLinear(float goalPoint[], int continuousMovement=1, float
 		}
 
 		starttime=millis();
+		uint8_t readJoint=0;
 		while(while_loop==true){
+			//read one motor per loop and use the estimated angles for the others, so the loop runs faster than the bus
+			getActAngle(readJoint);
+			readJoint=(readJoint+1)%_numSmartServos;
+
 			for(int j=0; j<_numSmartServos;++j){ 	//loop over all joints
-				if(continuousMovement==1 && (abs(getActAngle(joint_max_dis))>abs(jointValues[i][joint_max_dis]-1))){
+				if(continuousMovement==1 && (fabs(getEstimate(joint_max_dis).angle)>abs(jointValues[joint_max_dis]-1))){
 					while_loop=false;
 					break;
 				}
 
 				if(dis[j]!=0 && jointDistances[j]>0){
-					if(abs(getActAngle(j))>=abs(jointValues[i][j])){
-						smartServos.setPwmMove(j+1, 0);
+					if(fabs(getEstimate(j).angle)>=abs(jointValues[j])){
+						sendPwm(j, 0);
 						dis[j]=0;
 					}
 
 				}else if(dis[j]!=0){
-					if(abs(getActAngle(j))<=abs(jointValues[i][j])){
-						smartServos.setPwmMove(j+1, 0);
+					if(fabs(getEstimate(j).angle)<=abs(jointValues[j])){
+						sendPwm(j, 0);
 						dis[j]=0;
 					}
 				}
 			}
 
 			unfinished = 0;
-			for(int j=0; j<3;++j){
+			for(int j=0; j<_numSmartServos;++j){
 				unfinished += dis[j];
 			}
 
@@ -754,7 +1421,7 @@ void morobotClass::moveLinear(float goalPoint[], int continuousMovement=1, float
 				}
 				break;
 			}
-			
+
 		}
 		while_loop=true;
 		Serial.print("\n");
@@ -763,6 +1430,219 @@ void morobotClass::moveLinear(float goalPoint[], int continuousMovement=1, float
 	printTCPpose();
 }
 
+bool morobotClass::moveLinearTracked(float goalPoint[], float tcpSpeed, float maxDeviation){
+	updateTCPpose();
+	linePath path(_actPos, goalPoint);
+	return moveAlongPath(&path, tcpSpeed, maxDeviation);
+}
+
+bool morobotClass::moveCircular(float point[], float goalPoint[], uint8_t mode, float tcpSpeed){
+	updateTCPpose();
+	circularPath path(_actPos, point, goalPoint, mode);
+	return moveAlongPath(&path, tcpSpeed);
+}
+
+bool morobotClass::moveSpline(float points[][3], uint16_t nrPoints, uint8_t type, float tcpSpeed){
+	updateTCPpose();
+	splinePath path(_actPos, points, nrPoints, type);
+	return moveAlongPath(&path, tcpSpeed);
+}
+
+tracking_stats_type morobotClass::getTrackingStats(){
+	return _trackingStats;
+}
+
+/* SERVO CONTROLLER */
+bool morobotClass::setPid(uint8_t servoId, pid_gains_type gains){
+	return smartServos.setPid(servoId+1, SERVO_PID_POSITION, gains.p, gains.i, gains.d);
+}
+
+bool morobotClass::getPid(uint8_t servoId, pid_gains_type* gains){
+	float pid[3];
+	if (!smartServos.getPidRequest(servoId+1, SERVO_PID_POSITION, pid)) return false;
+	gains->p = pid[0];
+	gains->i = pid[1];
+	gains->d = pid[2];
+	return true;
+}
+
+bool morobotClass::tunePid(uint8_t servoId){
+	const float factors[PID_TUNE_NUM_FACTORS] = PID_TUNE_FACTORS;
+	pid_gains_type original, best;
+	unsigned long bestTime = 0;
+	bool found = false;
+
+	if (!getPid(servoId, &original)){
+		Serial.println(F("ERROR: Could not read the PID gains of the motor"));
+		return false;
+	}
+
+	// The steps are done in the middle of the joint range
+	long lower = getJointLimit(servoId, 0) + PID_TUNE_MARGIN;
+	long upper = getJointLimit(servoId, 1) - PID_TUNE_MARGIN;
+	long step = PID_TUNE_STEP;
+	if (upper-lower < step) step = upper-lower;
+	if (step <= 2*PID_TUNE_TOLERANCE){
+		Serial.println(F("ERROR: Joint range too small to tune the motor"));
+		return false;
+	}
+	long start = (lower+upper)/2 - step/2;
+	long goals[2] = {start+step, start};
+
+	Serial.print(F("Tuning PID gains of motor "));
+	Serial.println(servoId);
+	moveToAngle(servoId, start, SERVO_MAX_SPEED_RPM);
+	waitUntilIsReady();
+
+	for (uint8_t k=0; k<PID_TUNE_NUM_FACTORS; k++){
+		pid_gains_type gains = {original.p*factors[k], original.i*factors[k], original.d*factors[k]};
+		if (!setPid(servoId, gains)) break;
+
+		// Step forward and back, the slower direction counts
+		unsigned long settleTime = 0;
+		float overshoot = 0;
+		bool settled = true;
+		for (uint8_t dir=0; dir<2 && settled; dir++){
+			unsigned long time;
+			float over;
+			settled = measureStepResponse(servoId, goals[dir], &time, &over);
+			if (time > settleTime) settleTime = time;
+			if (over > overshoot) overshoot = over;
+		}
+
+		Serial.print(F("  P "));
+		Serial.print(gains.p, 4);
+		Serial.print(F(", I "));
+		Serial.print(gains.i, 4);
+		Serial.print(F(", D "));
+		Serial.print(gains.d, 4);
+		Serial.print(F(": settle time "));
+		Serial.print(settleTime);
+		Serial.print(F(" ms, overshoot "));
+		Serial.print(overshoot);
+		Serial.println(F(" degrees"));
+
+		if (overshoot > PID_TUNE_MAX_OVERSHOOT) break;	// Larger gains overshoot even more
+		if (settled && (!found || settleTime < bestTime)){
+			best = gains;
+			bestTime = settleTime;
+			found = true;
+		}
+	}
+
+	if (!found){
+		Serial.println(F("ERROR: No gains settled without overshooting, the original gains are kept"));
+		best = original;
+	}
+	setPid(servoId, best);
+	moveToAngle(servoId, start, SERVO_MAX_SPEED_RPM);
+	waitUntilIsReady();
+	return found;
+}
+
+bool morobotClass::savePidProfiles(uint16_t address){
+	pid_gains_type gains[NUM_MAX_SERVOS];
+	for (uint8_t i=0; i<_numSmartServos; i++){
+		if (!getPid(i, &gains[i])){
+			Serial.print(F("ERROR: Could not read the PID gains of motor "));
+			Serial.println(i);
+			return false;
+		}
+	}
+	return morobotStorage::write(address, STORAGE_TYPE_PID, gains, _numSmartServos*sizeof(pid_gains_type));
+}
+
+bool morobotClass::loadPidProfiles(uint16_t address){
+	pid_gains_type gains[NUM_MAX_SERVOS];
+	if (!morobotStorage::read(address, STORAGE_TYPE_PID, gains, _numSmartServos*sizeof(pid_gains_type))){
+		Serial.println(F("No PID gains stored, using the gains of the motors"));
+		return false;
+	}
+	bool success = true;
+	for (uint8_t i=0; i<_numSmartServos; i++){
+		if (!setPid(i, gains[i])){
+			Serial.print(F("ERROR: Could not set the PID gains of motor "));
+			Serial.println(i);
+			success = false;
+		}
+	}
+	return success;
+}
+
+bool morobotClass::calibrateBacklash(uint8_t servoId){
+	long lower = getJointLimit(servoId, 0);
+	long upper = getJointLimit(servoId, 1);
+	if (upper-lower < 2*BACKLASH_CALIBRATION_DISTANCE){
+		Serial.println(F("ERROR: Joint range too small to calibrate the backlash"));
+		return false;
+	}
+	long target = (lower+upper)/2;
+	
+	Serial.print(F("Calibrating backlash of motor "));
+	Serial.println(servoId);
+	
+	// The motor must not compensate the backlash itself during the measurement
+	if (_backlashMode == BACKLASH_FIRMWARE) smartServos.clrMotionCompensation(servoId+1);
+	_backlashOffset[servoId] = 0;
+	
+	// Approach the target from below (dir=1) and above (dir=-1), the difference of the reached angles is the backlash
+	long sum = 0;
+	for (uint8_t k=0; k<BACKLASH_CALIBRATION_REPETITIONS; k++){
+		for (int8_t dir=1; dir>=-1; dir-=2){
+			long approach[2] = {target - dir*BACKLASH_CALIBRATION_DISTANCE, target};
+			for (uint8_t m=0; m<2; m++){
+				smartServos.moveTo(servoId+1, approach[m], SERVO_MAX_SPEED_RPM);
+				markJointCommanded(servoId, approach[m]);
+				waitUntilIsReady();
+			}
+			sum -= dir*getActAngle(servoId);
+		}
+	}
+	
+	float backlash = (float)sum / BACKLASH_CALIBRATION_REPETITIONS;
+	if (backlash < 0) backlash = 0;
+	Serial.print(F("Backlash: "));
+	Serial.print(backlash);
+	Serial.println(F(" degrees"));
+	return setBacklash(servoId, backlash);
+}
+
+bool morobotClass::setBacklash(uint8_t servoId, float backlash){
+	_backlash[servoId] = backlash;
+	if (_backlashMode == BACKLASH_FIRMWARE) return smartServos.setMotionCompensation(servoId+1, round(backlash));
+	return true;
+}
+
+float morobotClass::getBacklash(uint8_t servoId){
+	return _backlash[servoId];
+}
+
+bool morobotClass::setBacklashCompensation(uint8_t mode){
+	bool success = true;
+	_backlashMode = mode;
+	for (uint8_t i=0; i<_numSmartServos; i++){
+		if (mode == BACKLASH_FIRMWARE) success &= smartServos.setMotionCompensation(i+1, round(_backlash[i]));
+		else success &= smartServos.clrMotionCompensation(i+1);
+	}
+	if (!success) Serial.println(F("ERROR: Not all motors confirmed the backlash compensation"));
+	return success;
+}
+
+bool morobotClass::saveBacklash(uint16_t address){
+	return morobotStorage::write(address, STORAGE_TYPE_BACKLASH, _backlash, _numSmartServos*sizeof(float));
+}
+
+bool morobotClass::loadBacklash(uint16_t address){
+	float backlash[NUM_MAX_SERVOS];
+	if (!morobotStorage::read(address, STORAGE_TYPE_BACKLASH, backlash, _numSmartServos*sizeof(float))){
+		Serial.println(F("No backlash stored, the backlash is not compensated"));
+		return false;
+	}
+	bool success = true;
+	for (uint8_t i=0; i<_numSmartServos; i++) success &= setBacklash(i, backlash[i]);
+	return success;
+}
+
 /* HELPER */
 void morobotClass::printAngles(long angles[]){
 	for (uint8_t i=0; i<_numSmartServos; i++) {
@@ -799,6 +1679,7 @@ void morobotClass::autoCalibrateLinearAxis(uint8_t servoId, uint8_t maxMotorCurr
 		if (getCurrent(servoId) > 25) break;
 	}
 	smartServos.setZero(servoId+1);
+	invalidateJointState();
 	Serial.println(F("Linear axis set zero!"));
 }
 
@@ -808,12 +1689,118 @@ bool morobotClass::checkForNANerror(uint8_t servoId, float angle){
 		Serial.print(F("Angle for motor "));
 		Serial.print(servoId);
 		Serial.println(F(" is NAN!"));
+		setAngleError(PATH_CHECK_UNREACHABLE, servoId);
 		_tcpPoseIsValid = false;
 		return false;
 	}
 	return true;
 }
 
+void morobotClass::markJointCommanded(uint8_t servoId, long angle, bool angleIsKnown){
+	_commandedAngles[servoId] = angle;
+	_commandedIsValid[servoId] = angleIsKnown;
+	if (angleIsKnown) _estimators[servoId].clearCommandedVelocity(micros());	// Position controlled by the motor
+	_measuredIsValid[servoId] = false;
+	_angleReached[servoId] = false;
+	_tcpPoseIsValid = false;
+}
+
+bool morobotClass::calculatePathAngles(const float point[3], long angles[]){
+	if (calculateGoalAngles(point) == false){
+		Serial.print(F("ERROR: Point of path is not reachable: "));
+		Serial.print(point[0]);
+		Serial.print(", ");
+		Serial.print(point[1]);
+		Serial.print(", ");
+		Serial.println(point[2]);
+		return false;
+	}
+	for (uint8_t i=0; i<_numSmartServos; i++) angles[i] = _goalAngles[i];
+	return true;
+}
+
+bool morobotClass::calculateGoalAngles(const float point[3]){
+	return calculateAngles(point[0], point[1], point[2]);
+}
+
+bool morobotClass::measureStepResponse(uint8_t servoId, long goal, unsigned long* settleTime, float* overshoot){
+	float sign = (goal >= getActAngle(servoId)) ? 1 : -1;
+	*settleTime = PID_TUNE_TIMEOUT;
+	*overshoot = 0;
+
+	smartServos.moveTo(servoId+1, goal, SERVO_MAX_SPEED_RPM);
+	markJointCommanded(servoId, goal);
+	_backlashOffset[servoId] = 0;
+	unsigned long startTime = millis();
+	unsigned long toleranceTime = 0;
+	bool inTolerance = false;
+	while (millis()-startTime < PID_TUNE_TIMEOUT){
+		long angle = getActAngle(servoId);
+		unsigned long now = millis();
+
+		if (sign*(angle-goal) > *overshoot) *overshoot = sign*(angle-goal);
+		if (*overshoot > PID_TUNE_MAX_OVERSHOOT) return false;
+
+		// The motor has settled when the angle stays within the tolerance for PID_TUNE_HOLD_TIME
+		if (abs(angle-goal) <= PID_TUNE_TOLERANCE){
+			if (!inTolerance) toleranceTime = now;
+			inTolerance = true;
+			if (now-toleranceTime >= PID_TUNE_HOLD_TIME){
+				*settleTime = toleranceTime-startTime;
+				return true;
+			}
+		} else inTolerance = false;
+	}
+	return false;
+}
+
+long morobotClass::getBacklashOffset(uint8_t servoId, long goalAngle){
+	long offset = 0;
+	if (_backlashMode == BACKLASH_TRAJECTORY) {
+		// The direction only changes if the motor moves
+		long knownAngle = getKnownAngle(servoId);
+		if (goalAngle > knownAngle) _backlashDirection[servoId] = 1;
+		else if (goalAngle < knownAngle) _backlashDirection[servoId] = -1;
+		
+		// Coming from below, the motor stops half the backlash short of the goal; coming from above, half the backlash beyond it
+		offset = round(_backlashDirection[servoId] * _backlash[servoId] / 2);
+	}
+	_backlashOffset[servoId] = offset;
+	return offset;
+}
+
+void morobotClass::sendPwm(uint8_t servoId, float pwm){
+	checkServoResponse(servoId, smartServos.setPwmMove(servoId+1, pwm));
+	_estimators[servoId].setCommandedVelocity(calcVelocity(servoId, pwm), micros());
+}
+
+bool morobotClass::seedEstimators(){
+	for (uint8_t i=0; i<_numSmartServos; i++) {
+		if (_estimators[i].isValid()) continue;
+		getActAngle(i);
+		if (_estimators[i].isValid()) continue;
+		Serial.print(F("ERROR: Angle of motor "));
+		Serial.print(i);
+		Serial.println(F(" could not be read, the movement is not started"));
+		return false;
+	}
+	return true;
+}
+
+bool morobotClass::checkServoResponse(uint8_t servoId, bool success){
+	if (success) return true;
+	Serial.print(F("ERROR: Motor "));
+	Serial.print(servoId);
+	switch (smartServos.getLastError(servoId+1)) {
+		case PROCESS_BUSY: Serial.println(F(" is busy")); break;
+		case PROCESS_ERROR: Serial.println(F(" could not execute the command")); break;
+		case WRONG_TYPE_OF_SERVICE: Serial.println(F(" does not support the command")); break;
+		case SERVO_BAD_CHECKSUM: Serial.println(F(" sent a corrupted response")); break;
+		default: Serial.println(F(" did not respond")); break;
+	}
+	return false;
+}
+
 void morobotClass::printInvalidAngleError(uint8_t servoId, float angle){
 	// Moving the motors out of the joint limits may harm the robot's mechanics
 	Serial.print(F("Angle for motor "));
@@ -821,15 +1808,32 @@ void morobotClass::printInvalidAngleError(uint8_t servoId, float angle){
 	Serial.print(F(" is invalid! ("));
 	Serial.print(angle);
 	Serial.println(F(" degrees)."));
+	setAngleError(PATH_CHECK_JOINT_LIMIT, servoId);
 	_tcpPoseIsValid = false;
 }
 
+void morobotClass::setAngleError(uint8_t error, uint8_t servoId){
+	_angleError = error;
+	_angleErrorJoint = servoId;
+}
+
 /* ROBOT STATUS PRIVATE */
 bool morobotClass::isReady(){
 	for (uint8_t i=0; i<_numSmartServos; i++) {
 		if (_angleReached[i] == false) {
-			if (checkIfMotorMoves(i) == false) continue;
-			return false;
+			// A motor reports when it reached its goal, one reading confirms it (the report could belong to an older movement)
+			if (_commandedIsValid[i] && smartServos.getPositionReached(i+1)) {
+				long angle = getActAngle(i);
+				if (labs(_commandedAngles[i] + _backlashOffset[i] - angle) <= POSITION_REACHED_TOLERANCE) {
+					_measuredAngles[i] = angle - _backlashOffset[i];
+					_measuredIsValid[i] = true;
+					_estimators[i].setCommandedVelocity(0, micros());
+					_angleReached[i] = true;
+					continue;
+				}
+			}
+			if (checkIfMotorMoves(i) == true) return false;
+			_angleReached[i] = true;
 		}
 	}
 	return true;
@@ -6,8 +6,16 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobotClass(uint8_t numSmartServos);
-			void begin(const char* stream);
+ *  		void begin(const char* stream);
+			void begin(Stream& port);
+			void begin(servoTransport& transport);
+			bool beginFast(const char* stream, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			bool beginFast(Stream& port, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			bool beginFast(servoTransport& transport, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			static bool beginAll(morobotClass* robots[], const char* streams[], uint8_t numRobots, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			static bool beginAll(morobotClass* robots[], Stream* ports[], uint8_t numRobots, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+			unsigned long getBootTime();
+			void printTopology();
 			void setZero();
 			void moveHome();
 			void setSpeedRPM(uint8_t speed);
@@ -20,9 +28,20 @@
 			void setBusy();
 			void setIdle();
 			void waitUntilIsReady();
+			bool waitUntilNear(float distance);
 			bool checkIfMotorMoves(uint8_t servoId);
+			void invalidateJointState();
+			servo_error_type getBusErrors(uint8_t servoId);
+			void resetBusErrors();
+			void printBusErrors();
+			servo_bus_stats_type getBusStats();
+			bool getRttHistogram(uint8_t servoId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]);
+			void resetBusStats();
+			void printBusStats();
 			
 			long getActAngle(uint8_t servoId);
+			long getKnownAngle(uint8_t servoId);
+			joint_estimate_type getEstimate(uint8_t servoId);
 			float getActPosition(char axis);
 			float getActOrientation(char axis);
 			float getSpeed(uint8_t servoId);
@@ -42,32 +61,83 @@
 			void moveAngles(long angles[]);
 			void moveAngles(long angles[], uint8_t speedRPM);
 			bool moveToPose(float x, float y, float z);
+			bool moveToPoseTimed(float x, float y, float z, float duration);
 			bool moveXYZ(float xOffset, float yOffset, float zOffset);
 			bool moveInDirection(char axis, float value);
 			
 			void trajectoryPlanning(float points[][3], int nrPoints, int continuousMovement = 0, int polynomOrder = 3);
+			void trajectoryPlanning(pathSource* path, int continuousMovement=0, int polynomOrder=3);
 			void moveLinear(float goalPoint[], int continuousMovement=1, float resolution=5,int useTrajectoryPlanning = 0);
-			float calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime);
-			float calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime);
+			void followPath(pathSource* path, int continuousMovement=1);
+			bool moveLinearTracked(float goalPoint[], float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR);
+			virtual bool moveAlongPath(pathSource* path, float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR)=0;
+			bool moveCircular(float point[], float goalPoint[], uint8_t mode=ARC_CENTER_CCW, float tcpSpeed=LINE_TRACKING_SPEED);
+			bool moveSpline(float points[][3], uint16_t nrPoints, uint8_t type=SPLINE_CATMULL_ROM, float tcpSpeed=LINE_TRACKING_SPEED);
+			tracking_stats_type getTrackingStats();
+			virtual bool checkPath(pathSource* path, float tcpSpeed=0, path_check_type* report=NULL)=0;
+			float calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId=-1);
+			float calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId=-1);
 			float calcIntermediateVelocity(float time, float q0, float q1, float q2);
+			float calcTrapezoidalProfile(float time, float length, float maxVel, float acc);
 			float calcPwm(float deg_per_sec);
+			float calcVelocity(float pwm);
+			float calcPwm(uint8_t servoId, float deg_per_sec);
+			float calcVelocity(uint8_t servoId, float pwm);
+			bool identifyPwmModel(uint8_t servoId);
+			bool savePwmModels(uint16_t address=STORAGE_PWM_ADDRESS);
+			bool loadPwmModels(uint16_t address=STORAGE_PWM_ADDRESS);
+			void printPwmModel(uint8_t servoId);
+			
+			bool setPid(uint8_t servoId, pid_gains_type gains);
+			bool getPid(uint8_t servoId, pid_gains_type* gains);
+			bool tunePid(uint8_t servoId);
+			bool savePidProfiles(uint16_t address=STORAGE_PID_ADDRESS);
+			bool loadPidProfiles(uint16_t address=STORAGE_PID_ADDRESS);
+			bool calibrateBacklash(uint8_t servoId);
+			bool setBacklash(uint8_t servoId, float backlash);
+			float getBacklash(uint8_t servoId);
+			bool setBacklashCompensation(uint8_t mode);
+			bool saveBacklash(uint16_t address=STORAGE_BACKLASH_ADDRESS);
+			bool loadBacklash(uint16_t address=STORAGE_BACKLASH_ADDRESS);
 
 			void printAngles(long angles[]);
 			void printTCPpose();
 			float convertToDeg(float angle);
 			float convertToRad(float angle);
-			virtual String getType();
+			virtual const char* getType();
+			virtual uint8_t getTypeId();
 		protected:
 			virtual bool calculateAngles(float x, float y, float z);
 			virtual void updateTCPpose(bool output);
 			void autoCalibrateLinearAxis(uint8_t servoId, uint8_t maxMotorCurrent=25);
+			void markJointCommanded(uint8_t servoId, long angle, bool angleIsKnown=true);
+			void sendPwm(uint8_t servoId, float pwm);
+			bool seedEstimators();
+			bool calculatePathAngles(const float point[3], long angles[]);
+			virtual bool calculateGoalAngles(const float point[3]);
+			bool measureStepResponse(uint8_t servoId, long goal, unsigned long* settleTime, float* overshoot);
+			long getBacklashOffset(uint8_t servoId, long goalAngle);
+			bool checkServoResponse(uint8_t servoId, bool success);
+			static Stream* openPort(const char* stream);
+			void attachPort(Stream& port);
+			void startMotors(unsigned long startTime);
+			bool startMotorsFast(unsigned long startTime, uint16_t address);
+			bool probeTopology(uint16_t address);
+			bool storeTopology(uint16_t address);
+			void finishBegin(unsigned long startTime, bool cached);
+			template <uint8_t N> void attachJointStorage(morobotJointStorage<N>* storage);
+			void initJointStorage();
 		private:
+			morobotClass(uint8_t numSmartServos);
 			bool isReady();
  */
 
 #include <Arduino.h>
 #include "MakeblockSmartServo.h"
 #include "eef.h"
+#include "estimator.h"
+#include "path.h"
+#include "storage.h"
 #include <math.h> 
 
 #include "morobot_s_rrr.h"
@@ -81,17 +151,112 @@
 
 #define BREAK_LOOSE  1			//!< Defines if a break of a smart-servo is loose
 #define BREAK_BRAKED 0			//!< Defines if a break of a smart-servo is set
-#define NUM_MAX_SERVOS 10		//!< Maximum number of smart servos usable in one robot object
+#ifndef NUM_MAX_SERVOS
+#define NUM_MAX_SERVOS SMART_SERVO_MAX_DEVICES	//!< Maximum number of smart servos usable in one robot object (bounds temporary joint arrays)
+#endif
+#define NUM_MAX_ROBOTS 8		//!< Maximum number of robots started together by beginAll()
 #define TIMEOUT_DELAY 15000		//!< Delaytime until the robot stops waiting for motors to finish their movement
+#define POSITION_REACHED_TOLERANCE 2	//!< Distance in degrees to the goal at which a motor which reported reaching its position is finished
+
+#define ROBOT_TYPE_S_RRR 1		//!< Type id of morobot_s_rrr (getTypeId())
+#define ROBOT_TYPE_S_RRP 2		//!< Type id of morobot_s_rrp
+#define ROBOT_TYPE_2D 3			//!< Type id of morobot_2d
+#define ROBOT_TYPE_3D 4			//!< Type id of morobot_3d
+#define ROBOT_TYPE_P 5			//!< Type id of morobot_p
+#define ROBOT_TYPE_CUSTOM 100	//!< First type id for robot classes which are not part of the library
+
+#define LINE_TRACKING_PERIOD 20			//!< Cycle time of the line tracking controller in ms
+#define LINE_TRACKING_SPEED 20.0		//!< Default TCP speed of tracked linear movements in mm/s
+#define LINE_TRACKING_ACCELERATION 50.0	//!< TCP acceleration of tracked linear movements in mm/s^2
+#define LINE_TRACKING_GAIN 4.0			//!< Proportional gain of the joint feedback in 1/s
+#define LINE_TRACKING_MAX_ERROR 5.0		//!< Default joint tracking error in degrees at which the reference pauses until the robot catches up
+#define LINE_TRACKING_TIMEOUT 2000		//!< Time in ms the reference may pause before the movement is aborted
+
+typedef struct {
+	float maxError;				//!< Maximum tracking error of a joint in degrees
+	float rmsError;				//!< Root mean square of the largest joint error of every cycle in degrees
+	unsigned long duration;		//!< Duration of the movement in ms
+	uint16_t numCycles;			//!< Number of controller cycles
+	uint16_t numPauses;			//!< Number of cycles in which the reference paused because the error was too large
+	uint16_t numOverruns;		//!< Number of cycles which took longer than LINE_TRACKING_PERIOD
+} tracking_stats_type;
+
+#define PATH_CHECK_OK			0	//!< All points of the path can be reached
+#define PATH_CHECK_UNREACHABLE	1	//!< The inverse kinematics has no solution for a point
+#define PATH_CHECK_JOINT_LIMIT	2	//!< An angle is outside of the joint limits
+#define PATH_CHECK_COUPLING		3	//!< The angles violate a constraint between joints (e.g. motor 2 and 3 of morobot_p)
+#define PATH_CHECK_VELOCITY		4	//!< A joint would have to move faster than the motors at the given TCP speed
+
+typedef struct {
+	uint8_t error;			//!< Result of the check (PATH_CHECK_OK, PATH_CHECK_...)
+	int16_t index;			//!< Index of the first point which failed (interpolation point or cycle of moveAlongPath(), -1 if the path is valid)
+	uint8_t joint;			//!< Motor which failed (first motor has ID 0)
+	float point[3];			//!< Point which failed
+	uint16_t numPoints;		//!< Number of points checked
+	float maxJointVel;		//!< Highest joint velocity in degrees/s at the given TCP speed (0 if no speed is given)
+} path_check_type;
+
+#define PWM_MODEL_SIZE 6				//!< Number of measured PWM values per direction in a PWM model
+#define PWM_MODEL_STEPS {2, 5, 10, 20, 35, 55}	//!< PWM values above the deadband which are measured by identifyPwmModel()
+#define PWM_MODEL_MAX_DEADBAND 40		//!< Maximum PWM value identifyPwmModel() tries to start a motor with
+#define PWM_MODEL_MIN_TRAVEL 3			//!< Angle in degrees a motor must move to be detected as moving
+#define PWM_MODEL_MARGIN 10				//!< Distance in degrees to the joint limits kept during the identification
+#define PWM_MODEL_SETTLE_TIME 150		//!< Time in ms a motor accelerates before its velocity is measured
+#define PWM_MODEL_MEASURE_TIME 1500		//!< Maximum time in ms the velocity is measured
+
+typedef struct {
+	uint8_t deadband[2];					//!< Smallest PWM value which moves the motor (index 0: negative, 1: positive direction)
+	uint8_t pwm[2][PWM_MODEL_SIZE];			//!< Measured PWM values (absolute values)
+	int16_t velocity[2][PWM_MODEL_SIZE];	//!< Velocity in 1/10 degrees per second at the measured PWM values (absolute values)
+} pwm_model_type;
+
+#define PID_TUNE_NUM_FACTORS 6					//!< Number of gain sets tested by tunePid()
+#define PID_TUNE_FACTORS {0.5, 0.75, 1.0, 1.5, 2.0, 3.0}	//!< Factors the original gains of a motor are multiplied with by tunePid() (ascending)
+#define PID_TUNE_STEP 30						//!< Size of the test steps in degrees
+#define PID_TUNE_MARGIN 10						//!< Distance in degrees to the joint limits kept during the tuning
+#define PID_TUNE_TOLERANCE 1					//!< A motor has settled if its angle stays within this distance in degrees to the goal
+#define PID_TUNE_HOLD_TIME 200					//!< Time in ms the angle must stay within the tolerance
+#define PID_TUNE_MAX_OVERSHOOT 3				//!< Largest accepted overshoot in degrees
+#define PID_TUNE_TIMEOUT 3000					//!< Time in ms a motor may take to settle after a step
+
+typedef struct {
+	float p;		//!< Proportional gain
+	float i;		//!< Integral gain
+	float d;		//!< Derivative gain
+} pid_gains_type;
+
+#define BACKLASH_OFF 0							//!< Backlash is not compensated
+#define BACKLASH_TRAJECTORY 1					//!< Backlash is compensated by the position commands of the library
+#define BACKLASH_FIRMWARE 2						//!< Backlash is compensated by the motors (motion compensation)
+#define BACKLASH_CALIBRATION_DISTANCE 20		//!< Distance in degrees from which calibrateBacklash() approaches the test angle
+#define BACKLASH_CALIBRATION_REPETITIONS 4		//!< Number of approaches from each direction done by calibrateBacklash()
+
+typedef struct {
+	uint8_t numServos;										//!< Number of motors found at the last enumeration
+	char version[NUM_MAX_SERVOS][SERVO_VERSION_LENGTH];		//!< Firmware versions of the motors (not zero terminated if they have SERVO_VERSION_LENGTH characters)
+} servo_topology_type;
+
+/**
+ *  \brief Per-joint state of a robot, sized exactly for the number of motors by morobotBase
+ */
+template <uint8_t N>
+struct morobotJointStorage {
+	bool angleReached[N];				//!< Variables that indicate if a motor is busy (is moving and has not reached final position)
+	float goalAngles[N];				//!< Variable for inverse kinematics to store goal Angles of the motors
+	long commandedAngles[N];			//!< Joint state: last goal angle sent to each motor
+	long measuredAngles[N];				//!< Joint state: last angle read from each motor without the backlash offset (joint angle)
+	bool commandedIsValid[N];			//!< Joint state: false if the goal angle of a motor is not known (e.g. after PWM movements)
+	bool measuredIsValid[N];			//!< Joint state: false (dirty) if a motor has been moved since its angle was read
+	pwm_model_type pwmModels[N];		//!< Identified PWM models of the motors
+	bool pwmModelIsValid[N];			//!< False if a motor has not been identified (the default model is used)
+	float backlash[N];					//!< Backlash of the motors in degrees
+	int8_t backlashDirection[N];		//!< Direction of the last movement of each motor (1, -1 or 0 if unknown)
+	long backlashOffset[N];				//!< Offset included in the last position command of each motor
+	jointStateEstimator estimators[N];	//!< Joint state: estimated angle and velocity of each motor between readings
+};
 
 class morobotClass {
 	public:
-		/**
-		 *  \brief Constructor of morobot class
-		 *  \param [in] numSmartServos Number of smart servos of the robot
-		 */
-		morobotClass(uint8_t numSmartServos);
-		
 		/**
 		 *  \brief Starts the communication with the smartservos of the robot
 		 *  \param [in] stream Name of serial port (e.g. "Serial1").
@@ -99,6 +264,76 @@ class morobotClass {
 		 */
 		void begin(const char* stream);
 		
+		/**
+		 *  \brief Starts the communication with the smartservos of the robot on a port started by the sketch
+		 *  \param [in] port Serial port the robot is connected to (e.g. Serial1), started with 115200 baud
+		 */
+		void begin(Stream& port);
+		
+		/**
+		 *  \brief Starts the communication with the smartservos of the robot through a transport (e.g. esp32UartTransport, see transport.h)
+		 *  \param [in] transport Started transport the robot is connected to
+		 */
+		void begin(servoTransport& transport);
+		
+		/**
+		 *  \brief Starts the communication with the smartservos of the robot using the motors found at the last start
+		 *  \details The motors keep their IDs while they are powered. If the number and firmware versions of the motors are stored
+		 *  		 and the last motor of the chain answers a single probe, the enumeration of the motors is skipped (e.g. after a reset of the microcontroller).
+		 *  		 Otherwise the motors are enumerated and the result is stored for the next start.
+		 *  		 In contrast to begin() the TCP pose is not read, it is calculated when it is needed the first time.
+		 *  \param [in] stream Name of serial port (e.g. "Serial1").
+		 *  \param [in] address (Optional) Address of the stored motors in the EEPROM (use different addresses for different robots)
+		 *  \return Returns false if not all motors of the robot answered
+		 */
+		bool beginFast(const char* stream, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+		
+		/**
+		 *  \brief Starts the robot like beginFast() on a port started by the sketch
+		 *  \param [in] port Serial port the robot is connected to (e.g. Serial1), started with 115200 baud
+		 *  \param [in] address (Optional) Address of the stored motors in the EEPROM (use different addresses for different robots)
+		 *  \return Returns false if not all motors of the robot answered
+		 */
+		bool beginFast(Stream& port, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+		
+		/**
+		 *  \brief Starts the robot like beginFast() through a transport (e.g. esp32UartTransport, see transport.h)
+		 *  \param [in] transport Started transport the robot is connected to
+		 *  \param [in] address (Optional) Address of the stored motors in the EEPROM (use different addresses for different robots)
+		 *  \return Returns false if not all motors of the robot answered
+		 */
+		bool beginFast(servoTransport& transport, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+		
+		/**
+		 *  \brief Starts several robots on separate serial ports like beginFast(), the motors of all robots which must be enumerated are enumerated at the same time
+		 *  \param [in] robots Pointers to the robots
+		 *  \param [in] streams Names of the serial ports of the robots (e.g. {"Serial1", "Serial2"})
+		 *  \param [in] numRobots Number of robots
+		 *  \param [in] address (Optional) Address of the stored motors of the first robot in the EEPROM, the others follow
+		 *  \return Returns false if not all motors of all robots answered
+		 */
+		static bool beginAll(morobotClass* robots[], const char* streams[], uint8_t numRobots, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+		
+		/**
+		 *  \brief Starts several robots like beginAll() on ports started by the sketch
+		 *  \param [in] robots Pointers to the robots
+		 *  \param [in] ports Serial ports of the robots (e.g. {&Serial1, &Serial2}), started with 115200 baud
+		 *  \param [in] numRobots Number of robots
+		 *  \param [in] address (Optional) Address of the stored motors of the first robot in the EEPROM, the others follow
+		 *  \return Returns false if not all motors of all robots answered
+		 */
+		static bool beginAll(morobotClass* robots[], Stream* ports[], uint8_t numRobots, uint16_t address=STORAGE_TOPOLOGY_ADDRESS);
+		
+		/**
+		 *  \brief Returns the time in ms the last begin(), beginFast() or beginAll() took until the robot was ready
+		 */
+		unsigned long getBootTime();
+		
+		/**
+		 *  \brief Prints the number of motors, their firmware versions and how long the start took to the serial monitor
+		 */
+		void printTopology();
+		
 		/**
 		 *  \brief Sets the current position as origin (zero position)
 		 *  \details Call this function after bringing the motors into their initial (zero position) to store it permanently as 0 degrees
@@ -169,10 +404,21 @@ class morobotClass {
 		/**
 		 *  \brief Waits until the robot is ready for new commants (all motors have stopped moving) or a timeout occurs.
 		 *  \details Function sets the robot idle only when all motors have stopped moving or a timeout occurs.
+		 *  		 Only motors which have been moved since they were last seen idle are checked, so the function returns immediately if the robot has not been moved.
 		 *  		 If a timeout occurs this is printed to the serial monitor.
 		 */
 		void waitUntilIsReady();
 		
+		/**
+		 *  \brief Waits until the TCP is closer than a distance to the goal of the last moveToPose() (e.g. to start the gripper before the robot arrives).
+		 *  \details The remaining distance is estimated from the joint with the longest remaining way, relative to the whole movement,
+		 *  		 as the TCP does not move on a straight line between start and goal. The motors keep moving meanwhile.
+		 *  		 Use this function with waitAfterEachMove = false or call it directly after moveToPose() (which only waits before a movement).
+		 *  \param [in] distance Remaining distance in mm at which the function returns
+		 *  \return Returns true if the TCP is near the goal, false if a timeout occured
+		 */
+		bool waitUntilNear(float distance);
+		
 		/**
 		 *  \brief Check if a given smart servo is moving at the moment.
 		 *  		Function stores current angle of motor, waits some time and compares the angle before and after waiting.
@@ -181,6 +427,56 @@ class morobotClass {
 		 */
 		bool checkIfMotorMoves(uint8_t servoId);
 		
+		/**
+		 *  \brief Marks the stored joint state (commanded and last read angles) of all motors as unknown, so the angles are read from the motors again.
+		 *  \details Call this function after moving the motors without the movement-functions of this class (e.g. directly with smartServos or by hand).
+		 */
+		void invalidateJointState();
+		
+		/**
+		 *  \brief Returns the communication errors of a motor (timeouts, corrupted responses, busy and error responses, retries)
+		 *  \details Commands which fail are repeated up to SERVO_MAX_RETRIES times, so errors do not necessarily stop the robot.
+		 *  		 Rising counters indicate a bad cable or connector.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 */
+		servo_error_type getBusErrors(uint8_t servoId);
+		
+		/**
+		 *  \brief Resets the communication error counters of all motors
+		 */
+		void resetBusErrors();
+		
+		/**
+		 *  \brief Prints the communication error counters of all motors to the serial monitor
+		 */
+		void printBusErrors();
+		
+		/**
+		 *  \brief Returns the load of the bus to the motors (transactions, bytes sent and received, time waiting for responses and processing them in us)
+		 *  \details Divide the waiting time by the duration of a movement to see how much of it is spent on communication.
+		 *  		 Only recorded if SMART_SERVO_STATS is set (not on boards with little RAM like the Arduino Uno).
+		 */
+		servo_bus_stats_type getBusStats();
+		
+		/**
+		 *  \brief Returns the histogram of the round trip times of the commands of a type sent to a motor
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] type Command type (SERVO_STATS_MOVE, SERVO_STATS_PWM, SERVO_STATS_READ, SERVO_STATS_CONFIG)
+		 *  \param [out] histogram Number of responses per bucket, bucket k counts round trip times below SERVO_STATS_FIRST_BUCKET*2^k us (the last one all longer ones)
+		 *  \return Returns false if the histograms are not recorded
+		 */
+		bool getRttHistogram(uint8_t servoId, uint8_t type, uint16_t histogram[SERVO_STATS_BUCKETS]);
+		
+		/**
+		 *  \brief Resets the bus load and the round trip time histograms of all motors
+		 */
+		void resetBusStats();
+		
+		/**
+		 *  \brief Prints the bus load, the round trip time histograms and the current response timeouts of all motors to the serial monitor
+		 */
+		void printBusStats();
+		
 		/* GETTERS */
 		/**
 		 *  \brief Returns angle-position of motor in degrees.
@@ -189,6 +485,24 @@ class morobotClass {
 		 */
 		long getActAngle(uint8_t servoId);
 		
+		/**
+		 *  \brief Returns the angle of a motor from the stored joint state without accessing the bus if possible.
+		 *  \details Returns the last read angle if the motor has not been moved since, otherwise the last commanded goal angle.
+		 *  		 The angle is only read from the motor if neither is known. Read angles are returned without the backlash offset of the last
+		 *  		 position command (see setBacklashCompensation()), so the result is the joint angle relative movements start from.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \return Angle in degrees the motor is at (or moving to).
+		 */
+		long getKnownAngle(uint8_t servoId);
+		
+		/**
+		 *  \brief Returns the estimated angle and velocity of a motor at the current time without accessing the bus.
+		 *  \details The estimate is corrected by every call of getActAngle() and getSpeed() and follows commanded PWM values in between.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \return Estimated angle (degrees), velocity (degrees per second), time of the estimate and time since the last reading (microseconds).
+		 */
+		joint_estimate_type getEstimate(uint8_t servoId);
+		
 		/**
 		 *  \brief Returns position of TCP in mm in given axis (in robot base frame).
 		 *  \param [in] axis Possible parameters: 'x', 'y', 'z'
@@ -343,6 +657,18 @@ class morobotClass {
 		 */
 		bool moveToPose(float x, float y, float z);
 		
+		/**
+		 *  \brief Moves the TCP (tool center point) of the robot to a desired position within a given time.
+		 * 			Does NOT wait until the robot is ready. The speed of each motor is chosen so all motors reach their goal angles at the same time.
+		 *			Use this function to stream closely spaced points of a path (e.g. G-code): send the next point when the duration of the previous one is over.
+		 *  \param [in] x Desired x-coordinate of the TCP in mm (in base frame)
+		 *  \param [in] y Desired y-coordinate of the TCP in mm (in base frame)
+		 *  \param [in] z Desired z-coordinate of the TCP in mm (in base frame)
+		 *  \param [in] duration Time in seconds the movement should take
+		 *  \return Returns true if the position is reachable; false if it is not.
+		 */
+		bool moveToPoseTimed(float x, float y, float z, float duration);
+		
 		/**
 		 *  \brief Moves the TCP (tool center point) of the robot by given axis-values.
 		 *  		Calls child class to solve forward kinematics, adds values, solves inverse kinematics and moves the robot to the position.
@@ -375,15 +701,99 @@ class morobotClass {
 		 */
 		void trajectoryPlanning(float points[][3], int nrPoints, int continuousMovement = 0, int polynomOrder = 3);
 
+		/**
+		 *  \brief Uses trajectory planning to move the robot through the interpolation points of a path.
+		 *  \details The inverse kinematics of a point is calculated when it is approached, so the memory used does not depend on the number of points.
+		 *  \param [in] path Path to move along (e.g. waypointPath, linePath)
+		 *  \param [in] continuousMovement (Optional) For a continuous movement set this parameter to 1
+		 *  \param [in] polynomOrder (Optional) Choose between third- (=3) and fifth-order (=5) polynomials
+		 */
+		void trajectoryPlanning(pathSource* path, int continuousMovement=0, int polynomOrder=3);
+
 		/**
 		 *  \brief Move the robot along a line
 		 *  \param [in] goalPoint[] Goal pose with x-, y- and z-value
 		 *  \param [in] continuousMovement (Optional) For a continuous movement set this parameter to 1
 		 *  \param [in] resolution (Optional) Set the resolution of the line in mm
-		 *  \param [in] useTrajectoryPlanning (Optional) If you want to use trajectory planning for the linear movement, set this parameter to 1 (method: third-order polynomials)
+		 *  \param [in] useTrajectoryPlanning (Optional) If you want to use trajectory planning for the linear movement, set this parameter to 1 (method: third-order polynomials) or to 2 to use moveLinearTracked()
 		 */
 		void moveLinear(float goalPoint[], int continuousMovement=1, float resolution=5,int useTrajectoryPlanning = 0);
 
+		/**
+		 *  \brief Move the robot through the interpolation points of a path (method of moveLinear())
+		 *  \details The inverse kinematics of a point is calculated when it is approached, so the memory used does not depend on the number of points.
+		 *  \param [in] path Path to move along (e.g. linePath, waypointPath)
+		 *  \param [in] continuousMovement (Optional) For a continuous movement set this parameter to 1
+		 */
+		void followPath(pathSource* path, int continuousMovement=1);
+
+		/**
+		 *  \brief Move the TCP along a line with a given speed using a closed-loop controller running every LINE_TRACKING_PERIOD ms
+		 *  \details The line is time-parameterized with a trapezoidal speed profile. In every cycle the joint velocities are calculated from the
+		 *  		 inverse kinematics of the next reference point (feedforward) plus a feedback on the estimated joint angles (see getEstimate()).
+		 *  		 Only one motor is read per cycle. If the error of a joint exceeds maxDeviation, the reference waits until the robot catches up.
+		 *  		 At the end the motors are positioned exactly on the goal point. The tracking errors can be read with getTrackingStats().
+		 *  \param [in] goalPoint[] Goal pose with x-, y- and z-value
+		 *  \param [in] tcpSpeed (Optional) Speed of the TCP in mm/s
+		 *  \param [in] maxDeviation (Optional) Maximum joint tracking error in degrees
+		 *  \return Returns false if a point of the line is not reachable or the robot did not follow the reference
+		 */
+		bool moveLinearTracked(float goalPoint[], float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR);
+
+		/**
+		 *  \brief Move the TCP along a path with a given speed using the closed-loop controller of moveLinearTracked()
+		 *  \details The path must start at the current position of the TCP. The points are calculated from the distance along the path (see pathSource::getPointAt()).
+		 *  Triggers of the path fire in the cycle in which the reference passes them. Triggers not passed yet fire at the goal. An aborted movement fires no more triggers
+		 *  and calls the cancel function of those which fired (e.g. to switch off a pump, see pathTrigger).
+		 *  Implemented by morobotBase, which calls the inverse kinematics of the robot class in every cycle without virtual function call.
+		 *  \param [in] path Path to move along
+		 *  \param [in] tcpSpeed (Optional) Speed of the TCP in mm/s
+		 *  \param [in] maxDeviation (Optional) Maximum joint tracking error in degrees
+		 *  \return Returns false if a point of the path is not reachable or the robot did not follow the reference
+		 */
+		virtual bool moveAlongPath(pathSource* path, float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR)=0;
+
+		/**
+		 *  \brief Move the TCP along an arc from the current position to a goal point with constant speed (see moveAlongPath())
+		 *  \details To switch end effectors on the way, add triggers to a circularPath and call moveAlongPath() with it.
+		 *  \param [in] point[] Center of the arc (ARC_CENTER_CW, ARC_CENTER_CCW) or a point on the arc between the current position and the goal (ARC_THREE_POINT)
+		 *  \param [in] goalPoint[] Goal pose with x-, y- and z-value (a full circle if it is equal to the current position and the center is given)
+		 *  \param [in] mode (Optional) Definition of the arc (ARC_CENTER_CW, ARC_CENTER_CCW, ARC_THREE_POINT)
+		 *  \param [in] tcpSpeed (Optional) Speed of the TCP in mm/s
+		 *  \return Returns false if a point of the arc is not reachable or the robot did not follow the reference
+		 */
+		bool moveCircular(float point[], float goalPoint[], uint8_t mode=ARC_CENTER_CCW, float tcpSpeed=LINE_TRACKING_SPEED);
+
+		/**
+		 *  \brief Move the TCP along a spline from the current position through (or along) the given points with constant speed (see moveAlongPath())
+		 *  \details To switch end effectors on the way, add triggers to a splinePath and call moveAlongPath() with it.
+		 *  \param [in] points[][3] Points of the spline with x-, y- and z-value (the last point is the goal)
+		 *  \param [in] nrPoints Number of points
+		 *  \param [in] type (Optional) SPLINE_CATMULL_ROM (passes through all points) or SPLINE_BSPLINE (smoother, only passes through the goal)
+		 *  \param [in] tcpSpeed (Optional) Speed of the TCP in mm/s
+		 *  \return Returns false if a point of the spline is not reachable or the robot did not follow the reference
+		 */
+		bool moveSpline(float points[][3], uint16_t nrPoints, uint8_t type=SPLINE_CATMULL_ROM, float tcpSpeed=LINE_TRACKING_SPEED);
+
+		/**
+		 *  \brief Returns the tracking error statistics of the last moveLinearTracked() or moveAlongPath() movement
+		 */
+		tracking_stats_type getTrackingStats();
+
+		/**
+		 *  \brief Checks all points of a path before the robot moves (inverse kinematics, joint limits, constraints between joints and joint velocities)
+		 *  \details The check stops at the first point which fails. Only the inverse kinematics is calculated, so it is cheap enough to run before every movement.
+		 *  		followPath() and trajectoryPlanning() check the interpolation points, moveAlongPath() checks the points it commands at its speed before it starts.
+		 *  		Implemented by morobotBase, which calls the inverse kinematics of the robot class for every point without virtual function call.
+		 *  \param [in] path Path to check
+		 *  \param [in] tcpSpeed (Optional) Speed of the TCP in mm/s. If not given, the interpolation points are checked (see pathSource::next()).
+		 *  		If given, the points moveAlongPath() commands at this speed are checked instead (the start and one point every LINE_TRACKING_PERIOD ms),
+		 *  		together with the joint velocities between them against the maximum speed of the motors.
+		 *  \param [out] report (Optional) Result of the check with the first failing point
+		 *  \return Returns true if the whole path can be executed
+		 */
+		virtual bool checkPath(pathSource* path, float tcpSpeed=0, path_check_type* report=NULL)=0;
+
 		/**
 		 *  \brief Calculate the velocity of a joint in dependence of time with third-order polynomials
 		 *  \param [in] startAngle joint angle at the start position
@@ -392,8 +802,9 @@ class morobotClass {
 		 *  \param [in] endVel final velocity
 		 *  \param [in] time current time stamp
 		 *  \param [in] totalTime total time for the movement between the start and end point
+		 *  \param [in] servoId (Optional) Number of the motor whose PWM model is used to calculate the PWM value
 		 */
-		float calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime);
+		float calcPolynomThirdOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId=-1);
 
 		/**
 		 *  \brief Calculate the velocity of a joint in dependence of time with fifth-order polynomials
@@ -403,8 +814,9 @@ class morobotClass {
 		 *  \param [in] endVel final velocity
 		 *  \param [in] time current time stamp
 		 *  \param [in] totalTime total time for the movement between the start and end point
+		 *  \param [in] servoId (Optional) Number of the motor whose PWM model is used to calculate the PWM value
 		 */
-		float calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime);
+		float calcPolynomFifthOrder(int startAngle, int endAngle, float startVel, float endVel, float time, float totalTime, int8_t servoId=-1);
 
 		//Helper
 		/**
@@ -416,13 +828,161 @@ class morobotClass {
 		 */
 		float calcIntermediateVelocity(float time, float q0, float q1, float q2);
 
+		/**
+		 *  \brief Calculate the covered distance of a trapezoidal speed profile (triangular if the maximum velocity can not be reached)
+		 *  \param [in] time current time stamp in seconds
+		 *  \param [in] length total distance of the movement
+		 *  \param [in] maxVel maximum velocity
+		 *  \param [in] acc acceleration and deceleration
+		 *  \return Distance covered at the given time (length after the end of the movement)
+		 */
+		float calcTrapezoidalProfile(float time, float length, float maxVel, float acc);
+
 		/**
 		 *  \brief Convert the velocity from [°/sec] to a PWM value
 		 *  \param [in] deg_per_sec velocity in [°/sec]
 		 */
 		float calcPwm(float deg_per_sec);
+		
+		/**
+		 *  \brief Convert a PWM value to the resulting velocity in [°/sec] (inverse of calcPwm())
+		 *  \param [in] pwm PWM value
+		 */
+		float calcVelocity(float pwm);
+		
+		/**
+		 *  \brief Convert the velocity of a motor from [°/sec] to a PWM value using its identified PWM model (see identifyPwmModel())
+		 *  \details Uses calcPwm(deg_per_sec) if the motor has not been identified. The deadband of the motor is compensated.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] deg_per_sec velocity in [°/sec]
+		 */
+		float calcPwm(uint8_t servoId, float deg_per_sec);
+		
+		/**
+		 *  \brief Convert a PWM value of a motor to the resulting velocity in [°/sec] using its identified PWM model (inverse of calcPwm(servoId, deg_per_sec))
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] pwm PWM value
+		 */
+		float calcVelocity(uint8_t servoId, float pwm);
+		
+		/**
+		 *  \brief Measures the velocity of a motor at several PWM values in both directions and its deadband (smallest PWM value which moves the motor).
+		 *  \details The motor is moved between its joint limits (minus PWM_MODEL_MARGIN), so make sure the robot can move freely.
+		 *  		 Call savePwmModels() after all motors have been identified to store the models permanently.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \return Returns false if the motor did not move or the joint range is too small
+		 */
+		bool identifyPwmModel(uint8_t servoId);
+		
+		/**
+		 *  \brief Stores the PWM models of all motors in the EEPROM
+		 *  \param [in] address (Optional) Address in the EEPROM. Use different addresses for several robots.
+		 *  \return Returns false if not all motors have been identified
+		 */
+		bool savePwmModels(uint16_t address=STORAGE_PWM_ADDRESS);
+		
+		/**
+		 *  \brief Loads the PWM models of all motors from the EEPROM. Call this function in setup() after begin().
+		 *  \param [in] address (Optional) Address in the EEPROM the models have been saved to
+		 *  \return Returns false if no valid models for this number of motors are stored (the default model is used then)
+		 */
+		bool loadPwmModels(uint16_t address=STORAGE_PWM_ADDRESS);
+		
+		/**
+		 *  \brief Prints the PWM model of a motor to the serial monitor
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 */
+		void printPwmModel(uint8_t servoId);
 		//############################## 
 
+		/* SERVO CONTROLLER */
+		/**
+		 *  \brief Sets the gains of the position controller of a motor. The motor keeps the gains until it is switched off.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] gains Proportional, integral and derivative gain
+		 *  \return Returns false if the motor did not confirm the command
+		 */
+		bool setPid(uint8_t servoId, pid_gains_type gains);
+		
+		/**
+		 *  \brief Reads the gains of the position controller of a motor
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [out] gains Proportional, integral and derivative gain
+		 *  \return Returns false if the motor did not answer
+		 */
+		bool getPid(uint8_t servoId, pid_gains_type* gains);
+		
+		/**
+		 *  \brief Finds the gains of the position controller of a motor which settle fastest without overshooting.
+		 *  \details The current gains are multiplied with PID_TUNE_FACTORS and tested with steps of PID_TUNE_STEP degrees in both directions
+		 *  		 in the middle of the joint range. Gain sets which overshoot more than PID_TUNE_MAX_OVERSHOOT are rejected and larger factors are not tested.
+		 *  		 The gain set with the shortest settle time is set. Call savePidProfiles() after all motors have been tuned to keep the gains.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \return Returns false if no gain set settled (the original gains are restored then)
+		 */
+		bool tunePid(uint8_t servoId);
+		
+		/**
+		 *  \brief Reads the gains of all motors and stores them in the EEPROM
+		 *  \param [in] address (Optional) Address in the EEPROM. Use different addresses for several robots.
+		 *  \return Returns false if a motor did not answer
+		 */
+		bool savePidProfiles(uint16_t address=STORAGE_PID_ADDRESS);
+		
+		/**
+		 *  \brief Loads the gains of all motors from the EEPROM and sets them. Call this function in setup() after begin().
+		 *  \param [in] address (Optional) Address in the EEPROM the gains have been saved to
+		 *  \return Returns false if no valid gains for this number of motors are stored or a motor did not confirm them
+		 */
+		bool loadPidProfiles(uint16_t address=STORAGE_PID_ADDRESS);
+		
+		/**
+		 *  \brief Measures the backlash of a motor by approaching the middle of the joint range from both sides at full speed.
+		 *  \details The difference of the angles the motor stops at (averaged over BACKLASH_CALIBRATION_REPETITIONS) is set as backlash of the motor.
+		 *  		 Call saveBacklash() after all motors have been calibrated to keep the values.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \return Returns false if the joint range is too small
+		 */
+		bool calibrateBacklash(uint8_t servoId);
+		
+		/**
+		 *  \brief Sets the backlash of a motor (sent to the motor if BACKLASH_FIRMWARE is used)
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] backlash Backlash in degrees
+		 *  \return Returns false if the motor did not confirm the compensation
+		 */
+		bool setBacklash(uint8_t servoId, float backlash);
+		
+		/**
+		 *  \brief Returns the backlash of a motor in degrees
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 */
+		float getBacklash(uint8_t servoId);
+		
+		/**
+		 *  \brief Selects how the backlash of the motors is compensated
+		 *  \details BACKLASH_TRAJECTORY shifts the goal angles of the position commands by half the backlash in direction of the movement,
+		 *  		 so a motor stops at the goal angle no matter from which side it approaches. BACKLASH_FIRMWARE lets the motors compensate the backlash
+		 *  		 when their direction reverses. PWM movements (e.g. trajectoryPlanning()) are not compensated.
+		 *  \param [in] mode BACKLASH_OFF, BACKLASH_TRAJECTORY or BACKLASH_FIRMWARE
+		 *  \return Returns false if a motor did not confirm the compensation
+		 */
+		bool setBacklashCompensation(uint8_t mode);
+		
+		/**
+		 *  \brief Stores the backlash of all motors in the EEPROM
+		 *  \param [in] address (Optional) Address in the EEPROM. Use different addresses for several robots.
+		 *  \return Returns false if the data does not fit into the EEPROM
+		 */
+		bool saveBacklash(uint16_t address=STORAGE_BACKLASH_ADDRESS);
+		
+		/**
+		 *  \brief Loads the backlash of all motors from the EEPROM. Call setBacklashCompensation() to use it.
+		 *  \param [in] address (Optional) Address in the EEPROM the backlash has been saved to
+		 *  \return Returns false if no valid data for this number of motors is stored
+		 */
+		bool loadBacklash(uint16_t address=STORAGE_BACKLASH_ADDRESS);
+
 		/* HELPER */
 		/**
 		 *  \brief Prints an array of angles to the serial monitor.
@@ -451,9 +1011,15 @@ class morobotClass {
 		
 		/**
 		 *  \brief Returns the type of the robot
-		 *  \return Returns morobot type
+		 *  \return Returns morobot type (e.g. "morobot_s_rrr")
 		 */
-		virtual String getType()=0;
+		virtual const char* getType()=0;
+		
+		/**
+		 *  \brief Returns the type id of the robot. Use it instead of getType() to check the type of a robot in a loop.
+		 *  \return Returns ROBOT_TYPE_...
+		 */
+		virtual uint8_t getTypeId()=0;
 		
 		
 
@@ -496,6 +1062,144 @@ class morobotClass {
 		 */
 		bool checkForNANerror(uint8_t servoId, float angle);
 		
+		/**
+		 *  \brief Updates the stored joint state after a movement command has been sent to a motor. Marks the read angle dirty and the motor busy.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] angle Goal angle of the motor in degrees
+		 *  \param [in] angleIsKnown (Optional) Set to false if the final angle is not known exactly (e.g. PWM movements)
+		 */
+		void markJointCommanded(uint8_t servoId, long angle, bool angleIsKnown=true);
+		
+		/**
+		 *  \brief Moves a motor with a PWM value and tells the estimator the resulting velocity
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] pwm PWM value (0 stops the motor)
+		 */
+		void sendPwm(uint8_t servoId, float pwm);
+		
+		/**
+		 *  \brief Makes sure every estimator has been corrected by a reading, so loops which work with the estimated angles do not start from 0
+		 *  \return Returns false if the angle of a motor could not be read
+		 */
+		bool seedEstimators();
+		
+		/**
+		 *  \brief Calculates the inverse kinematics of a point of a path
+		 *  \param [in] point Position x, y, z
+		 *  \param [out] angles Angles of all motors in degrees
+		 *  \return Returns false (and prints an error) if the point is not reachable
+		 */
+		bool calculatePathAngles(const float point[3], long angles[]);
+		
+		/**
+		 *  \brief Calculates the inverse kinematics of a point and stores the angles internally (_goalAngles).
+		 *  		Used by the movement functions for every point of a path. morobotBase overrides it to call the kinematics
+		 *  		of the robot class directly, so only this call is dispatched at runtime.
+		 *  \param [in] point Position x, y, z
+		 *  \return Returns true if the position is reachable; false if it is not.
+		 */
+		virtual bool calculateGoalAngles(const float point[3]);
+		
+		/**
+		 *  \brief Moves a motor to a goal angle at full speed and measures how long it takes to settle (used by tunePid())
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] goal Goal angle in degrees
+		 *  \param [out] settleTime Time in ms until the angle stayed within PID_TUNE_TOLERANCE to the goal
+		 *  \param [out] overshoot Largest distance in degrees the motor moved beyond the goal
+		 *  \return Returns false if the motor did not settle within PID_TUNE_TIMEOUT or overshot more than PID_TUNE_MAX_OVERSHOOT (the measurement stops then)
+		 */
+		bool measureStepResponse(uint8_t servoId, long goal, unsigned long* settleTime, float* overshoot);
+		
+		/**
+		 *  \brief Calculates the offset added to the goal angle of a position command to compensate the backlash (BACKLASH_TRAJECTORY)
+		 *  \details Updates the direction of the motor and remembers the offset, so relative movements can remove the offset of the previous command.
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] goalAngle Goal angle of the movement in degrees
+		 *  \return Returns the offset in degrees (0 if the backlash is not compensated by the library)
+		 */
+		long getBacklashOffset(uint8_t servoId, long goalAngle);
+		
+		/**
+		 *  \brief Prints an error message if a motor did not confirm a command (after all retries)
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] success Result of the command
+		 *  \return Returns success
+		 */
+		bool checkServoResponse(uint8_t servoId, bool success);
+		
+		/**
+		 *  \brief Starts a serial port given by its name
+		 *  \param [in] stream Name of serial port (e.g. "Serial1").
+		 *  \return Returns the port or NULL (and prints an error) if the port is not available on this board
+		 */
+		static Stream* openPort(const char* stream);
+		
+		/**
+		 *  \brief Connects the smartservos to a started serial port
+		 *  \param [in] port Serial port the robot is connected to
+		 */
+		void attachPort(Stream& port);
+		
+		/**
+		 *  \brief Enumerates the motors and reads the TCP pose (second part of begin())
+		 *  \param [in] startTime Time the start of the robot began (millis())
+		 */
+		void startMotors(unsigned long startTime);
+		
+		/**
+		 *  \brief Probes or enumerates the motors (second part of beginFast())
+		 *  \param [in] startTime Time the start of the robot began (millis())
+		 *  \param [in] address Address of the stored motors in the EEPROM
+		 *  \return Returns false if not all motors of the robot answered
+		 */
+		bool startMotorsFast(unsigned long startTime, uint16_t address);
+		
+		/**
+		 *  \brief Checks if the stored motors are still connected and have their IDs (one probe to the last motor)
+		 *  \param [in] address Address of the stored motors in the EEPROM
+		 *  \return Returns true if the enumeration of the motors can be skipped
+		 */
+		bool probeTopology(uint16_t address);
+		
+		/**
+		 *  \brief Reads the firmware versions of the enumerated motors and stores them (the EEPROM is only written if they changed)
+		 *  \param [in] address Address of the stored motors in the EEPROM
+		 *  \return Returns false (and prints an error) if not all motors answered
+		 */
+		bool storeTopology(uint16_t address);
+		
+		/**
+		 *  \brief Stores and reports the boot time
+		 *  \param [in] startTime Time the start of the robot began (millis())
+		 *  \param [in] cached True if the enumeration has been skipped
+		 */
+		void finishBegin(unsigned long startTime, bool cached);
+		
+		/**
+		 *  \brief Points the per-joint state of the robot to the given storage
+		 *  \param [in] storage Storage for the state of N motors (N must be the number of motors of the robot)
+		 */
+		template <uint8_t N>
+		void attachJointStorage(morobotJointStorage<N>* storage){
+			_angleReached = storage->angleReached;
+			_goalAngles = storage->goalAngles;
+			_commandedAngles = storage->commandedAngles;
+			_measuredAngles = storage->measuredAngles;
+			_commandedIsValid = storage->commandedIsValid;
+			_measuredIsValid = storage->measuredIsValid;
+			_pwmModels = storage->pwmModels;
+			_pwmModelIsValid = storage->pwmModelIsValid;
+			_backlash = storage->backlash;
+			_backlashDirection = storage->backlashDirection;
+			_backlashOffset = storage->backlashOffset;
+			_estimators = storage->estimators;
+		}
+		
+		/**
+		 *  \brief Sets the per-joint state to its defaults (no PWM models, no backlash, unknown angles). Called after attachJointStorage().
+		 */
+		void initJointStorage();
+		
 		/**
 		 *  \brief Prints an error message to the console when trying to move a motor out of its valid range
 		 *  \param [in] servoId Number of motor which is to be moved (first motor has ID 0)
@@ -503,6 +1207,13 @@ class morobotClass {
 		 */
 		void printInvalidAngleError(uint8_t servoId, float angle);
 
+		/**
+		 *  \brief Stores why an angle check failed (used by checkPath())
+		 *  \param [in] error Reason (PATH_CHECK_UNREACHABLE, PATH_CHECK_JOINT_LIMIT, PATH_CHECK_COUPLING)
+		 *  \param [in] servoId Number of motor which failed (first motor has ID 0)
+		 */
+		void setAngleError(uint8_t error, uint8_t servoId);
+
 		uint8_t _numSmartServos;			//!< Number of smart servos of robot
 		long _robotJointLimits[3][2];	//!< Limits for all joints
 		uint8_t _robotAxisLimits[3][2];		//!< Limits of x, y, z axis
@@ -510,17 +1221,296 @@ class morobotClass {
 		float _actPos[3];					//!< Robot TCP position (in base frame)
 		float _actOri[3];					//!< Robot TCP orientation (rotation in degrees around base frame)
 		bool _tcpPoseIsValid = false;		//!< Status of TCP-pose: When the robot is moved without updating pose, it is set to false;
-		bool _angleReached[NUM_MAX_SERVOS];	//!< Variables that indicate if a motor is busy (is moving and has not reached final position)
-		float _goalAngles[NUM_MAX_SERVOS];	//!< Variable for inverse kinematics to store goal Angles of the motors
+		bool* _angleReached;				//!< Variables that indicate if a motor is busy (is moving and has not reached final position)
+		float* _goalAngles;					//!< Variable for inverse kinematics to store goal Angles of the motors
+		long* _commandedAngles;				//!< Joint state: last goal angle sent to each motor
+		long* _measuredAngles;				//!< Joint state: last angle read from each motor without the backlash offset (joint angle)
+		bool* _commandedIsValid;			//!< Joint state: false if the goal angle of a motor is not known (e.g. after PWM movements)
+		bool* _measuredIsValid;				//!< Joint state: false (dirty) if a motor has been moved since its angle was read
+		pwm_model_type* _pwmModels;			//!< Identified PWM models of the motors
+		bool* _pwmModelIsValid;				//!< False if a motor has not been identified (the default model is used)
+		float* _backlash;					//!< Backlash of the motors in degrees
+		int8_t* _backlashDirection;			//!< Direction of the last movement of each motor (1, -1 or 0 if unknown)
+		long* _backlashOffset;				//!< Offset included in the last position command of each motor
+		uint8_t _backlashMode;						//!< How the backlash is compensated (BACKLASH_OFF, BACKLASH_TRAJECTORY, BACKLASH_FIRMWARE)
+		tracking_stats_type _trackingStats;	//!< Tracking errors of the last moveLinearTracked() or moveAlongPath() movement
+		jointStateEstimator* _estimators;	//!< Joint state: estimated angle and velocity of each motor between readings
 		Stream* _port;						//!< Port used for communication with the robot (e.g. Serial1)
+		unsigned long _bootTime = 0;		//!< Duration of the last start of the robot in ms
+		bool _bootCached = false;			//!< True if the enumeration of the motors has been skipped at the last start
+		float _moveDistance = 0;			//!< Distance in mm between start and goal of the last moveToPose()
+		long _moveJointSpan = 0;			//!< Largest angle in degrees a joint moves in the last moveToPose()
+		uint8_t _angleError = PATH_CHECK_OK;	//!< Reason of the last failed angle check (PATH_CHECK_...)
+		uint8_t _angleErrorJoint = 0;			//!< Motor of the last failed angle check
 	private:
+		template <uint8_t N, class Robot> friend class morobotBase;
+		
+		/**
+		 *  \brief Constructor of morobot class. Private, so robot classes can only derive from morobotBase, which provides the per-joint state.
+		 *  \param [in] numSmartServos Number of smart servos of the robot
+		 */
+		morobotClass(uint8_t numSmartServos);
+		
 		/**
 		 *  \brief Checks if the robot is busy or idle.
 		 *  		Checks if internal variables indicate the robot is idle.
-		 *  		If a motor is not already set idle, it checks if the motor is still moving.
+		 *  		If a motor is not already set idle, it checks if the motor reported reaching its goal or if it is still moving.
 		 *  \return Returns true if the robot is idle; false if the robot is busy
 		 */
 		bool isReady();
 };
 
+/**
+ *  \brief Base of all robot classes with N motors. The number of motors is known at compile time,
+ *  		so the per-joint state of the robot takes exactly the memory it needs.
+ *  		Robot is the robot class itself (e.g. class morobot_3d:public morobotBase<3, morobot_3d>), which lets the
+ *  		movement functions call its kinematics without virtual function calls. The robot class must declare morobotBase a friend.
+ *  		The path controller (moveAlongPath(), checkPath()) is compiled for every robot class, so its inverse kinematics is called
+ *  		directly in every cycle. A robot used through a morobotClass pointer only pays one virtual call per movement.
+ */
+template <uint8_t N, class Robot>
+class morobotBase : public morobotClass {
+	public:
+		static const uint8_t numServos = N;	//!< Number of smart servos of the robot
+		
+		/**
+		 *  \brief Constructor of morobotBase class
+		 */
+		morobotBase() : morobotClass(N){
+			static_assert(N > 0 && N <= NUM_MAX_SERVOS, "Number of motors must be between 1 and NUM_MAX_SERVOS");
+			static_assert(N <= 3, "The joint limits are stored for at most 3 motors");
+			attachJointStorage(&_jointStorage);
+			initJointStorage();
+		};
+		
+		/**
+		 *  \brief Move the TCP along a path with a given speed (see morobotClass::moveAlongPath())
+		 */
+		virtual bool moveAlongPath(pathSource* path, float tcpSpeed=LINE_TRACKING_SPEED, float maxDeviation=LINE_TRACKING_MAX_ERROR);
+		
+		/**
+		 *  \brief Checks all points of a path before the robot moves (see morobotClass::checkPath())
+		 */
+		virtual bool checkPath(pathSource* path, float tcpSpeed=0, path_check_type* report=NULL);
+	protected:
+		virtual bool calculateGoalAngles(const float point[3]){
+			return static_cast<Robot*>(this)->Robot::calculateAngles(point[0], point[1], point[2]);
+		};
+		
+		morobotJointStorage<N> _jointStorage;	//!< Per-joint state of the robot
+};
+
+/* PATH CONTROL (instantiated for every robot class) */
+template <uint8_t N, class Robot>
+bool morobotBase<N, Robot>::moveAlongPath(pathSource* path, float tcpSpeed, float maxDeviation){
+	float point[3];
+	float refAngles[N];	// reference angles of the current cycle
+	float nextAngles[N];	// reference angles of the next cycle
+	float dt = LINE_TRACKING_PERIOD/1000.0;
+	float maxJointVel = SERVO_MAX_SPEED_RPM*6;
+	
+	_trackingStats.maxError = 0;
+	_trackingStats.rmsError = 0;
+	_trackingStats.duration = 0;
+	_trackingStats.numCycles = 0;
+	_trackingStats.numPauses = 0;
+	_trackingStats.numOverruns = 0;
+	
+	if(tcpSpeed <= 0){
+		Serial.println(F("ERROR: TCP speed must be greater than 0"));
+		return false;
+	}
+	
+	// The path starts at the current position
+	float length = path->getLength();
+	if(length < 0.1) return true;
+	
+	// The points and joint velocities of every cycle at the given speed
+	if(checkPath(path, tcpSpeed) == false) return false;
+	
+	// Initialize the estimators and the reference with the current angles
+	for(uint8_t j=0; j<N; j++){
+		refAngles[j] = getActAngle(j);
+	}
+	if(!seedEstimators()) return false;
+	
+	float t = 0;
+	float maxVel = tcpSpeed;
+	if(maxVel*maxVel > length*LINE_TRACKING_ACCELERATION) maxVel = sqrt(length*LINE_TRACKING_ACCELERATION);
+	float totalTime = maxVel/LINE_TRACKING_ACCELERATION + length/maxVel;
+	
+	uint8_t readJoint = 0;
+	float squaredErrorSum = 0;
+	path->resetTriggers();
+	path->fireTriggers(0, 0, totalTime);
+	unsigned long startTime = millis();
+	unsigned long pauseStart = 0;
+	bool paused = false;
+	unsigned long nextCycle = micros();
+	
+	while(t < totalTime){
+		// Feedback: read one motor per cycle, the estimators predict the others
+		getActAngle(readJoint);
+		readJoint = (readJoint+1)%N;
+		
+		float estimatedAngles[N];
+		float cycleError = 0;
+		for(uint8_t j=0; j<N; j++){
+			estimatedAngles[j] = getEstimate(j).angle;
+			float error = fabs(refAngles[j]-estimatedAngles[j]);
+			if(error > cycleError) cycleError = error;
+		}
+		if(cycleError > _trackingStats.maxError) _trackingStats.maxError = cycleError;
+		squaredErrorSum += cycleError*cycleError;
+		_trackingStats.numCycles++;
+		
+		// Time scaling: the reference waits while the robot is too far behind
+		if(cycleError > maxDeviation){
+			if(!paused){
+				paused = true;
+				pauseStart = millis();
+			}else if(millis()-pauseStart > LINE_TRACKING_TIMEOUT){
+				for(uint8_t j=0; j<N; j++) sendPwm(j, 0);
+				path->cancelTriggers();
+				Serial.println(F("ERROR: Robot does not follow the path, movement aborted"));
+				_trackingStats.duration = millis()-startTime;
+				invalidateJointState();
+				return false;
+			}
+			_trackingStats.numPauses++;
+			for(uint8_t j=0; j<N; j++) nextAngles[j] = refAngles[j];
+		}else{
+			paused = false;
+			t += dt;
+			float s = calcTrapezoidalProfile(t, length, tcpSpeed, LINE_TRACKING_ACCELERATION);
+			path->getPointAt(s, point);
+			if(static_cast<Robot*>(this)->Robot::calculateAngles(point[0], point[1], point[2]) == false){
+				for(uint8_t j=0; j<N; j++) sendPwm(j, 0);
+				path->cancelTriggers();
+				Serial.println(F("ERROR: Point of path is not reachable, movement aborted"));
+				_trackingStats.duration = millis()-startTime;
+				invalidateJointState();
+				return false;
+			}
+			for(uint8_t j=0; j<N; j++) nextAngles[j] = _goalAngles[j];
+			
+			// End effector actions at the position the robot is commanded to in this cycle
+			path->fireTriggers(s, t, totalTime);
+		}
+		
+		// Feedforward from the reference velocity plus proportional feedback on the estimated angle
+		for(uint8_t j=0; j<N; j++){
+			float vel = (nextAngles[j]-refAngles[j])/dt + LINE_TRACKING_GAIN*(refAngles[j]-estimatedAngles[j]);
+			vel = constrain(vel, -maxJointVel, maxJointVel);
+			sendPwm(j, calcPwm(j, vel));
+			markJointCommanded(j, nextAngles[j], false);
+			refAngles[j] = nextAngles[j];
+		}
+		
+		// Wait for the next cycle (a late cycle starts the next one immediately)
+		nextCycle += LINE_TRACKING_PERIOD*1000UL;
+		if((long)(micros()-nextCycle) > 0){
+			_trackingStats.numOverruns++;
+			nextCycle = micros();
+		}
+		while((long)(micros()-nextCycle) < 0);
+	}
+	
+	// Position the motors exactly on the goal point
+	for(uint8_t j=0; j<N; j++){
+		sendPwm(j, 0);
+		moveToAngle(j, lround(refAngles[j]));
+	}
+	path->fireTriggers(length, totalTime, totalTime);
+	
+	_trackingStats.duration = millis()-startTime;
+	if(_trackingStats.numCycles > 0) _trackingStats.rmsError = sqrt(squaredErrorSum/_trackingStats.numCycles);
+	
+	path->getPointAt(length, _actPos);
+	_tcpPoseIsValid = true;
+	
+	return true;
+}
+
+template <uint8_t N, class Robot>
+bool morobotBase<N, Robot>::checkPath(pathSource* path, float tcpSpeed, path_check_type* report){
+	path_check_type result;
+	result.error = PATH_CHECK_OK;
+	result.index = -1;
+	result.joint = 0;
+	result.numPoints = 0;
+	result.maxJointVel = 0;
+	
+	float point[3];
+	float lastAngles[N];
+	float dt = LINE_TRACKING_PERIOD/1000.0;
+	float maxJointVel = SERVO_MAX_SPEED_RPM*6;
+	float length = 0;
+	uint32_t nrPoints;
+	
+	if(tcpSpeed > 0){
+		// The points moveAlongPath() commands: the start and one point per cycle of the same speed profile
+		length = path->getLength();
+		float totalTime = 0;
+		if(length > 0){
+			float maxVel = tcpSpeed;
+			if(maxVel*maxVel > length*LINE_TRACKING_ACCELERATION) maxVel = sqrt(length*LINE_TRACKING_ACCELERATION);
+			totalTime = maxVel/LINE_TRACKING_ACCELERATION + length/maxVel;
+		}
+		nrPoints = (uint32_t)ceil(totalTime/dt) + 1;
+	}else{
+		// The interpolation points followPath() and trajectoryPlanning() approach
+		nrPoints = path->getNumPoints();
+		path->reset();
+	}
+	
+	for(uint32_t i=0; i<nrPoints; i++){
+		if(tcpSpeed > 0){
+			path->getPointAt(calcTrapezoidalProfile(i*dt, length, tcpSpeed, LINE_TRACKING_ACCELERATION), point);
+		}else if(!path->next(point)){
+			break;
+		}
+		result.numPoints++;
+		
+		// Inverse kinematics: every robot rejects unreachable points, angles out of the joint limits and invalid constraints between joints
+		_angleError = PATH_CHECK_UNREACHABLE;
+		_angleErrorJoint = 0;
+		bool valid = static_cast<Robot*>(this)->Robot::calculateAngles(point[0], point[1], point[2]);
+		
+		if(valid == false){
+			result.error = _angleError;
+			result.joint = _angleErrorJoint;
+		}else if(tcpSpeed > 0 && i > 0){
+			// Joint velocities the feedforward of moveAlongPath() commands between two cycles
+			for(uint8_t j=0; j<N; j++){
+				float vel = fabs(_goalAngles[j]-lastAngles[j])/dt;
+				if(vel > result.maxJointVel) result.maxJointVel = vel;
+				if(vel > maxJointVel && result.error == PATH_CHECK_OK){
+					result.error = PATH_CHECK_VELOCITY;
+					result.joint = j;
+				}
+			}
+		}
+		
+		if(result.error != PATH_CHECK_OK){
+			result.index = (i > 32767) ? 32767 : i;
+			for(uint8_t k=0; k<3; k++) result.point[k] = point[k];
+			Serial.print(F("ERROR: Path is not valid at point "));
+			Serial.print(i);
+			Serial.print(F(" (error "));
+			Serial.print(result.error);
+			Serial.print(F(", motor "));
+			Serial.print(result.joint);
+			Serial.println(F(")"));
+			break;
+		}
+		
+		for(uint8_t j=0; j<N; j++) lastAngles[j] = _goalAngles[j];
+	}
+	path->reset();
+	
+	if(report != NULL) *report = result;
+	return result.error == PATH_CHECK_OK;
+}
+
 #endif
\ No newline at end of file
@@ -6,7 +6,7 @@
  *  @date	2021/02/17
  *  \par Method List:
  *  	public:
- *  		newRobotClass() : morobotClass(PUT_NUM_SERVOS_HERE){};
+ *  		morobot_2d() : morobotBase<2, morobot_2d>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 		protected:
@@ -37,8 +37,12 @@ bool morobot_2d::checkIfAngleValid(uint8_t servoId, float angle){
 	return true;
 }
 
-String morobot_2d::getType(){
-	return type;
+const char* morobot_2d::getType(){
+	return "morobot_2d";
+}
+
+uint8_t morobot_2d::getTypeId(){
+	return typeId;
 }
 
 /* PROTECTED FUNCTIONS */
@@ -65,8 +69,8 @@ bool morobot_2d::calculateAngles(float x, float y, float z){
 	phi2 = convertToDeg(phi2) - 90;
 	
 	// Check if angles are valid
-	if(checkIfAngleValid(0, phi1) == false) return false;
-	if(checkIfAngleValid(1, phi2) == false) return false;
+	if(morobot_2d::checkIfAngleValid(0, phi1) == false) return false;
+	if(morobot_2d::checkIfAngleValid(1, phi2) == false) return false;
 	
 	_goalAngles[0] = phi1;
 	_goalAngles[1] = phi2;
@@ -80,8 +84,8 @@ void morobot_2d::updateTCPpose(bool output){
 	waitUntilIsReady();
 	
 	// Recalculate angles because of motor mounting orientations
-	float phi1 = - (getActAngle(0) - 90);
-	float phi2 = getActAngle(1) + 90;
+	float phi1 = - (getKnownAngle(0) - 90);
+	float phi2 = getKnownAngle(1) + 90;
 	phi1 = convertToRad(phi1);
 	phi2 = convertToRad(phi2);
 	
@@ -6,7 +6,7 @@
  *  @date	2021/02/17
  *  \par Method List:
  *  	public:
- *  		morobot_2d() : morobotClass(PUT_NUM_SERVOS_HERE){};
+ *  		morobot_2d() : morobotBase<2, morobot_2d>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 		protected:
@@ -19,13 +19,14 @@
 
 #include "morobot.h"
 
-class morobot_2d:public morobotClass {
+class morobot_2d:public morobotBase<2, morobot_2d> {
+	friend class morobotBase<2, morobot_2d>;	//!< Calls the kinematics of the robot without virtual function calls
 	public:
 		/**
 		 *  \brief Constructor of morobot_2d class
-		 *  \details The value in brakets defines that the robot consists of two smartservos
+		 *  \details The template argument of morobotBase defines that the robot consists of two smartservos
 		 */
-		morobot_2d() : morobotClass(2){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
+		morobot_2d() : morobotBase<2, morobot_2d>(){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
 		
 		/**
 		 *  \brief Set the position of the TCP (tool center point) with respect to the center of the flange of the last robot axis.
@@ -49,9 +50,15 @@ class morobot_2d:public morobotClass {
 		 *  \brief Returns the type of the robot
 		 *  \return Returns morobot type
 		 */
-		virtual String getType();
+		virtual const char* getType();
 		
-		const String type = "morobot_2d";		//!< Type of morobot
+		/**
+		 *  \brief Returns the type id of the robot
+		 *  \return Returns ROBOT_TYPE_2D
+		 */
+		virtual uint8_t getTypeId();
+		
+		static const uint8_t typeId = ROBOT_TYPE_2D;		//!< Type of morobot
 		
 	protected:
 		/**
@@ -8,9 +8,10 @@
  *  	public:
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
+			bool calculateJointVelocities(const float angles[3], const float tcpVel[3], float jointVel[3]);
+			bool calculateTCPVelocity(const float angles[3], const float jointVel[3], float tcpVel[3]);
 		protected:
 			virtual bool calculateAngles(float x, float y, float z);
-			uint8_t calculateAngleYZ(float x, float y, float z, float &theta);
 			virtual void updateCurrentXYZ();
  */
  
@@ -40,8 +41,32 @@ bool morobot_3d::checkIfAngleValid(uint8_t servoId, float angle){
 	return true;
 }
 
-String morobot_3d::getType(){
-	return type;
+const char* morobot_3d::getType(){
+	return "morobot_3d";
+}
+
+uint8_t morobot_3d::getTypeId(){
+	return typeId;
+}
+
+bool morobot_3d::calculateJointVelocities(const float angles[3], const float tcpVel[3], float jointVel[3]){
+	float pos[3];
+	if (!_kinematics.forward(angles, pos)) return false;
+	
+	// The y- and z-axis of the kinematics point in the opposite directions
+	float vel[3] = {tcpVel[0], -tcpVel[1], -tcpVel[2]};
+	return _kinematics.calculateJointVelocities(angles, pos, vel, jointVel);
+}
+
+bool morobot_3d::calculateTCPVelocity(const float angles[3], const float jointVel[3], float tcpVel[3]){
+	float pos[3];
+	float jacobian[3][3];
+	if (!_kinematics.forward(angles, pos) || !_kinematics.calculateJacobian(angles, pos, jacobian)) return false;
+	
+	for (uint8_t i=0; i<3; i++) tcpVel[i] = jacobian[i][0]*jointVel[0] + jacobian[i][1]*jointVel[1] + jacobian[i][2]*jointVel[2];
+	tcpVel[1] = -tcpVel[1];
+	tcpVel[2] = -tcpVel[2];
+	return true;
 }
 
 /* PROTECTED FUNCTIONS */
@@ -51,112 +76,40 @@ bool morobot_3d::calculateAngles(float x, float y, float z){
 	y = y - _tcpOffset[1];
 	z = z - _tcpOffset[2] - z_def_offset_bottom - z_def_offset_top;
 	
-	x = x;
-	y = -y;
-	z = -z;
-
-	float theta1 = 0;
-	float theta2 = 0;
-	float theta3 = 0;
-
-	// Calculate angles
-	uint8_t status = calculateAngleYZ(x, y, z, theta1);
-	if (status == 0) status = calculateAngleYZ(x*cos120 + y*sin120, y*cos120-x*sin120, z, theta2);  // rotate coords to +120 deg
-	if (status == 0) status = calculateAngleYZ(x*cos120 - y*sin120, y*cos120+x*sin120, z, theta3);  // rotate coords to -120 deg
-	if (status != 0) {
+	// Calculate angles (the y- and z-axis of the kinematics point in the opposite directions)
+	float theta[3];
+	if (!_kinematics.inverse(x, -y, -z, theta)) {
 		Serial.println(F("ERROR calculating motor angles. The given point is invalid"));
 		return false;
 	}
 	
-	theta1 = theta1;
-	theta2 = theta2;
-	theta3 = theta3;
-	
 	//Check if angles are valid
-	if(checkIfAngleValid(0, theta1) == false) return false;
-	if(checkIfAngleValid(1, theta2) == false) return false;
-	if(checkIfAngleValid(2, theta3) == false) return false;
+	if(morobot_3d::checkIfAngleValid(0, theta[0]) == false) return false;
+	if(morobot_3d::checkIfAngleValid(1, theta[1]) == false) return false;
+	if(morobot_3d::checkIfAngleValid(2, theta[2]) == false) return false;
 	
-	_goalAngles[0] = theta1;
-	_goalAngles[1] = theta2;
-	_goalAngles[2] = theta3;
+	_goalAngles[0] = theta[0];
+	_goalAngles[1] = theta[1];
+	_goalAngles[2] = theta[2];
 	
 	return true;
 }
 
-// Helper functions, calculates angle theta (for YZ-pane)
-uint8_t morobot_3d::calculateAngleYZ(float x, float y, float z, float &theta) {
-     float y1 = -0.5 * 0.57735 * f; // f/2 * tg 30
-     y -= 0.5 * 0.57735    * e;    // shift center to edge
-     // z = a + b*y
-     float a = (x*x + y*y + z*z +rf*rf - re*re - y1*y1)/(2*z);
-     float b = (y1-y)/z;
-     // discriminant
-     float d = -(a+b*y1)*(a+b*y1)+rf*(b*b*rf+rf); 
-     if (d < 0) return -1; // non-existing point
-     float yj = (y1 - a*b - sqrt(d))/(b*b + 1); // choosing outer point
-     float zj = a + b*yj;
-     theta = 180.0*atan(-zj/(y1 - yj))/M_PI + ((yj>y1)?180.0:0.0);
-     return 0;
-}
-
 void morobot_3d::updateTCPpose(bool output){
 	if (_tcpPoseIsValid) return;
 	
 	waitUntilIsReady();
 	
-	// Recalculate angles because of motor mounting orientations
-	float theta1 = getActAngle(0);
-	float theta2 = getActAngle(1);
-	float theta3 = getActAngle(2);
-	theta1 = convertToRad(theta1);
-	theta2 = convertToRad(theta2);
-	theta3 = convertToRad(theta3);
+	float angles[3];
+	float pos[3];
+	for (uint8_t i=0; i<3; i++) angles[i] = getKnownAngle(i);
 	
-	float t = (f-e)*tan30/2;
-
-	float y1 = -(t + rf*cos(theta1));
-	float z1 = -rf*sin(theta1);
-
-	float y2 = (t + rf*cos(theta2))*sin30;
-	float x2 = y2*tan60;
-	float z2 = -rf*sin(theta2);
-
-	float y3 = (t + rf*cos(theta3))*sin30;
-	float x3 = -y3*tan60;
-	float z3 = -rf*sin(theta3);
-
-	float dnm = (y2-y1)*x3-(y3-y1)*x2;
-
-	float w1 = y1*y1 + z1*z1;
-	float w2 = x2*x2 + y2*y2 + z2*z2;
-	float w3 = x3*x3 + y3*y3 + z3*z3;
-
-	// x = (a1*z + b1)/dnm
-	float a1 = (z2-z1)*(y3-y1)-(z3-z1)*(y2-y1);
-	float b1 = -((w2-w1)*(y3-y1)-(w3-w1)*(y2-y1))/2.0;
-
-	// y = (a2*z + b2)/dnm;
-	float a2 = -(z2-z1)*x3+(z3-z1)*x2;
-	float b2 = ((w2-w1)*x3 - (w3-w1)*x2)/2.0;
-
-	// a*z^2 + b*z + c = 0
-	float a = a1*a1 + a2*a2 + dnm*dnm;
-	float b = 2*(a1*b1 + a2*(b2-y1*dnm) - z1*dnm*dnm);
-	float c = (b2-y1*dnm)*(b2-y1*dnm) + b1*b1 + dnm*dnm*(z1*z1 - re*re);
-
-	// discriminant
-	float d = b*b - (float)4.0*a*c;
-	if (d < 0) {
+	if (!_kinematics.forward(angles, pos)) {
 		Serial.println(F("ERROR: Something went wrong. The calculated TCP pose is no valid point"));
 	} else {
-		_actPos[2] = -(float)0.5*(b+sqrt(d))/a;
-		_actPos[0] = (a1*_actPos[2] + b1)/dnm;
-		_actPos[1] = (a2*_actPos[2] + b2)/dnm;
-	
-		_actPos[0] =   _actPos[0] + _tcpOffset[0];
-		_actPos[1] = -_actPos[1] + _tcpOffset[1];
-		_actPos[2] = -_actPos[2] + z_def_offset_bottom + z_def_offset_top + _tcpOffset[2];
+		_actPos[0] =  pos[0] + _tcpOffset[0];
+		_actPos[1] = -pos[1] + _tcpOffset[1];
+		_actPos[2] = -pos[2] + z_def_offset_bottom + z_def_offset_top + _tcpOffset[2];
 
 		// Store orientation
 		_actOri[0] = 0;
@@ -6,12 +6,13 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobot_3d() : morobotClass(3){};
+ *  		morobot_3d() : morobotBase<3, morobot_3d>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
+			bool calculateJointVelocities(const float angles[3], const float tcpVel[3], float jointVel[3]);
+			bool calculateTCPVelocity(const float angles[3], const float jointVel[3], float tcpVel[3]);
 		protected:
 			virtual bool calculateAngles(float x, float y, float z);
-			uint8_t calculateAngleYZ(float x, float y, float z, float &theta);
 			virtual void updateCurrentXYZ();
  */
 
@@ -19,14 +20,16 @@
 #define MOROBOT_3D_H
 
 #include "morobot.h"
+#include "delta_kinematics.h"
 
-class morobot_3d:public morobotClass {
+class morobot_3d:public morobotBase<3, morobot_3d> {
+	friend class morobotBase<3, morobot_3d>;	//!< Calls the kinematics of the robot without virtual function calls
 	public:
 		/**
 		 *  \brief Constructor of morobot_3d class
-		 *  \details The value in brakets defines that the robot consists of three smartservos
+		 *  \details The template argument of morobotBase defines that the robot consists of three smartservos
 		 */
-		morobot_3d() : morobotClass(3){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
+		morobot_3d() : morobotBase<3, morobot_3d>(){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
 		
 		/**
 		 *  \brief Set the position of the TCP (tool center point) with respect to the center of the flange of the last robot axis.
@@ -48,13 +51,37 @@ class morobot_3d:public morobotClass {
 		 */
 		virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 		
+		/**
+		 *  \brief Calculates the joint velocities which move the TCP with a given velocity (inverse velocity Jacobian, cheap enough for every control cycle)
+		 *  \param [in] angles Angles of the motors in degrees
+		 *  \param [in] tcpVel Velocity of the TCP in mm/s (in robot base frame)
+		 *  \param [out] jointVel Velocities of the motors in degrees/s
+		 *  \return Returns false if the angles are no valid pose or the pose is singular
+		 */
+		bool calculateJointVelocities(const float angles[3], const float tcpVel[3], float jointVel[3]);
+		
+		/**
+		 *  \brief Calculates the velocity of the TCP from the joint velocities (velocity Jacobian)
+		 *  \param [in] angles Angles of the motors in degrees
+		 *  \param [in] jointVel Velocities of the motors in degrees/s
+		 *  \param [out] tcpVel Velocity of the TCP in mm/s (in robot base frame)
+		 *  \return Returns false if the angles are no valid pose or the pose is singular
+		 */
+		bool calculateTCPVelocity(const float angles[3], const float jointVel[3], float tcpVel[3]);
+		
 		/**
 		 *  \brief Returns the type of the robot
 		 *  \return Returns morobot type
 		 */
-		virtual String getType();
+		virtual const char* getType();
 		
-		const String type = "morobot_3d";		//!< Type of morobot
+		/**
+		 *  \brief Returns the type id of the robot
+		 *  \return Returns ROBOT_TYPE_3D
+		 */
+		virtual uint8_t getTypeId();
+		
+		static const uint8_t typeId = ROBOT_TYPE_3D;		//!< Type of morobot
 		
 	protected:
 		/**
@@ -68,16 +95,6 @@ class morobot_3d:public morobotClass {
 		 */
 		virtual bool calculateAngles(float x, float y, float z);
 		
-		/**
-		 *  \brief Helper function for inverse kinematicts that calculates the motor angle in the plane.
-		 *  \param [in] x Desired x-position of TCP
-		 *  \param [in] y Desired y-position of TCP
-		 *  \param [in] z Desired z-position of TCP
-		 *  \param [in] theta Angle of motor to calculate
-		 *  \return Returns 0 if calculation succeeds, -1 otherwise
-		 */
-		uint8_t calculateAngleYZ(float x, float y, float z, float &theta);
-		
 		/**
 		 *  \brief Re-calculates the internally stored robot TCP position (Solves forward kinematics).
 		 *  		This function does calculate and store the TCP position depending on the current motor angles.
@@ -97,13 +114,7 @@ class morobot_3d:public morobotClass {
 		float re = 149.95;	//!< Length of parallelogram link
 		float rf = 96.00;	//!< Length of upper link
 		
-		// trigonometric constants
-		const float sqrt3 = sqrt(3.0);
-		const float sin120 = sqrt3/2.0;   
-		const float cos120 = -0.5;        
-		const float tan60 = sqrt3;
-		const float sin30 = 0.5;
-		const float tan30 = 1/sqrt3;
+		deltaKinematics _kinematics = deltaKinematics(e, f, re, rf);	//!< Kinematics with the constants of the geometry (the z-axis points up, y is mirrored)
 };
 
 #endif
\ No newline at end of file
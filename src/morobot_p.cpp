@@ -6,13 +6,16 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobot_p() : morobotClass(3){};
+ *  		morobot_p() : morobotBase<3, morobot_p>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
+			bool checkIfAngleDiffValid(float servo1Angle, float servo2Angle);
 			void moveHome();
 		protected:
 			virtual bool calculateAngles(float x, float y, float z);
 			virtual void updateCurrentXYZ();
+		private:
+			bool checkIfJointLimitValid(uint8_t servoId, float angle);
  */
  
 #include "morobot_p.h"
@@ -31,36 +34,43 @@ void morobot_p::setTCPoffset(float xOffset, float yOffset, float zOffset){
 }
 
 bool morobot_p::checkIfAngleValid(uint8_t servoId, float angle){
-	// The values are NAN if the inverse kinematics does not provide a solution
-	if(!checkForNANerror(servoId, angle)) return false;
-	
-	// Moving the motors out of the joint limits may harm the robot's mechanics
-	if(angle < _jointLimits[servoId][0] || angle > _jointLimits[servoId][1]){
-		printInvalidAngleError(servoId, angle);
-		return false;
-	}
+	if(!checkIfJointLimitValid(servoId, angle)) return false;
 	
 	// Check difference between servo1 and servo2 (in case only one motor moves at a time)	
 	if (servoId == 1 || servoId == 2) {
 		long servo1Angle = angle;
 		long servo2Angle = angle;
-		if (servoId == 1) servo2Angle = getActAngle(2);
-		else if (servoId == 2) servo1Angle = getActAngle(1);
+		if (servoId == 1) servo2Angle = getKnownAngle(2);
+		else if (servoId == 2) servo1Angle = getKnownAngle(1);
 		return checkIfAngleDiffValid(servo1Angle, servo2Angle);
 	}
 	
 	return true;
 }
 
+bool morobot_p::checkIfJointLimitValid(uint8_t servoId, float angle){
+	// The values are NAN if the inverse kinematics does not provide a solution
+	if(!checkForNANerror(servoId, angle)) return false;
+	
+	// Moving the motors out of the joint limits may harm the robot's mechanics
+	if(angle < _jointLimits[servoId][0] || angle > _jointLimits[servoId][1]){
+		printInvalidAngleError(servoId, angle);
+		return false;
+	}
+	return true;
+}
+
 bool morobot_p::checkIfAngleDiffValid(float servo1Angle, float servo2Angle){
 	if (90 - servo1Angle - servo2Angle < 20){
 		Serial.println(F("Difference between motor2 and motor3 too small - could harm mechanics"));
+		setAngleError(PATH_CHECK_COUPLING, 2);
 		_tcpPoseIsValid = false;
 		return false;
 	}
 	
 	if (90 - servo1Angle - servo2Angle > 135){
 		Serial.println(F("Difference between motor2 and motor3 too big - could harm mechanics"));
+		setAngleError(PATH_CHECK_COUPLING, 2);
 		_tcpPoseIsValid = false;
 		return false;		
 	}
@@ -76,8 +86,12 @@ void morobot_p::moveHome(){
 	waitUntilIsReady();
 }
 
-String morobot_p::getType(){
-	return type;
+const char* morobot_p::getType(){
+	return "morobot_p";
+}
+
+uint8_t morobot_p::getTypeId(){
+	return typeId;
 }
 
 /* PROTECTED FUNCTIONS */
@@ -103,10 +117,11 @@ bool morobot_p::calculateAngles(float x, float y, float z){
 	theta3 = -1 * convertToDeg(theta3 + theta2 - M_PI/2);
 	theta2 = convertToDeg(theta2);
 	
-	//Check if angles are valid
-	if(checkIfAngleValid(0, theta1) == false) return false;
-	if(checkIfAngleValid(1, theta2) == false) return false;
-	if(checkIfAngleValid(2, theta3) == false) return false;
+	//Check if angles are valid (motor 2 and 3 are checked against each other, not against their current angles, so a pose does not depend on the one before)
+	if(checkIfJointLimitValid(0, theta1) == false) return false;
+	if(checkIfJointLimitValid(1, theta2) == false) return false;
+	if(checkIfJointLimitValid(2, theta3) == false) return false;
+	if(checkIfAngleDiffValid(theta2, theta3) == false) return false;
 	
 	// Store values
 	_goalAngles[0] = theta1;
@@ -122,9 +137,9 @@ void morobot_p::updateTCPpose(bool output){
 	waitUntilIsReady();
 	
 	// Get motor angles
-	float theta1 = getActAngle(0);
-	float theta2 = getActAngle(1);
-	float theta3 = -getActAngle(2);
+	float theta1 = getKnownAngle(0);
+	float theta2 = getKnownAngle(1);
+	float theta3 = -getKnownAngle(2);
 	
 	// Recalculate angles and convert to radians
     theta3 = theta3 - 90 - theta2;
@@ -6,13 +6,16 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobot_p() : morobotClass(3){};
+ *  		morobot_p() : morobotBase<3, morobot_p>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
+			bool checkIfAngleDiffValid(float servo1Angle, float servo2Angle);
 			void moveHome();
 		protected:
 			virtual bool calculateAngles(float x, float y, float z);
 			virtual void updateCurrentXYZ();
+		private:
+			bool checkIfJointLimitValid(uint8_t servoId, float angle);
  */
 
 #ifndef MOROBOT_P_H
@@ -20,13 +23,14 @@
 
 #include "morobot.h"
 
-class morobot_p:public morobotClass {
+class morobot_p:public morobotBase<3, morobot_p> {
+	friend class morobotBase<3, morobot_p>;	//!< Calls the kinematics of the robot without virtual function calls
 	public:
 		/**
 		 *  \brief Constructor of morobot_p class
-		 *  \details The value in brakets defines that the robot consists of three smartservos
+		 *  \details The template argument of morobotBase defines that the robot consists of three smartservos
 		 */
-		morobot_p() : morobotClass(3){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
+		morobot_p() : morobotBase<3, morobot_p>(){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
 		
 		/**
 		 *  \brief Set the position of the TCP (tool center point) with respect to the center of the flange of the last robot axis.
@@ -65,9 +69,15 @@ class morobot_p:public morobotClass {
 		 *  \brief Returns the type of the robot
 		 *  \return Returns morobot type
 		 */
-		virtual String getType();		
+		virtual const char* getType();
 		
-		const String type = "morobot_p";		//!< Type of morobot
+		/**
+		 *  \brief Returns the type id of the robot
+		 *  \return Returns ROBOT_TYPE_P
+		 */
+		virtual uint8_t getTypeId();
+		
+		static const uint8_t typeId = ROBOT_TYPE_P;		//!< Type of morobot
 		
 	protected:
 		/**
@@ -88,6 +98,14 @@ class morobot_p:public morobotClass {
 		virtual void updateTCPpose(bool output = false);
 
 	private:
+		/**
+		 *  \brief Checks if an angle is a solution of the inverse kinematics and inside the limits of the joint (without the difference to the other motors)
+		 *  \param [in] servoId Number of motor (first motor has ID 0)
+		 *  \param [in] angle Angle in degrees
+		 *  \return Returns true if the angle is valid; false if it is not.
+		 */
+		bool checkIfJointLimitValid(uint8_t servoId, float angle);
+
 		float _tcpOffset[3];	//!< Position of the TCP (tool center point) with respect to the center of the flange of the last robot axis
 		long _jointLimits[3][2] = {{-360, 360}, {0, 115}, {-100, 28}};		//!< Limits for all joints
 		uint8_t _axisLimits[3][2] = {{-300, 300}, {-300, 300}, {50, 210}};	//!< Limits of x, y, z axis
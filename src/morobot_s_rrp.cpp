@@ -6,7 +6,7 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobot_s_rrp() : morobotClass(3){};
+ *  		morobot_s_rrp() : morobotBase<3, morobot_s_rrp>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 			bool checkIfAnglesValid(float phi1, float phi2, float phi3);
@@ -58,7 +58,7 @@ bool morobot_s_rrp::checkIfAngleValid(uint8_t servoId, float angle){
 bool morobot_s_rrp::checkIfAnglesValid(float phi1, float phi2, float phi3){
 	float angles[3] = {phi1, phi2, phi3};
 	
-	for (uint8_t i = 0; i < _numSmartServos; i++) if(checkIfAngleValid(i, angles[i]) == false) return false;
+	for (uint8_t i = 0; i < numServos; i++) if(morobot_s_rrp::checkIfAngleValid(i, angles[i]) == false) return false;
 	return true;
 }
 
@@ -68,8 +68,12 @@ void morobot_s_rrp::moveZAxisIn(uint8_t maxMotorCurrent){
 	_tcpPoseIsValid = false;
 }
 
-String morobot_s_rrp::getType(){
-	return type;
+const char* morobot_s_rrp::getType(){
+	return "morobot_s_rrp";
+}
+
+uint8_t morobot_s_rrp::getTypeId(){
+	return typeId;
 }
 
 /* PROTECTED FUNCTIONS */
@@ -113,8 +117,8 @@ void morobot_s_rrp::updateTCPpose(bool output){
 	waitUntilIsReady();
 	
 	// Get anlges of all motors
-	float actAngles[_numSmartServos];
-	for (uint8_t i=0; i<_numSmartServos; i++) actAngles[i] = convertToRad(getActAngle(i));
+	float actAngles[numServos];
+	for (uint8_t i=0; i<_numSmartServos; i++) actAngles[i] = convertToRad(getKnownAngle(i));
 
 	// Change orientation or angle because of motor mounting orientation
 	actAngles[0] = -actAngles[0];
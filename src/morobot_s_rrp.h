@@ -6,7 +6,7 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		morobot_s_rrp() : morobotClass(3){};
+ *  		morobot_s_rrp() : morobotBase<3, morobot_s_rrp>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 			bool checkIfAnglesValid(float phi1, float phi2, float phi3);
@@ -21,13 +21,14 @@
 
 #include "morobot.h"
 
-class morobot_s_rrp:public morobotClass {
+class morobot_s_rrp:public morobotBase<3, morobot_s_rrp> {
+	friend class morobotBase<3, morobot_s_rrp>;	//!< Calls the kinematics of the robot without virtual function calls
 	public:
 		/**
 		 *  \brief Constructor of morobot_s_rrp class
-		 *  \details The value in brakets defines that the robot consists of three smartservos
+		 *  \details The template argument of morobotBase defines that the robot consists of three smartservos
 		 */
-		morobot_s_rrp() : morobotClass(3){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
+		morobot_s_rrp() : morobotBase<3, morobot_s_rrp>(){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
 		
 		/**
 		 *  \brief Set the position of the TCP (tool center point) with respect to the center of the flange of the last robot axis.
@@ -69,9 +70,15 @@ class morobot_s_rrp:public morobotClass {
 		 *  \brief Returns the type of the robot
 		 *  \return Returns morobot type
 		 */
-		virtual String getType();		
+		virtual const char* getType();
 		
-		const String type = "morobot_s_rrp";		//!< Type of morobot
+		/**
+		 *  \brief Returns the type id of the robot
+		 *  \return Returns ROBOT_TYPE_S_RRP
+		 */
+		virtual uint8_t getTypeId();
+		
+		static const uint8_t typeId = ROBOT_TYPE_S_RRP;		//!< Type of morobot
 
 	protected:
 		/**
@@ -0,0 +1,305 @@
+/**
+ *  \class 	motionProgram
+ *  \brief 	Interpreter for compact motion bytecode programs running on top of a morobot (and optionally a gripper)
+ *  @file 	motion_program.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		motionProgram(morobotClass* morobotToControl, gripper* gripperToControl=NULL);
+			bool load(const uint8_t* program, uint16_t length, bool inProgmem=false);
+			uint16_t receive(Stream* stream, uint8_t* buffer, uint16_t bufferSize, unsigned long timeout=2000);
+			bool check();
+			bool step();
+			bool run();
+			void stop();
+			bool isRunning();
+			uint8_t getError();
+			uint16_t getProgramCounter();
+			path_check_type getPathCheck();
+		private:
+			uint8_t readByte();
+			int16_t readShort();
+			bool fail(uint8_t error);
+			bool checkMove(uint8_t opcode, float pose[3]);
+ */
+
+#include "motion_program.h"
+
+motionProgram::motionProgram(morobotClass* morobotToControl, gripper* gripperToControl){
+	_morobot = morobotToControl;
+	_gripper = gripperToControl;
+	_program = NULL;
+	_length = 0;
+	_pc = 0;
+	_inProgmem = false;
+	_running = false;
+	_error = PROGRAM_OK;
+	_waitTime = 0;
+	_loopDepth = 0;
+	_checking = false;
+	_checkPosValid = false;
+	_pathCheck.error = PATH_CHECK_OK;
+	_pathCheck.index = -1;
+	_rxState = PROGRAM_RX_IDLE;
+	_stream = &Serial;
+}
+
+bool motionProgram::load(const uint8_t* program, uint16_t length, bool inProgmem){
+	_program = program;
+	_length = length;
+	_inProgmem = inProgmem;
+	_pc = 0;
+	_waitTime = 0;
+	_loopDepth = 0;
+	_error = PROGRAM_OK;
+	_running = false;
+
+	// Check magic bytes and version
+	if (_length < 3) return fail(PROGRAM_ERROR_HEADER);
+	if (readByte() != 'M' || readByte() != 'P' || readByte() != MOTION_PROGRAM_VERSION) return fail(PROGRAM_ERROR_HEADER);
+
+	_running = true;
+	return true;
+}
+
+uint16_t motionProgram::receive(Stream* stream, uint8_t* buffer, uint16_t bufferSize, unsigned long timeout){
+	// Errors of the received program are reported where it came from
+	_stream = stream;
+	
+	// Frames are received byte by byte over several calls, so the running program is not blocked
+	if (_rxState != PROGRAM_RX_IDLE && (millis() - _rxTime) > timeout) {
+		stream->println(F("TIMEOUT OCCURED WHILE RECEIVING PROGRAM!"));
+		_rxState = PROGRAM_RX_IDLE;
+	}
+
+	while (stream->available() > 0) {
+		uint8_t value = stream->read();
+		switch (_rxState) {
+			case PROGRAM_RX_IDLE:
+				if (value == 'M') {
+					_rxState = PROGRAM_RX_MAGIC;
+					_rxTime = millis();
+				}
+				break;
+			case PROGRAM_RX_MAGIC:
+				_rxState = (value == 'B') ? PROGRAM_RX_LENGTH_LOW : PROGRAM_RX_IDLE;
+				break;
+			case PROGRAM_RX_LENGTH_LOW:
+				_rxLength = value;
+				_rxState = PROGRAM_RX_LENGTH_HIGH;
+				break;
+			case PROGRAM_RX_LENGTH_HIGH:
+				_rxLength |= (uint16_t)value << 8;
+				if (_rxLength > bufferSize) {
+					stream->println(F("ERROR: Program too big for buffer"));
+					_rxState = PROGRAM_RX_IDLE;
+					break;
+				}
+				// The buffer is overwritten from now on, so a program running from it can not continue
+				if (_program == buffer) {
+					if (_running) stream->println(F("Program stopped to receive a new one"));
+					stop();
+					_program = NULL;
+					_length = 0;
+				}
+				_rxIndex = 0;
+				_rxChecksum = 0;
+				_rxState = PROGRAM_RX_DATA;
+				break;
+			case PROGRAM_RX_DATA:
+				if (_rxIndex < _rxLength) {
+					buffer[_rxIndex++] = value;
+					_rxChecksum += value;
+					break;
+				}
+				_rxState = PROGRAM_RX_IDLE;
+				if (value != _rxChecksum) {
+					stream->println(F("ERROR: Program checksum invalid"));
+					return 0;
+				}
+				if (load(buffer, _rxLength) == false) return 0;
+				return _rxLength;
+		}
+	}
+	return 0;
+}
+
+bool motionProgram::check(){
+	if (_program == NULL || _error == PROGRAM_ERROR_HEADER) return false;
+	
+	_checking = true;
+	_pc = 3;
+	_loopDepth = 0;
+	_waitTime = 0;
+	_error = PROGRAM_OK;
+	_running = true;
+	_pathCheck.error = PATH_CHECK_OK;
+	_pathCheck.index = -1;
+	
+	// The first linear movement starts at the current position
+	_checkPos[0] = _morobot->getActPosition('x');
+	_checkPos[1] = _morobot->getActPosition('y');
+	_checkPos[2] = _morobot->getActPosition('z');
+	_checkPosValid = true;
+	
+	while (step() == true);
+	_checking = false;
+	if (_error != PROGRAM_OK) return false;
+	
+	// Rewind, so the program can be run
+	_pc = 3;
+	_loopDepth = 0;
+	_running = true;
+	return true;
+}
+
+bool motionProgram::step(){
+	if (!_running) return false;
+
+	// Non-blocking wait
+	if (_waitTime != 0) {
+		if ((millis() - _waitStart) < _waitTime) return true;
+		_waitTime = 0;
+	}
+
+	if (_pc >= _length) return fail(PROGRAM_ERROR_TRUNCATED);
+	uint8_t opcode = readByte();
+
+	switch (opcode) {
+		case OP_END:
+			_running = false;
+			return false;
+		case OP_MOVE_POSE:
+		case OP_MOVE_LINEAR: {
+			if (_pc + 6 > _length) return fail(PROGRAM_ERROR_TRUNCATED);
+			float pose[3];
+			for (uint8_t i=0; i<3; i++) pose[i] = readShort() / 10.0;
+			if (_checking) {
+				if (checkMove(opcode, pose) == false) return fail(PROGRAM_ERROR_UNREACHABLE);
+			}
+			else if (opcode == OP_MOVE_LINEAR) _morobot->moveLinear(pose);
+			else if (_morobot->moveToPose(pose[0], pose[1], pose[2]) == false) return fail(PROGRAM_ERROR_UNREACHABLE);
+			break;
+		}
+		case OP_MOVE_ANGLES: {
+			if (_pc + 1 > _length) return fail(PROGRAM_ERROR_TRUNCATED);
+			uint8_t numAngles = readByte();
+			if (numAngles != _morobot->getNumSmartServos()) return fail(PROGRAM_ERROR_ARGUMENT);
+			if (_pc + 2*numAngles > _length) return fail(PROGRAM_ERROR_TRUNCATED);
+			long angles[NUM_MAX_SERVOS];
+			for (uint8_t i=0; i<numAngles; i++) angles[i] = readShort();
+			if (_checking) {
+				// The position after the movement is not calculated, the next linear movement is checked from its goal only
+				for (uint8_t i=0; i<numAngles; i++) if (_morobot->checkIfAngleValid(i, angles[i]) == false) return fail(PROGRAM_ERROR_UNREACHABLE);
+				_checkPosValid = false;
+			}
+			else _morobot->moveToAngles(angles);
+			break;
+		}
+		case OP_GRIPPER_OPEN:
+		case OP_GRIPPER_CLOSE:
+			if (_gripper == NULL) return fail(PROGRAM_ERROR_NO_GRIPPER);
+			if (_checking) break;
+			_morobot->waitUntilIsReady();
+			if (opcode == OP_GRIPPER_OPEN) _gripper->open();
+			else _gripper->close();
+			break;
+		case OP_WAIT:
+			if (_pc + 2 > _length) return fail(PROGRAM_ERROR_TRUNCATED);
+			_waitTime = (uint16_t)readShort();
+			_waitStart = millis();
+			if (_checking) _waitTime = 0;
+			break;
+		case OP_LOOP:
+			if (_pc + 2 > _length) return fail(PROGRAM_ERROR_TRUNCATED);
+			if (_loopDepth >= MOTION_PROGRAM_MAX_LOOPS) return fail(PROGRAM_ERROR_LOOP);
+			_loopCount[_loopDepth] = (uint16_t)readShort();
+			if (_checking && _loopCount[_loopDepth] != 1) _loopCount[_loopDepth] = 2;
+			_loopStart[_loopDepth] = _pc;
+			_loopDepth++;
+			break;
+		case OP_END_LOOP:
+			if (_loopDepth == 0) return fail(PROGRAM_ERROR_LOOP);
+			// A count of 0 repeats the loop forever, otherwise repeat until the count is used up
+			if (_loopCount[_loopDepth-1] == 0 || --_loopCount[_loopDepth-1] > 0) _pc = _loopStart[_loopDepth-1];
+			else _loopDepth--;
+			break;
+		case OP_SPEED:
+			if (_pc + 1 > _length) return fail(PROGRAM_ERROR_TRUNCATED);
+			if (_checking) readByte();
+			else _morobot->setSpeedRPM(readByte());
+			break;
+		default:
+			return fail(PROGRAM_ERROR_OPCODE);
+	}
+	return true;
+}
+
+bool motionProgram::run(){
+	while (step() == true);
+	return _error == PROGRAM_OK;
+}
+
+void motionProgram::stop(){
+	_running = false;
+	_waitTime = 0;
+}
+
+bool motionProgram::isRunning(){
+	return _running;
+}
+
+uint8_t motionProgram::getError(){
+	return _error;
+}
+
+uint16_t motionProgram::getProgramCounter(){
+	return _pc;
+}
+
+path_check_type motionProgram::getPathCheck(){
+	return _pathCheck;
+}
+
+/* PRIVATE */
+uint8_t motionProgram::readByte(){
+	uint8_t value;
+	if (_inProgmem) value = pgm_read_byte(_program + _pc);
+	else value = _program[_pc];
+	_pc++;
+	return value;
+}
+
+int16_t motionProgram::readShort(){
+	uint16_t value = readByte();
+	value |= (uint16_t)readByte() << 8;
+	return (int16_t)value;
+}
+
+bool motionProgram::fail(uint8_t error){
+	_error = error;
+	_running = false;
+	_waitTime = 0;
+	_stream->print(F("ERROR in motion program at byte "));
+	_stream->print(_pc);
+	_stream->print(F(": error code "));
+	_stream->println(error);
+	return false;
+}
+
+bool motionProgram::checkMove(uint8_t opcode, float pose[3]){
+	bool valid;
+	if (opcode == OP_MOVE_LINEAR && _checkPosValid) {
+		// Same interpolation points as morobotClass::moveLinear()
+		linePath path(_checkPos, pose);
+		valid = _morobot->checkPath(&path, 0, &_pathCheck);
+	} else {
+		waypointPath path((float (*)[3])pose, 1);
+		valid = _morobot->checkPath(&path, 0, &_pathCheck);
+	}
+	
+	for (uint8_t i=0; i<3; i++) _checkPos[i] = pose[i];
+	_checkPosValid = true;
+	return valid;
+}
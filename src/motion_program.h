@@ -0,0 +1,204 @@
+/**
+ *  \class 	motionProgram
+ *  \brief 	Interpreter for compact motion bytecode programs running on top of a morobot (and optionally a gripper)
+ *  @file 	motion_program.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		motionProgram(morobotClass* morobotToControl, gripper* gripperToControl=NULL);
+			bool load(const uint8_t* program, uint16_t length, bool inProgmem=false);
+			uint16_t receive(Stream* stream, uint8_t* buffer, uint16_t bufferSize, unsigned long timeout=2000);
+			bool check();
+			bool step();
+			bool run();
+			void stop();
+			bool isRunning();
+			uint8_t getError();
+			uint16_t getProgramCounter();
+			path_check_type getPathCheck();
+		private:
+			uint8_t readByte();
+			int16_t readShort();
+			bool fail(uint8_t error);
+			bool checkMove(uint8_t opcode, float pose[3]);
+ *  \par Program format:
+ *  	A program starts with the two magic bytes 'M' 'P' followed by the format version and a sequence of instructions.
+ *  	Every instruction is one opcode byte followed by its arguments. All multi-byte values are little-endian.
+ *  	Positions are given in 1/10 mm, angles in degrees.
+ *  		OP_END										Stops the program
+ *  		OP_MOVE_POSE		int16 x, y, z			morobotClass::moveToPose()
+ *  		OP_MOVE_ANGLES		uint8 n, int16 angle[n]	morobotClass::moveToAngles()
+ *  		OP_MOVE_LINEAR		int16 x, y, z			morobotClass::moveLinear()
+ *  		OP_GRIPPER_OPEN								gripper::open()
+ *  		OP_GRIPPER_CLOSE							gripper::close()
+ *  		OP_WAIT				uint16 ms				Waits without blocking step()
+ *  		OP_LOOP				uint16 count			Repeats the block until OP_END_LOOP count times (0 = forever)
+ *  		OP_END_LOOP									End of the innermost loop
+ *  		OP_SPEED			uint8 rpm				morobotClass::setSpeedRPM()
+ *  	Programs are created with the host-side assembler in extras/motion_program.
+ *  	check() runs through a loaded program without moving the robot and finds unreachable poses and linear movements before the robot starts.
+ *  	For transmission over a serial port a program is framed as 'M' 'B' uint16 length, program bytes, uint8 checksum (sum of program bytes).
+ */
+
+#ifndef MOTION_PROGRAM_H
+#define MOTION_PROGRAM_H
+
+#include "morobot.h"
+
+#define MOTION_PROGRAM_VERSION		1		//!< Version of the bytecode format
+#define MOTION_PROGRAM_MAX_LOOPS	4		//!< Maximum nesting depth of loops
+
+#define OP_END				0x00	//!< End of program
+#define OP_MOVE_POSE		0x01	//!< Move TCP to pose (x, y, z in 1/10 mm)
+#define OP_MOVE_ANGLES		0x02	//!< Move joints to angles (number of angles, angles in degrees)
+#define OP_MOVE_LINEAR		0x03	//!< Move TCP along a line (x, y, z in 1/10 mm)
+#define OP_GRIPPER_OPEN		0x04	//!< Open gripper
+#define OP_GRIPPER_CLOSE	0x05	//!< Close gripper
+#define OP_WAIT				0x06	//!< Wait (milliseconds)
+#define OP_LOOP				0x07	//!< Start of loop (number of repetitions, 0 = forever)
+#define OP_END_LOOP			0x08	//!< End of loop
+#define OP_SPEED			0x09	//!< Set default speed (RPM)
+
+#define PROGRAM_OK					0	//!< No error
+#define PROGRAM_ERROR_HEADER		1	//!< Missing magic bytes or unsupported version
+#define PROGRAM_ERROR_OPCODE		2	//!< Unknown opcode
+#define PROGRAM_ERROR_TRUNCATED		3	//!< Instruction exceeds the program length
+#define PROGRAM_ERROR_LOOP			4	//!< Loops nested too deep or OP_END_LOOP without OP_LOOP
+#define PROGRAM_ERROR_UNREACHABLE	5	//!< A pose could not be reached
+#define PROGRAM_ERROR_NO_GRIPPER	6	//!< Gripper instruction without attached gripper
+#define PROGRAM_ERROR_ARGUMENT		7	//!< Invalid argument (e.g. number of angles does not match the robot)
+
+#define PROGRAM_RX_IDLE				0	//!< receive(): waiting for the start of a frame
+#define PROGRAM_RX_MAGIC			1	//!< receive(): waiting for the second magic byte
+#define PROGRAM_RX_LENGTH_LOW		2	//!< receive(): waiting for the low byte of the length
+#define PROGRAM_RX_LENGTH_HIGH		3	//!< receive(): waiting for the high byte of the length
+#define PROGRAM_RX_DATA				4	//!< receive(): receiving the program bytes and the checksum
+
+class motionProgram {
+	public:
+		/**
+		 *  \brief Constructor of motionProgram class
+		 *  \param [in] morobotToControl Pointer to the morobot which executes the program
+		 *  \param [in] gripperToControl (Optional) Pointer to the gripper used by OP_GRIPPER_OPEN/OP_GRIPPER_CLOSE
+		 *  \details Errors are printed to Serial until a program is received with receive().
+		 */
+		motionProgram(morobotClass* morobotToControl, gripper* gripperToControl=NULL);
+
+		/**
+		 *  \brief Loads a program and checks its header. The program is not copied, so the memory must stay valid while running.
+		 *  \param [in] program Pointer to the program bytes
+		 *  \param [in] length Number of bytes of the program
+		 *  \param [in] inProgmem (Optional) Set to true if the program is stored in flash (PROGMEM)
+		 *  \return Returns true if the program header is valid
+		 */
+		bool load(const uint8_t* program, uint16_t length, bool inProgmem=false);
+
+		/**
+		 *  \brief Receives a framed program from a stream (e.g. Serial) into a buffer and loads it. Does not wait for data: call it repeatedly (e.g. in loop()),
+		 *  		every call reads the bytes available so far. A program running from the same buffer is stopped before the first byte is overwritten.
+		 *  \param [in] stream Stream to read the program from. All errors (also those of load(), check() and step()) are printed to this stream from now on.
+		 *  \param [in] buffer Buffer to store the program in
+		 *  \param [in] bufferSize Size of the buffer
+		 *  \param [in] timeout (Optional) Time in ms to wait for the program bytes after the frame started
+		 *  \return Returns the length of the program once it has been received completely, 0 otherwise
+		 */
+		uint16_t receive(Stream* stream, uint8_t* buffer, uint16_t bufferSize, unsigned long timeout=2000);
+
+		/**
+		 *  \brief Checks the loaded program without moving the robot. Poses and linear movements are checked with morobotClass::checkPath(),
+		 *  		starting at the current position of the robot. Loops are checked twice, so the return to the start of the loop is included.
+		 *  \return Returns true if the program can be executed. Otherwise the program is stopped and getError(), getProgramCounter() and getPathCheck() describe the first failing instruction.
+		 */
+		bool check();
+
+		/**
+		 *  \brief Executes the next instruction. Waits (OP_WAIT) do not block, step() returns immediately until the time is over.
+		 *  \return Returns true as long as the program is running; false if it has finished or an error occured
+		 */
+		bool step();
+
+		/**
+		 *  \brief Executes the whole program
+		 *  \return Returns true if the program finished without error
+		 */
+		bool run();
+
+		/**
+		 *  \brief Stops the program. The current movement is finished by the robot.
+		 */
+		void stop();
+
+		/**
+		 *  \brief Checks if a program is running
+		 *  \return Returns true if a program is loaded and has not finished yet
+		 */
+		bool isRunning();
+
+		/**
+		 *  \brief Returns the last error (PROGRAM_OK, PROGRAM_ERROR_...)
+		 */
+		uint8_t getError();
+
+		/**
+		 *  \brief Returns the offset of the next instruction in the program
+		 */
+		uint16_t getProgramCounter();
+
+		/**
+		 *  \brief Returns the result of the path check of the last movement checked by check()
+		 */
+		path_check_type getPathCheck();
+
+	private:
+		/**
+		 *  \brief Reads the next byte of the program and increases the program counter
+		 */
+		uint8_t readByte();
+
+		/**
+		 *  \brief Reads the next little-endian 16 bit value of the program and increases the program counter
+		 */
+		int16_t readShort();
+
+		/**
+		 *  \brief Stores the error, prints it to the stream of the last receive() (or Serial) and stops the program
+		 *  \param [in] error Error code (PROGRAM_ERROR_...)
+		 *  \return Returns always false
+		 */
+		bool fail(uint8_t error);
+
+		/**
+		 *  \brief Checks a movement instruction and updates the position the next linear movement starts at
+		 *  \param [in] opcode OP_MOVE_POSE or OP_MOVE_LINEAR
+		 *  \param [in] pose Goal position
+		 *  \return Returns true if the movement can be executed
+		 */
+		bool checkMove(uint8_t opcode, float pose[3]);
+
+		morobotClass* _morobot;			//!< Robot executing the program
+		gripper* _gripper;				//!< Gripper used by the program (may be NULL)
+		const uint8_t* _program;		//!< Program bytes
+		uint16_t _length;				//!< Length of the program
+		uint16_t _pc;					//!< Program counter (offset of next instruction)
+		bool _inProgmem;				//!< True if the program is stored in flash
+		bool _running;					//!< True while the program is running
+		uint8_t _error;					//!< Last error
+		unsigned long _waitStart;		//!< Start time of a running OP_WAIT
+		uint16_t _waitTime;				//!< Duration of a running OP_WAIT (0 if not waiting)
+		uint8_t _loopDepth;								//!< Number of open loops
+		uint16_t _loopStart[MOTION_PROGRAM_MAX_LOOPS];	//!< Program counter of the first instruction in each open loop
+		uint16_t _loopCount[MOTION_PROGRAM_MAX_LOOPS];	//!< Remaining repetitions of each open loop (0 = forever)
+		bool _checking;					//!< True while check() runs through the program (nothing is executed)
+		float _checkPos[3];				//!< Position of the TCP after the instructions checked so far
+		bool _checkPosValid;			//!< False if the position is not known (e.g. after OP_MOVE_ANGLES)
+		path_check_type _pathCheck;		//!< Result of the last checked movement
+		uint8_t _rxState;				//!< State of receive() (PROGRAM_RX_...)
+		uint16_t _rxLength;				//!< Length of the program received at the moment
+		uint16_t _rxIndex;				//!< Number of program bytes received
+		uint8_t _rxChecksum;			//!< Sum of the program bytes received
+		unsigned long _rxTime;			//!< Time the frame started
+		Stream* _stream;				//!< Stream errors are printed to (Serial or the stream of the last receive())
+};
+
+#endif
@@ -6,7 +6,7 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		newRobotClass_Template() : morobotClass(NUM_SERVOS){};
+ *  		newRobotClass_Template() : morobotBase<NUM_SERVOS, newRobotClass_Template>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 		protected:
@@ -39,8 +39,12 @@ bool newRobotClass_Template::checkIfAngleValid(uint8_t servoId, float angle){
 	return true;
 }
 
-String newRobotClass_Template::getType(){
-	return type;
+const char* newRobotClass_Template::getType(){
+	return "newRobotClass_Template";
+}
+
+uint8_t newRobotClass_Template::getTypeId(){
+	return typeId;
 }
 
 
@@ -6,7 +6,7 @@
  *  @date	2020/11/27
  *  \par Method List:
  *  	public:
- *  		newRobotClass_Template() : morobotClass(NUM_SERVOS){};
+ *  		newRobotClass_Template() : morobotBase<NUM_SERVOS, newRobotClass_Template>(){};
 			virtual void setTCPoffset(float xOffset, float yOffset, float zOffset);
 			virtual bool checkIfAngleValid(uint8_t servoId, float angle);
 		protected:
@@ -19,13 +19,14 @@
 
 #include <morobot.h>
 
-class newRobotClass_Template:public morobotClass {
+class newRobotClass_Template:public morobotBase<3, newRobotClass_Template> {	// TODO: PUT THE NUMBER OF SERVOS HERE, IN THE FRIEND DECLARATION AND IN THE CONSTRUCTOR
+	friend class morobotBase<3, newRobotClass_Template>;	//!< Calls the kinematics of the robot without virtual function calls
 	public:
 		/**
 		 *  \brief Constructor of newRobotClass_Template class
-		 *  \details The value in brakets defines the number of smart servo motors
+		 *  \details The template argument of morobotBase defines the number of smart servo motors
 		 */
-		newRobotClass_Template() : morobotClass(3){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};	// TODO: PUT THE NUMBER OF SERVOS HERE
+		newRobotClass_Template() : morobotBase<3, newRobotClass_Template>(){memcpy(_robotJointLimits, _jointLimits, 3*2*sizeof(long)); memcpy(_robotAxisLimits, _axisLimits, 3*2*sizeof(uint8_t));};
 		
 		/**
 		 *  \brief Set the position of the TCP (tool center point) with respect to the center of the flange of the last robot axis.
@@ -51,9 +52,15 @@ class newRobotClass_Template:public morobotClass {
 		 *  \brief Returns the type of the robot
 		 *  \return Returns morobot type
 		 */
-		virtual String getType();		
+		virtual const char* getType();
 		
-		const String type = "newRobotClass_Template";		//!< Type of morobot
+		/**
+		 *  \brief Returns the type id of the robot
+		 *  \return Returns ROBOT_TYPE_CUSTOM
+		 */
+		virtual uint8_t getTypeId();
+		
+		static const uint8_t typeId = ROBOT_TYPE_CUSTOM;		//!< Type of morobot	// TODO: CHOOSE A TYPE ID (ROBOT_TYPE_CUSTOM OR ABOVE)
 
 	protected:
 		/**
@@ -0,0 +1,496 @@
+/**
+ *  \class 	pathSource, linePath, waypointPath, circularPath, splinePath, pathTrigger
+ *  \brief 	Cartesian paths which generate their interpolation points on demand, so the memory used by a movement does not depend on its length or resolution
+ *  @file 	path.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	pathSource:
+ *  		public:
+ *  			pathSource();
+				void reset();
+				bool next(float point[3]);
+				uint16_t getIndex();
+				~pathSource();
+				bool addTrigger(pathTrigger* trigger);
+				void clearTriggers();
+				void resetTriggers();
+				void fireTriggers(float s, float t, float totalTime);
+				void cancelTriggers();
+ *  	pathTrigger:
+ *  		public:
+ *  			pathTrigger(uint8_t type, float value, pathTriggerCb callback, void* arg=NULL, pathTriggerCb cancelCallback=NULL);
+				bool check(float s, float length, float t, float totalTime);
+				void reset();
+				bool cancel();
+				bool hasFired();
+ *  	linePath:
+ *  		public:
+ *  			linePath(const float start[3], const float goal[3], float resolution=5);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+ *  	waypointPath:
+ *  		public:
+ *  			waypointPath(float points[][3], uint16_t nrPoints, const float start[3]=NULL);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+			private:
+				const float* getCorner(int16_t index);
+ *  	circularPath:
+ *  		public:
+ *  			circularPath(const float start[3], const float point[3], const float goal[3], uint8_t mode=ARC_CENTER_CCW, float resolution=5);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+			private:
+				void setLine(const float start[3], const float goal[3]);
+ *  	splinePath:
+ *  		public:
+ *  			splinePath(const float start[3], float points[][3], uint16_t nrPoints, uint8_t type=SPLINE_CATMULL_ROM, float resolution=5);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+			private:
+				uint16_t getNumSegments();
+				const float* getControlPoint(int16_t index);
+				void evaluate(uint16_t segment, float u, float point[3]);
+ */
+
+#include "path.h"
+
+/* pathTrigger */
+pathTrigger::pathTrigger(uint8_t type, float value, pathTriggerCb callback, void* arg, pathTriggerCb cancelCallback){
+	_type = type;
+	_value = value;
+	_callback = callback;
+	_cancelCallback = cancelCallback;
+	_arg = arg;
+	_fired = false;
+	_path = NULL;
+	_next = NULL;
+}
+
+bool pathTrigger::check(float s, float length, float t, float totalTime){
+	if (_fired) return false;
+	bool passed = false;
+	if (_type == TRIGGER_FRACTION) passed = s >= _value*length;
+	else if (_type == TRIGGER_DISTANCE) passed = s >= ((_value < 0) ? length + _value : _value);
+	else if (_type == TRIGGER_TIME) passed = t >= ((_value < 0) ? totalTime + _value : _value);
+	if (!passed) return false;
+	
+	_fired = true;
+	if (_callback != NULL) _callback(_arg);
+	return true;
+}
+
+void pathTrigger::reset(){
+	_fired = false;
+}
+
+bool pathTrigger::cancel(){
+	if (!_fired || _cancelCallback == NULL) return false;
+	_cancelCallback(_arg);
+	return true;
+}
+
+bool pathTrigger::hasFired(){
+	return _fired;
+}
+
+/* pathSource */
+pathSource::pathSource(){
+	_index = 0;
+	_triggers = NULL;
+}
+
+pathSource::~pathSource(){
+	clearTriggers();
+}
+
+void pathSource::reset(){
+	_index = 0;
+}
+
+bool pathSource::next(float point[3]){
+	if (_index >= getNumPoints()) return false;
+	getPoint(_index, point);
+	_index++;
+	return true;
+}
+
+uint16_t pathSource::getIndex(){
+	return _index;
+}
+
+bool pathSource::addTrigger(pathTrigger* trigger){
+	// The triggers are linked through the trigger itself, so adding it twice would corrupt the list
+	if (trigger->_path != NULL){
+		Serial.println(F("ERROR: Trigger has already been added to a path"));
+		return false;
+	}
+	trigger->_path = this;
+	trigger->_next = _triggers;
+	_triggers = trigger;
+	return true;
+}
+
+void pathSource::clearTriggers(){
+	while (_triggers != NULL){
+		pathTrigger* trigger = _triggers;
+		_triggers = trigger->_next;
+		trigger->_path = NULL;
+		trigger->_next = NULL;
+	}
+}
+
+void pathSource::resetTriggers(){
+	for (pathTrigger* trigger = _triggers; trigger != NULL; trigger = trigger->_next) trigger->reset();
+}
+
+void pathSource::fireTriggers(float s, float t, float totalTime){
+	if (_triggers == NULL) return;
+	float length = getLength();
+	for (pathTrigger* trigger = _triggers; trigger != NULL; trigger = trigger->_next) trigger->check(s, length, t, totalTime);
+}
+
+void pathSource::cancelTriggers(){
+	for (pathTrigger* trigger = _triggers; trigger != NULL; trigger = trigger->_next) trigger->cancel();
+}
+
+/* linePath */
+linePath::linePath(const float start[3], const float goal[3], float resolution){
+	_length = 0;
+	for (uint8_t i=0; i<3; i++){
+		_start[i] = start[i];
+		_dir[i] = goal[i]-start[i];
+		_length += _dir[i]*_dir[i];
+	}
+	_length = sqrt(_length);
+
+	if (resolution <= 0) resolution = _length;
+	if (_length <= 0) _numPoints = 0;
+	else if (_length/resolution > 65535) _numPoints = 65535;
+	else _numPoints = _length/resolution;
+}
+
+uint16_t linePath::getNumPoints(){
+	return _numPoints;
+}
+
+void linePath::getPoint(uint16_t index, float point[3]){
+	// X(s)=A+sv, where A=Startpoint, v=Goalpoint-Startpoint (direction), s=Intervall*(1/numberOfIntervalls)
+	float s = (index+1)/float(_numPoints);
+	for (uint8_t i=0; i<3; i++) point[i] = _start[i] + s*_dir[i];
+}
+
+float linePath::getLength(){
+	return _length;
+}
+
+void linePath::getPointAt(float s, float point[3]){
+	float ratio = 0;
+	if (_length > 0) ratio = constrain(s/_length, 0.0f, 1.0f);
+	for (uint8_t i=0; i<3; i++) point[i] = _start[i] + ratio*_dir[i];
+}
+
+/* waypointPath */
+waypointPath::waypointPath(float points[][3], uint16_t nrPoints, const float start[3]){
+	_points = points;
+	_numPoints = nrPoints;
+
+	for (uint8_t i=0; i<3; i++){
+		if (start != NULL) _start[i] = start[i];
+		else if (nrPoints > 0) _start[i] = points[0][i];
+		else _start[i] = 0;
+	}
+
+	_length = 0;
+	for (int16_t k=0; k<(int16_t)_numPoints; k++){
+		const float* a = getCorner(k-1);
+		const float* b = getCorner(k);
+		_length += sqrt(pow(b[0]-a[0], 2) + pow(b[1]-a[1], 2) + pow(b[2]-a[2], 2));
+	}
+}
+
+uint16_t waypointPath::getNumPoints(){
+	return _numPoints;
+}
+
+void waypointPath::getPoint(uint16_t index, float point[3]){
+	for (uint8_t i=0; i<3; i++) point[i] = _points[index][i];
+}
+
+float waypointPath::getLength(){
+	return _length;
+}
+
+void waypointPath::getPointAt(float s, float point[3]){
+	// Walk along the segments until the one containing s is found
+	const float* a = getCorner(-1);
+	for (int16_t k=0; k<(int16_t)_numPoints; k++){
+		const float* b = getCorner(k);
+		float segLength = sqrt(pow(b[0]-a[0], 2) + pow(b[1]-a[1], 2) + pow(b[2]-a[2], 2));
+		if (s <= segLength || k == (int16_t)_numPoints-1){
+			float ratio = 0;
+			if (segLength > 0) ratio = constrain(s/segLength, 0.0f, 1.0f);
+			for (uint8_t i=0; i<3; i++) point[i] = a[i] + ratio*(b[i]-a[i]);
+			return;
+		}
+		s -= segLength;
+		a = b;
+	}
+	for (uint8_t i=0; i<3; i++) point[i] = a[i];
+}
+
+/* PRIVATE */
+const float* waypointPath::getCorner(int16_t index){
+	if (index < 0) return _start;
+	return _points[index];
+}
+
+/* circularPath */
+circularPath::circularPath(const float start[3], const float point[3], const float goal[3], uint8_t mode, float resolution){
+	if (mode == ARC_THREE_POINT){
+		// Center of the circle through start (a), via point (b) and goal (c)
+		float ab[3], ac[3], n[3];
+		for (uint8_t i=0; i<3; i++){
+			ab[i] = point[i]-start[i];
+			ac[i] = goal[i]-start[i];
+		}
+		n[0] = ab[1]*ac[2] - ab[2]*ac[1];
+		n[1] = ab[2]*ac[0] - ab[0]*ac[2];
+		n[2] = ab[0]*ac[1] - ab[1]*ac[0];
+		float nSQ = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+		float abSQ = ab[0]*ab[0] + ab[1]*ab[1] + ab[2]*ab[2];
+		float acSQ = ac[0]*ac[0] + ac[1]*ac[1] + ac[2]*ac[2];
+		if (nSQ < 1e-6*abSQ*acSQ || nSQ == 0){
+			setLine(start, goal);	// Points on a line
+		}else{
+			// center = a + (|ac|^2 * (n x ab) + |ab|^2 * (ac x n)) / (2*|n|^2)
+			float nxab[3], acxn[3];
+			nxab[0] = n[1]*ab[2] - n[2]*ab[1];
+			nxab[1] = n[2]*ab[0] - n[0]*ab[2];
+			nxab[2] = n[0]*ab[1] - n[1]*ab[0];
+			acxn[0] = ac[1]*n[2] - ac[2]*n[1];
+			acxn[1] = ac[2]*n[0] - ac[0]*n[2];
+			acxn[2] = ac[0]*n[1] - ac[1]*n[0];
+			for (uint8_t i=0; i<3; i++) _center[i] = start[i] + (acSQ*nxab[i] + abSQ*acxn[i])/(2*nSQ);
+			
+			_radius = 0;
+			for (uint8_t i=0; i<3; i++){
+				_u[i] = start[i]-_center[i];
+				_radius += _u[i]*_u[i];
+			}
+			_radius = sqrt(_radius);
+			float nLength = sqrt(nSQ);
+			for (uint8_t i=0; i<3; i++){
+				_u[i] /= _radius;
+				n[i] /= nLength;
+			}
+			// Start, via point and goal are counterclockwise around n
+			_v[0] = n[1]*_u[2] - n[2]*_u[1];
+			_v[1] = n[2]*_u[0] - n[0]*_u[2];
+			_v[2] = n[0]*_u[1] - n[1]*_u[0];
+		}
+	}else{
+		// Arc around the center in the XY-plane of the start point
+		_center[0] = point[0];
+		_center[1] = point[1];
+		_center[2] = start[2];
+		_u[0] = start[0]-_center[0];
+		_u[1] = start[1]-_center[1];
+		_u[2] = 0;
+		_radius = sqrt(_u[0]*_u[0] + _u[1]*_u[1]);
+		if (_radius < 0.01){
+			setLine(start, goal);
+		}else{
+			_u[0] /= _radius;
+			_u[1] /= _radius;
+			float direction = 1;
+			if (mode == ARC_CENTER_CW) direction = -1;
+			_v[0] = -direction*_u[1];
+			_v[1] = direction*_u[0];
+			_v[2] = 0;
+		}
+	}
+	
+	if (_radius > 0){
+		// Angle from the start to the goal in direction of movement (a full circle if they are equal)
+		float dx = goal[0]-_center[0];
+		float dy = goal[1]-_center[1];
+		float dz = goal[2]-_center[2];
+		_sweep = atan2(dx*_v[0] + dy*_v[1] + dz*_v[2], dx*_u[0] + dy*_u[1] + dz*_u[2]);
+		if (_sweep <= 0.0001) _sweep += 2*M_PI;
+		
+		// Remaining offset to the goal (e.g. Z of a helix) is added linearly
+		for (uint8_t i=0; i<3; i++) _offset[i] = goal[i] - (_center[i] + _radius*(cos(_sweep)*_u[i] + sin(_sweep)*_v[i]));
+		float arcLength = _radius*_sweep;
+		_length = sqrt(arcLength*arcLength + _offset[0]*_offset[0] + _offset[1]*_offset[1] + _offset[2]*_offset[2]);
+	}
+	
+	if (resolution <= 0) resolution = _length;
+	if (_length <= 0) _numPoints = 0;
+	else if (_length/resolution > 65535) _numPoints = 65535;
+	else _numPoints = _length/resolution;
+}
+
+uint16_t circularPath::getNumPoints(){
+	return _numPoints;
+}
+
+void circularPath::getPoint(uint16_t index, float point[3]){
+	getPointAt((index+1)*_length/_numPoints, point);
+}
+
+float circularPath::getLength(){
+	return _length;
+}
+
+void circularPath::getPointAt(float s, float point[3]){
+	float ratio = 0;
+	if (_length > 0) ratio = constrain(s/_length, 0.0f, 1.0f);
+	float phi = ratio*_sweep;
+	float c = cos(phi);
+	float sn = sin(phi);
+	for (uint8_t i=0; i<3; i++) point[i] = _center[i] + _radius*(c*_u[i] + sn*_v[i]) + ratio*_offset[i];
+}
+
+/* PRIVATE */
+void circularPath::setLine(const float start[3], const float goal[3]){
+	_radius = 0;
+	_sweep = 0;
+	_length = 0;
+	for (uint8_t i=0; i<3; i++){
+		_center[i] = start[i];
+		_u[i] = 0;
+		_v[i] = 0;
+		_offset[i] = goal[i]-start[i];
+		_length += _offset[i]*_offset[i];
+	}
+	_length = sqrt(_length);
+}
+
+/* splinePath */
+splinePath::splinePath(const float start[3], float points[][3], uint16_t nrPoints, uint8_t type, float resolution){
+	_points = points;
+	_numPoints = nrPoints;
+	_type = type;
+	for (uint8_t i=0; i<3; i++) _start[i] = start[i];
+	
+	// Arc length as sum of the chords (the same chords are used by getPointAt())
+	_length = 0;
+	float a[3], b[3];
+	for (uint16_t k=0; k<getNumSegments(); k++){
+		evaluate(k, 0, a);
+		for (uint8_t step=1; step<=SPLINE_STEPS; step++){
+			evaluate(k, step/float(SPLINE_STEPS), b);
+			_length += sqrt(pow(b[0]-a[0], 2) + pow(b[1]-a[1], 2) + pow(b[2]-a[2], 2));
+			for (uint8_t i=0; i<3; i++) a[i] = b[i];
+		}
+	}
+	
+	if (resolution <= 0) resolution = _length;
+	if (_length <= 0) _numInterpolation = 0;
+	else if (_length/resolution > 65535) _numInterpolation = 65535;
+	else _numInterpolation = _length/resolution;
+	
+	_cursorS = -1;	// Cursor is set by the first call of getPointAt()
+}
+
+uint16_t splinePath::getNumPoints(){
+	return _numInterpolation;
+}
+
+void splinePath::getPoint(uint16_t index, float point[3]){
+	getPointAt((index+1)*_length/_numInterpolation, point);
+}
+
+float splinePath::getLength(){
+	return _length;
+}
+
+void splinePath::getPointAt(float s, float point[3]){
+	if (getNumSegments() == 0){
+		for (uint8_t i=0; i<3; i++) point[i] = _start[i];
+		return;
+	}
+	
+	// Restart at the beginning if the distance decreases
+	if (s < _cursorS || _cursorS < 0){
+		_cursorSegment = 0;
+		_cursorStep = 0;
+		_cursorS = 0;
+		evaluate(0, 0, _cursorPoint);
+	}
+	
+	// Move the cursor along the chords until the chord containing s is found
+	float next[3];
+	while (true){
+		evaluate(_cursorSegment, (_cursorStep+1)/float(SPLINE_STEPS), next);
+		float chord = sqrt(pow(next[0]-_cursorPoint[0], 2) + pow(next[1]-_cursorPoint[1], 2) + pow(next[2]-_cursorPoint[2], 2));
+		bool lastChord = (_cursorSegment == getNumSegments()-1 && _cursorStep == SPLINE_STEPS-1);
+		
+		if (s <= _cursorS + chord || lastChord){
+			float ratio = 0;
+			if (chord > 0) ratio = constrain((s-_cursorS)/chord, 0.0f, 1.0f);
+			evaluate(_cursorSegment, (_cursorStep+ratio)/float(SPLINE_STEPS), point);
+			return;
+		}
+		
+		_cursorS += chord;
+		for (uint8_t i=0; i<3; i++) _cursorPoint[i] = next[i];
+		_cursorStep++;
+		if (_cursorStep >= SPLINE_STEPS){
+			_cursorStep = 0;
+			_cursorSegment++;
+		}
+	}
+}
+
+/* PRIVATE */
+uint16_t splinePath::getNumSegments(){
+	if (_numPoints == 0) return 0;
+	if (_type == SPLINE_BSPLINE) return _numPoints+2;	// End points are repeated, so the curve starts and ends there
+	return _numPoints;
+}
+
+const float* splinePath::getControlPoint(int16_t index){
+	if (index <= 0) return _start;
+	if (index > (int16_t)_numPoints) index = _numPoints;
+	return _points[index-1];
+}
+
+void splinePath::evaluate(uint16_t segment, float u, float point[3]){
+	const float* p0;
+	const float* p1;
+	const float* p2;
+	const float* p3;
+	float uSQ = u*u;
+	float uCB = uSQ*u;
+	
+	if (_type == SPLINE_BSPLINE){
+		p0 = getControlPoint(segment-2);
+		p1 = getControlPoint(segment-1);
+		p2 = getControlPoint(segment);
+		p3 = getControlPoint(segment+1);
+		float b0 = (1-u)*(1-u)*(1-u)/6.0;
+		float b1 = (3*uCB - 6*uSQ + 4)/6.0;
+		float b2 = (-3*uCB + 3*uSQ + 3*u + 1)/6.0;
+		float b3 = uCB/6.0;
+		for (uint8_t i=0; i<3; i++) point[i] = b0*p0[i] + b1*p1[i] + b2*p2[i] + b3*p3[i];
+	}else{
+		p0 = getControlPoint(segment-1);
+		p1 = getControlPoint(segment);
+		p2 = getControlPoint(segment+1);
+		p3 = getControlPoint(segment+2);
+		for (uint8_t i=0; i<3; i++){
+			point[i] = 0.5*(2*p1[i] + (-p0[i]+p2[i])*u + (2*p0[i]-5*p1[i]+4*p2[i]-p3[i])*uSQ + (-p0[i]+3*p1[i]-3*p2[i]+p3[i])*uCB);
+		}
+	}
+}
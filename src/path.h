@@ -0,0 +1,366 @@
+/**
+ *  \class 	pathSource, linePath, waypointPath, circularPath, splinePath, pathTrigger
+ *  \brief 	Cartesian paths which generate their interpolation points on demand, so the memory used by a movement does not depend on its length or resolution
+ *  @file 	path.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	pathSource:
+ *  		public:
+ *  			pathSource();
+				void reset();
+				bool next(float point[3]);
+				uint16_t getIndex();
+				virtual uint16_t getNumPoints()=0;
+				virtual void getPoint(uint16_t index, float point[3])=0;
+				virtual float getLength()=0;
+				virtual void getPointAt(float s, float point[3])=0;
+				~pathSource();
+				bool addTrigger(pathTrigger* trigger);
+				void clearTriggers();
+				void resetTriggers();
+				void fireTriggers(float s, float t, float totalTime);
+				void cancelTriggers();
+ *  	pathTrigger:
+ *  		public:
+ *  			pathTrigger(uint8_t type, float value, pathTriggerCb callback, void* arg=NULL, pathTriggerCb cancelCallback=NULL);
+				bool check(float s, float length, float t, float totalTime);
+				void reset();
+				bool cancel();
+				bool hasFired();
+ *  	linePath:
+ *  		public:
+ *  			linePath(const float start[3], const float goal[3], float resolution=5);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+ *  	waypointPath:
+ *  		public:
+ *  			waypointPath(float points[][3], uint16_t nrPoints, const float start[3]=NULL);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+			private:
+				const float* getCorner(int16_t index);
+ *  	circularPath:
+ *  		public:
+ *  			circularPath(const float start[3], const float point[3], const float goal[3], uint8_t mode=ARC_CENTER_CCW, float resolution=5);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+			private:
+				void setLine(const float start[3], const float goal[3]);
+ *  	splinePath:
+ *  		public:
+ *  			splinePath(const float start[3], float points[][3], uint16_t nrPoints, uint8_t type=SPLINE_CATMULL_ROM, float resolution=5);
+				uint16_t getNumPoints();
+				void getPoint(uint16_t index, float point[3]);
+				float getLength();
+				void getPointAt(float s, float point[3]);
+			private:
+				uint16_t getNumSegments();
+				const float* getControlPoint(int16_t index);
+				void evaluate(uint16_t segment, float u, float point[3]);
+ *  \par Usage:
+ *  	A path is iterated with reset() and next() by the movement functions of morobotClass (e.g. followPath(), trajectoryPlanning()).
+ *  	The inverse kinematics of a point is calculated by the robot when the point is approached.
+ *  	Movements with a given TCP speed (moveAlongPath()) use getLength() and getPointAt() instead of the interpolation points.
+ *  	Curved paths are parameterized by their arc length, so the TCP speed is constant along the curve.
+ *  	Triggers added to a path (addTrigger()) are fired by moveAlongPath() in the control cycle in which the reference passes their
+ *  	position, so end effectors are switched while the robot moves (e.g. binaryEEF::activateTrigger() to start a pump after 10 mm).
+ *  	If the movement is aborted, the cancel function of every trigger which already fired is called, so an end effector switched on the way
+ *  	is put into a safe state (e.g. binaryEEF::deactivateTrigger()). A trigger can be added to one path only and only once.
+ *  	Only moveAlongPath() fires triggers. followPath(), trajectoryPlanning() and the movements which build their path internally
+ *  	(moveLinear(), moveLinearTracked(), moveCircular(), moveSpline()) have none: build a linePath, circularPath or splinePath,
+ *  	add the triggers and call moveAlongPath() instead.
+ */
+
+#ifndef PATH_H
+#define PATH_H
+
+#include <Arduino.h>
+
+#define ARC_CENTER_CW		0		//!< Arc in XY-plane around a center point, clockwise (Z is interpolated linearly)
+#define ARC_CENTER_CCW		1		//!< Arc in XY-plane around a center point, counterclockwise (Z is interpolated linearly)
+#define ARC_THREE_POINT		2		//!< Arc from the start through a via point to the goal (any plane)
+
+#define SPLINE_CATMULL_ROM	0		//!< Catmull-Rom spline, passes through all points
+#define SPLINE_BSPLINE		1		//!< Uniform cubic B-spline, starts and ends at the first and last point and is smoothed in between
+#define SPLINE_STEPS		16		//!< Number of chords per spline segment used to calculate the arc length
+
+#define TRIGGER_FRACTION	0		//!< Position of a trigger as fraction of the path length (0 ... 1)
+#define TRIGGER_DISTANCE	1		//!< Position of a trigger as distance in mm from the start (negative: from the end)
+#define TRIGGER_TIME		2		//!< Position of a trigger as time in s after the start of the movement (negative: before the end)
+
+typedef void (*pathTriggerCb)(void* arg);	//!< Function called by a trigger (must return quickly, it runs within the control cycle)
+
+class pathSource;
+
+class pathTrigger {
+	public:
+		/**
+		 *  \brief Constructor of pathTrigger class. The trigger must stay valid while the path it is added to is used.
+		 *  \param [in] type Definition of the position (TRIGGER_FRACTION, TRIGGER_DISTANCE, TRIGGER_TIME)
+		 *  \param [in] value Fraction, distance in mm or time in s
+		 *  \param [in] callback Function called when the position is passed
+		 *  \param [in] arg (Optional) Argument passed to the functions (e.g. a binaryEEF)
+		 *  \param [in] cancelCallback (Optional) Function called if the trigger fired and the movement is aborted (puts the end effector into a safe state)
+		 */
+		pathTrigger(uint8_t type, float value, pathTriggerCb callback, void* arg=NULL, pathTriggerCb cancelCallback=NULL);
+
+		/**
+		 *  \brief Calls the function if the trigger has not fired yet and its position has been passed
+		 *  \param [in] s Distance of the reference along the path in mm
+		 *  \param [in] length Length of the path in mm
+		 *  \param [in] t Time of the reference since the start of the movement in s
+		 *  \param [in] totalTime Duration of the movement in s
+		 *  \return Returns true if the trigger fired now
+		 */
+		bool check(float s, float length, float t, float totalTime);
+
+		/**
+		 *  \brief Arms the trigger again (done at the start of each movement)
+		 */
+		void reset();
+
+		/**
+		 *  \brief Calls the cancel function if the trigger fired in the current movement (done when the movement is aborted)
+		 *  \return Returns true if the cancel function has been called
+		 */
+		bool cancel();
+
+		/**
+		 *  \brief Returns true if the trigger fired in the last movement
+		 */
+		bool hasFired();
+	private:
+		friend class pathSource;
+		uint8_t _type;					//!< Definition of the position (TRIGGER_FRACTION, TRIGGER_DISTANCE, TRIGGER_TIME)
+		float _value;					//!< Fraction, distance in mm or time in s
+		pathTriggerCb _callback;		//!< Function called when the position is passed
+		pathTriggerCb _cancelCallback;	//!< Function called when the movement is aborted after the trigger fired
+		void* _arg;						//!< Argument of the functions
+		bool _fired;					//!< True if the trigger fired in the current movement
+		pathSource* _path;				//!< Path the trigger has been added to (NULL if none)
+		pathTrigger* _next;				//!< Next trigger of the same path
+};
+
+class pathSource {
+	public:
+		/**
+		 *  \brief Constructor of pathSource class
+		 */
+		pathSource();
+
+		/**
+		 *  \brief Destructor of pathSource class. Removes the triggers, so they can be added to another path.
+		 */
+		~pathSource();
+
+		/**
+		 *  \brief Restarts the iteration at the first interpolation point
+		 */
+		void reset();
+
+		/**
+		 *  \brief Calculates the next interpolation point
+		 *  \param [out] point Position x, y, z of the point
+		 *  \return Returns false if there are no more points
+		 */
+		bool next(float point[3]);
+
+		/**
+		 *  \brief Returns the index of the point the next call of next() returns
+		 */
+		uint16_t getIndex();
+
+		/**
+		 *  \brief Returns the number of interpolation points (the start point is not included)
+		 */
+		virtual uint16_t getNumPoints()=0;
+
+		/**
+		 *  \brief Calculates an interpolation point
+		 *  \param [in] index Number of the point (first point has index 0)
+		 *  \param [out] point Position x, y, z of the point
+		 */
+		virtual void getPoint(uint16_t index, float point[3])=0;
+
+		/**
+		 *  \brief Returns the length of the path in mm (the start point of the path is the start of the movement)
+		 */
+		virtual float getLength()=0;
+
+		/**
+		 *  \brief Calculates the point at a given distance along the path
+		 *  \param [in] s Distance from the start of the path in mm (0 ... getLength())
+		 *  \param [out] point Position x, y, z of the point
+		 */
+		virtual void getPointAt(float s, float point[3])=0;
+
+		/**
+		 *  \brief Adds a trigger to the path (the trigger is not copied)
+		 *  \param [in] trigger Trigger to add
+		 *  \return Returns false if the trigger has already been added to this or another path (remove it with clearTriggers() first)
+		 */
+		bool addTrigger(pathTrigger* trigger);
+
+		/**
+		 *  \brief Removes all triggers from the path, so they can be added to another path
+		 */
+		void clearTriggers();
+
+		/**
+		 *  \brief Arms all triggers of the path again (called at the start of a movement)
+		 */
+		void resetTriggers();
+
+		/**
+		 *  \brief Fires all triggers whose position has been passed by the reference
+		 *  \param [in] s Distance of the reference along the path in mm
+		 *  \param [in] t Time of the reference since the start of the movement in s
+		 *  \param [in] totalTime Duration of the movement in s
+		 */
+		void fireTriggers(float s, float t, float totalTime);
+
+		/**
+		 *  \brief Calls the cancel functions of all triggers which fired in the current movement (called when a movement is aborted)
+		 */
+		void cancelTriggers();
+	protected:
+		uint16_t _index;	//!< Index of the next interpolation point
+		pathTrigger* _triggers;	//!< First trigger of the path (NULL if the path has no triggers)
+};
+
+class linePath : public pathSource {
+	public:
+		/**
+		 *  \brief Constructor of linePath class
+		 *  \param [in] start Start point x, y, z (usually the current position of the TCP)
+		 *  \param [in] goal Goal point x, y, z
+		 *  \param [in] resolution (Optional) Distance between two interpolation points in mm
+		 */
+		linePath(const float start[3], const float goal[3], float resolution=5);
+
+		uint16_t getNumPoints();
+		void getPoint(uint16_t index, float point[3]);
+		float getLength();
+		void getPointAt(float s, float point[3]);
+	private:
+		float _start[3];		//!< Start point
+		float _dir[3];			//!< Vector from the start point to the goal point
+		float _length;			//!< Length of the line in mm
+		uint16_t _numPoints;	//!< Number of interpolation points
+};
+
+class waypointPath : public pathSource {
+	public:
+		/**
+		 *  \brief Constructor of waypointPath class. The points are not copied, so the array must stay valid while the path is used.
+		 *  \param [in] points[][3] Waypoints with x-, y- and z-value (the interpolation points of the path)
+		 *  \param [in] nrPoints Number of waypoints
+		 *  \param [in] start (Optional) Start point of the path used by getLength() and getPointAt(). If not given, the path starts at the first waypoint.
+		 */
+		waypointPath(float points[][3], uint16_t nrPoints, const float start[3]=NULL);
+
+		uint16_t getNumPoints();
+		void getPoint(uint16_t index, float point[3]);
+		float getLength();
+		void getPointAt(float s, float point[3]);
+	private:
+		/**
+		 *  \brief Returns the start (index -1) or a waypoint of a segment
+		 */
+		const float* getCorner(int16_t index);
+
+		float (*_points)[3];	//!< Waypoints
+		uint16_t _numPoints;	//!< Number of waypoints
+		float _start[3];		//!< Start point of the path
+		float _length;			//!< Length of the path in mm
+};
+
+class circularPath : public pathSource {
+	public:
+		/**
+		 *  \brief Constructor of circularPath class. If the arc is not defined (e.g. three points on a line), the path is a line from start to goal.
+		 *  \param [in] start Start point x, y, z (usually the current position of the TCP)
+		 *  \param [in] point Center of the arc (ARC_CENTER_CW, ARC_CENTER_CCW) or a point on the arc between start and goal (ARC_THREE_POINT)
+		 *  \param [in] goal Goal point x, y, z (a full circle if it is equal to the start point and the center is given)
+		 *  \param [in] mode (Optional) Definition of the arc (ARC_CENTER_CW, ARC_CENTER_CCW, ARC_THREE_POINT)
+		 *  \param [in] resolution (Optional) Distance between two interpolation points in mm
+		 */
+		circularPath(const float start[3], const float point[3], const float goal[3], uint8_t mode=ARC_CENTER_CCW, float resolution=5);
+
+		uint16_t getNumPoints();
+		void getPoint(uint16_t index, float point[3]);
+		float getLength();
+		void getPointAt(float s, float point[3]);
+	private:
+		/**
+		 *  \brief Sets the path to a line from start to goal (used for arcs which are not defined)
+		 */
+		void setLine(const float start[3], const float goal[3]);
+
+		float _center[3];		//!< Center of the arc
+		float _u[3];			//!< Unit vector from the center to the start point
+		float _v[3];			//!< Unit vector perpendicular to _u in the plane of the arc (in direction of movement)
+		float _offset[3];		//!< Offset added linearly along the arc (e.g. Z of a helix)
+		float _radius;			//!< Radius of the arc in mm
+		float _sweep;			//!< Angle of the arc in radians
+		float _length;			//!< Length of the path in mm
+		uint16_t _numPoints;	//!< Number of interpolation points
+};
+
+class splinePath : public pathSource {
+	public:
+		/**
+		 *  \brief Constructor of splinePath class. The points are not copied, so the array must stay valid while the path is used.
+		 *  \param [in] start Start point x, y, z (usually the current position of the TCP)
+		 *  \param [in] points[][3] Points of the spline with x-, y- and z-value (the last point is the goal)
+		 *  \param [in] nrPoints Number of points
+		 *  \param [in] type (Optional) Type of the spline (SPLINE_CATMULL_ROM, SPLINE_BSPLINE)
+		 *  \param [in] resolution (Optional) Distance between two interpolation points in mm
+		 */
+		splinePath(const float start[3], float points[][3], uint16_t nrPoints, uint8_t type=SPLINE_CATMULL_ROM, float resolution=5);
+
+		uint16_t getNumPoints();
+		void getPoint(uint16_t index, float point[3]);
+		float getLength();
+		void getPointAt(float s, float point[3]);
+	private:
+		/**
+		 *  \brief Returns the number of cubic segments of the spline
+		 */
+		uint16_t getNumSegments();
+
+		/**
+		 *  \brief Returns a control point (index 0 is the start point), indices outside the points are clamped to the first/last point
+		 */
+		const float* getControlPoint(int16_t index);
+
+		/**
+		 *  \brief Calculates a point of a segment
+		 *  \param [in] segment Number of the segment
+		 *  \param [in] u Parameter within the segment (0 ... 1)
+		 *  \param [out] point Calculated point
+		 */
+		void evaluate(uint16_t segment, float u, float point[3]);
+
+		float (*_points)[3];	//!< Points of the spline
+		uint16_t _numPoints;	//!< Number of points
+		float _start[3];		//!< Start point of the spline
+		uint8_t _type;			//!< Type of the spline (SPLINE_CATMULL_ROM, SPLINE_BSPLINE)
+		float _length;			//!< Length of the path in mm
+		uint16_t _numInterpolation;	//!< Number of interpolation points
+
+		// Arc length cursor: getPointAt() continues from here if the distance does not decrease
+		uint16_t _cursorSegment;	//!< Segment of the cursor
+		uint8_t _cursorStep;		//!< Chord within the segment
+		float _cursorS;				//!< Distance along the path at the start of the chord
+		float _cursorPoint[3];		//!< Point at the start of the chord
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ *  \class 	servoFrameParser
+ *  \brief 	Incremental parser for the sysex frames sent by the smart servos
+ *  @file 	servo_parser.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		servoFrameParser();
+			void reset();
+			uint8_t parse(const uint8_t* data, uint8_t length, servo_frame_type* frame, uint8_t* used);
+			uint16_t getDropped();
+		private:
+			bool store(const uint8_t* data, uint8_t length);
+			uint8_t check(const uint8_t* data, uint8_t length, servo_frame_type* frame);
+ */
+
+#include "servo_parser.h"
+
+servoFrameParser::servoFrameParser(){
+	_length = 0;
+	_parsing = false;
+	_dropped = 0;
+}
+
+void servoFrameParser::reset(){
+	_length = 0;
+	_parsing = false;
+}
+
+uint8_t servoFrameParser::parse(const uint8_t* data, uint8_t length, servo_frame_type* frame, uint8_t* used){
+	uint8_t i = 0;
+	if (!_parsing){
+		// Skip everything up to the start of the next frame
+		while (i < length && data[i] != SERVO_FRAME_START) i++;
+		if (i == length){
+			*used = length;
+			return SERVO_FRAME_INCOMPLETE;
+		}
+		i++;
+		_parsing = true;
+		_length = 0;
+	}
+
+	// Search the end of the frame
+	uint8_t start = i;
+	while (i < length && data[i] < 0x80) i++;
+	if (i == length){
+		*used = length;
+		if (store(&data[start], length - start)) return SERVO_FRAME_INCOMPLETE;
+		reset();
+		_dropped++;
+		return SERVO_FRAME_DROPPED;
+	}
+
+	_parsing = false;
+	if (data[i] != SERVO_FRAME_END){
+		// Keep a new start for the next call, skip anything else
+		*used = (data[i] == SERVO_FRAME_START) ? i : i+1;
+		_dropped++;
+		return SERVO_FRAME_DROPPED;
+	}
+	*used = i+1;
+
+	// Frames in one chunk are checked in place, the rest of a frame spread over several chunks is appended to the buffer
+	if (_length == 0) return check(&data[start], i - start, frame);
+	if (!store(&data[start], i - start)){
+		_dropped++;
+		return SERVO_FRAME_DROPPED;
+	}
+	return check(_buffer, _length, frame);
+}
+
+uint16_t servoFrameParser::getDropped(){
+	return _dropped;
+}
+
+/* PRIVATE */
+bool servoFrameParser::store(const uint8_t* data, uint8_t length){
+	if (length > SERVO_FRAME_MAX_LENGTH - _length) return false;
+	memcpy(&_buffer[_length], data, length);
+	_length += length;
+	return true;
+}
+
+uint8_t servoFrameParser::check(const uint8_t* data, uint8_t length, servo_frame_type* frame){
+	// Device id, service id and checksum are required, the data can be empty
+	if (length < 3 || length > SERVO_FRAME_MAX_LENGTH){
+		_dropped++;
+		return SERVO_FRAME_DROPPED;
+	}
+
+	uint8_t checksum = 0;
+	for (uint8_t i=0; i<length-1; i++) checksum += data[i];
+	if ((checksum & 0x7f) != data[length-1]) return SERVO_FRAME_BAD_CHECKSUM;
+
+	frame->devId = data[0];
+	frame->srvId = data[1];
+	frame->length = length - 3;
+	frame->data = &data[2];
+	return SERVO_FRAME_COMPLETE;
+}
@@ -0,0 +1,94 @@
+/**
+ *  \class 	servoFrameParser
+ *  \brief 	Incremental parser for the sysex frames sent by the smart servos
+ *  @file 	servo_parser.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		servoFrameParser();
+			void reset();
+			uint8_t parse(const uint8_t* data, uint8_t length, servo_frame_type* frame, uint8_t* used);
+			uint16_t getDropped();
+		private:
+			bool store(const uint8_t* data, uint8_t length);
+			uint8_t check(const uint8_t* data, uint8_t length, servo_frame_type* frame);
+ *  \par Frame format:
+ *  	SERVO_FRAME_START, device id, service id, data[n], checksum, SERVO_FRAME_END
+ *  	All bytes between start and end are 7 bit. The checksum is the sum of device id, service id and data (lowest 7 bits).
+ *  	A byte with the highest bit set ends the frame: a new start drops the incomplete frame and starts the next one, any other
+ *  	byte (noise on the bus) drops the frame and the parser waits for the next start.
+ *  \par Usage:
+ *  	Pass every chunk received from the transport to parse() until all bytes are used. A frame which lies completely in one
+ *  	chunk is not copied, the frame points into the chunk. Only frames spread over several chunks are collected in the buffer
+ *  	of the parser. All state is kept in the object, so each bus has its own parser.
+ */
+
+#ifndef SERVO_PARSER_H
+#define SERVO_PARSER_H
+
+#include <Arduino.h>
+
+#define SERVO_FRAME_START		0xF0	//!< First byte of a frame (START_SYSEX)
+#define SERVO_FRAME_END			0xF7	//!< Last byte of a frame (END_SYSEX)
+#define SERVO_FRAME_MAX_LENGTH	64		//!< Maximum number of bytes between start and end of a frame
+
+// Results of servoFrameParser::parse()
+#define SERVO_FRAME_INCOMPLETE		0	//!< All bytes used, no frame finished
+#define SERVO_FRAME_COMPLETE		1	//!< A valid frame has been received
+#define SERVO_FRAME_BAD_CHECKSUM	2	//!< A frame has been received, but its checksum is wrong
+#define SERVO_FRAME_DROPPED			3	//!< An incomplete, too short or too long frame has been dropped
+
+typedef struct {
+	uint8_t devId;			//!< Device id of the servo which sent the frame
+	uint8_t srvId;			//!< Service id (e.g. SMART_SERVO, CTL_ERROR_CODE)
+	uint8_t length;			//!< Number of data bytes (without ids and checksum)
+	const uint8_t* data;	//!< Data bytes (points into the chunk or the parser, valid until the next call of parse())
+} servo_frame_type;
+
+class servoFrameParser {
+	public:
+		/**
+		 *  \brief Constructor of servoFrameParser class
+		 */
+		servoFrameParser();
+
+		/**
+		 *  \brief Drops a partly received frame (e.g. before a new transmission)
+		 */
+		void reset();
+
+		/**
+		 *  \brief Parses received bytes until a frame has been finished or all bytes are used
+		 *  \param [in] data Received bytes
+		 *  \param [in] length Number of bytes
+		 *  \param [out] frame Received frame (only set if SERVO_FRAME_COMPLETE is returned)
+		 *  \param [out] used Number of bytes used. Call again with the remaining bytes.
+		 *  \return Returns SERVO_FRAME_INCOMPLETE, SERVO_FRAME_COMPLETE, SERVO_FRAME_BAD_CHECKSUM or SERVO_FRAME_DROPPED
+		 */
+		uint8_t parse(const uint8_t* data, uint8_t length, servo_frame_type* frame, uint8_t* used);
+
+		/**
+		 *  \brief Returns the number of frames dropped because of wrong length or unexpected bytes
+		 */
+		uint16_t getDropped();
+	private:
+		/**
+		 *  \brief Appends the bytes of a frame which continues in the next chunk to the buffer
+		 *  \return Returns false if the frame is too long
+		 */
+		bool store(const uint8_t* data, uint8_t length);
+
+		/**
+		 *  \brief Checks length and checksum of the bytes between start and end of a frame and fills the frame
+		 *  \return Returns SERVO_FRAME_COMPLETE, SERVO_FRAME_BAD_CHECKSUM or SERVO_FRAME_DROPPED
+		 */
+		uint8_t check(const uint8_t* data, uint8_t length, servo_frame_type* frame);
+
+		uint8_t _buffer[SERVO_FRAME_MAX_LENGTH];	//!< Bytes of a frame spread over several chunks
+		uint8_t _length;							//!< Number of bytes in the buffer
+		bool _parsing;								//!< True if the start of a frame has been received
+		uint16_t _dropped;							//!< Number of dropped frames
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ *  \class 	morobotStorage
+ *  \brief 	Stores calibration data of the robots (e.g. PWM models and PID gains of the motors) permanently in the EEPROM of the microcontroller
+ *  @file 	storage.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		static bool write(uint16_t address, uint8_t type, const void* data, uint16_t length);
+			static bool read(uint16_t address, uint8_t type, void* data, uint16_t length);
+			static void erase(uint16_t address);
+		private:
+			static bool begin(uint16_t address, uint16_t length);
+			static void commit();
+			static uint8_t crc8(uint8_t crc, uint8_t data);
+ */
+
+#include "storage.h"
+
+bool morobotStorage::write(uint16_t address, uint8_t type, const void* data, uint16_t length){
+	if (!begin(address, length)){
+		Serial.println(F("ERROR: Data does not fit into the EEPROM"));
+		return false;
+	}
+
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint8_t crc = crc8(0, type);
+	crc = crc8(crc, length & 0xFF);
+	crc = crc8(crc, length >> 8);
+
+	// Invalidate the record first, so an interrupted write is never read as valid
+	EEPROM.write(address, 0xFF);
+	EEPROM.write(address+1, type);
+	EEPROM.write(address+2, length & 0xFF);
+	EEPROM.write(address+3, length >> 8);
+	for (uint16_t i=0; i<length; i++){
+		// Only write changed bytes to save EEPROM write cycles
+		if (EEPROM.read(address+4+i) != bytes[i]) EEPROM.write(address+4+i, bytes[i]);
+		crc = crc8(crc, bytes[i]);
+	}
+	EEPROM.write(address+4+length, crc);
+	EEPROM.write(address, STORAGE_MAGIC);
+	commit();
+	return true;
+}
+
+bool morobotStorage::read(uint16_t address, uint8_t type, void* data, uint16_t length){
+	if (!begin(address, length)) return false;
+	if (EEPROM.read(address) != STORAGE_MAGIC) return false;
+	if (EEPROM.read(address+1) != type) return false;
+	if ((EEPROM.read(address+2) | (EEPROM.read(address+3) << 8)) != length) return false;
+
+	uint8_t crc = crc8(0, type);
+	crc = crc8(crc, length & 0xFF);
+	crc = crc8(crc, length >> 8);
+	for (uint16_t i=0; i<length; i++) crc = crc8(crc, EEPROM.read(address+4+i));
+	if (EEPROM.read(address+4+length) != crc) return false;
+
+	uint8_t* bytes = (uint8_t*)data;
+	for (uint16_t i=0; i<length; i++) bytes[i] = EEPROM.read(address+4+i);
+	return true;
+}
+
+void morobotStorage::erase(uint16_t address){
+	if (!begin(address, 0)) return;
+	EEPROM.write(address, 0xFF);
+	commit();
+}
+
+/* PRIVATE */
+bool morobotStorage::begin(uint16_t address, uint16_t length){
+	uint32_t end = (uint32_t)address + length + STORAGE_HEADER_SIZE;
+#if defined(ESP32) || defined(ESP8266)
+	// The EEPROM is emulated in flash and must be initialized before each access
+	EEPROM.begin(STORAGE_EEPROM_SIZE);
+	return end <= STORAGE_EEPROM_SIZE;
+#else
+	return end <= EEPROM.length();
+#endif
+}
+
+void morobotStorage::commit(){
+#if defined(ESP32) || defined(ESP8266)
+	EEPROM.commit();
+#endif
+}
+
+uint8_t morobotStorage::crc8(uint8_t crc, uint8_t data){
+	crc ^= data;
+	for (uint8_t i=0; i<8; i++){
+		if (crc & 0x80) crc = (crc << 1) ^ 0x07;
+		else crc <<= 1;
+	}
+	return crc;
+}
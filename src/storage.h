@@ -0,0 +1,90 @@
+/**
+ *  \class 	morobotStorage
+ *  \brief 	Stores calibration data of the robots (e.g. PWM models and PID gains of the motors) permanently in the EEPROM of the microcontroller
+ *  @file 	storage.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	public:
+ *  		static bool write(uint16_t address, uint8_t type, const void* data, uint16_t length);
+			static bool read(uint16_t address, uint8_t type, void* data, uint16_t length);
+			static void erase(uint16_t address);
+		private:
+			static bool begin(uint16_t address, uint16_t length);
+			static void commit();
+			static uint8_t crc8(uint8_t crc, uint8_t data);
+ *  \par Record format:
+ *  	STORAGE_MAGIC, uint8 type, uint16 length, data[length], uint8 crc8 (polynomial 0x07 over type, length and data)
+ *  	A record is only read if magic, type, length and checksum match, so uncalibrated or outdated data is never used.
+ *  	Every kind of data has its own area (STORAGE_..._ADDRESS). To store the data of several robots pass a different address
+ *  	to the save/load functions for each robot.
+ */
+
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#define STORAGE_MAGIC			0xA7	//!< First byte of every record
+#define STORAGE_HEADER_SIZE		5		//!< Bytes of a record which are not data (magic, type, length, checksum)
+#define STORAGE_EEPROM_SIZE		1024	//!< Size of the emulated EEPROM on ESP32/ESP8266
+
+// Areas of the EEPROM used by the library
+#define STORAGE_PWM_ADDRESS		0		//!< PWM models of the motors (morobotClass::savePwmModels())
+#define STORAGE_PID_ADDRESS		400		//!< PID gains of the motors (morobotClass::savePidProfiles())
+#define STORAGE_BACKLASH_ADDRESS	560		//!< Backlash of the motors (morobotClass::saveBacklash())
+#define STORAGE_TOPOLOGY_ADDRESS	620		//!< Motors found at the last start (morobotClass::beginFast(), morobotClass::beginAll())
+
+// Types of records
+#define STORAGE_TYPE_PWM		1		//!< Array of pwm_model_type
+#define STORAGE_TYPE_PID		2		//!< Array of pid_gains_type
+#define STORAGE_TYPE_BACKLASH	3		//!< Array of float (backlash in degrees)
+#define STORAGE_TYPE_TOPOLOGY	4		//!< servo_topology_type
+
+class morobotStorage {
+	public:
+		/**
+		 *  \brief Writes a record to the EEPROM
+		 *  \param [in] address Address of the record in the EEPROM
+		 *  \param [in] type Type of the record (STORAGE_TYPE_...)
+		 *  \param [in] data Data to store
+		 *  \param [in] length Number of bytes to store
+		 *  \return Returns false if the record does not fit into the EEPROM
+		 */
+		static bool write(uint16_t address, uint8_t type, const void* data, uint16_t length);
+
+		/**
+		 *  \brief Reads a record from the EEPROM
+		 *  \param [in] address Address of the record in the EEPROM
+		 *  \param [in] type Expected type of the record (STORAGE_TYPE_...)
+		 *  \param [out] data Buffer for the data (only changed if the record is valid)
+		 *  \param [in] length Expected number of bytes
+		 *  \return Returns true if a valid record with the expected type and length has been read
+		 */
+		static bool read(uint16_t address, uint8_t type, void* data, uint16_t length);
+
+		/**
+		 *  \brief Invalidates a record
+		 *  \param [in] address Address of the record in the EEPROM
+		 */
+		static void erase(uint16_t address);
+
+	private:
+		/**
+		 *  \brief Prepares the EEPROM for access (ESP32/ESP8266) and checks if a record fits into it
+		 */
+		static bool begin(uint16_t address, uint16_t length);
+
+		/**
+		 *  \brief Writes changed data to the flash (ESP32/ESP8266)
+		 */
+		static void commit();
+
+		/**
+		 *  \brief Updates a CRC-8 (polynomial 0x07) with one byte
+		 */
+		static uint8_t crc8(uint8_t crc, uint8_t data);
+};
+
+#endif
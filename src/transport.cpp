@@ -0,0 +1,207 @@
+/**
+ *  \class 	servoTransport, streamTransport, esp32UartTransport, fdTransport
+ *  \brief 	Connection between the smart servo driver and the bus of the motors (serial port, UART driver or a file descriptor on a PC)
+ *  @file 	transport.cpp
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	servoTransport:
+ *  		public:
+ *  			servoTransport();
+				virtual bool send(const uint8_t* data, uint8_t length)=0;
+				virtual uint8_t receive(uint8_t* buffer, uint8_t size)=0;
+				virtual bool waitForData(uint32_t timeout);
+				unsigned long getRxTime();
+ *  	streamTransport:
+ *  		public:
+ *  			streamTransport(Stream* port=NULL);
+				void setStream(Stream* port);
+				Stream* getStream();
+				bool send(const uint8_t* data, uint8_t length);
+				uint8_t receive(uint8_t* buffer, uint8_t size);
+				bool waitForData(uint32_t timeout);
+ *  	esp32UartTransport (ESP32 only):
+ *  		public:
+ *  			esp32UartTransport(uart_port_t uartNum, int8_t rxPin, int8_t txPin, uint32_t baudrate=115200);
+				bool begin();
+				bool send(const uint8_t* data, uint8_t length);
+				uint8_t receive(uint8_t* buffer, uint8_t size);
+				bool waitForData(uint32_t timeout);
+				uint16_t getOverflows();
+			private:
+				void handleEvents(TickType_t ticks);
+ *  	fdTransport (PC only):
+ *  		public:
+ *  			fdTransport(int fd=-1);
+				void setFd(int fd);
+				bool send(const uint8_t* data, uint8_t length);
+				uint8_t receive(uint8_t* buffer, uint8_t size);
+				bool waitForData(uint32_t timeout);
+ */
+
+#include "transport.h"
+
+#if !defined(ARDUINO) && defined(__unix__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+/* servoTransport */
+servoTransport::servoTransport(){
+	_rxTime = 0;
+}
+
+bool servoTransport::waitForData(uint32_t){
+	// Does not wait, the driver polls until its timeout
+	return true;
+}
+
+unsigned long servoTransport::getRxTime(){
+	return _rxTime;
+}
+
+/* streamTransport */
+streamTransport::streamTransport(Stream* port){
+	_port = port;
+}
+
+void streamTransport::setStream(Stream* port){
+	_port = port;
+}
+
+Stream* streamTransport::getStream(){
+	return _port;
+}
+
+bool streamTransport::send(const uint8_t* data, uint8_t length){
+	return _port->write(data, length) == length;
+}
+
+uint8_t streamTransport::receive(uint8_t* buffer, uint8_t size){
+	uint8_t length = 0;
+	while (length < size && _port->available() > 0) buffer[length++] = _port->read();
+	if (length > 0) _rxTime = micros();
+	return length;
+}
+
+bool streamTransport::waitForData(uint32_t){
+	// The serial port has no way to wait, the driver polls
+	return _port->available() > 0;
+}
+
+/* esp32UartTransport */
+#if defined(ESP32)
+esp32UartTransport::esp32UartTransport(uart_port_t uartNum, int8_t rxPin, int8_t txPin, uint32_t baudrate){
+	_uartNum = uartNum;
+	_rxPin = rxPin;
+	_txPin = txPin;
+	_baudrate = baudrate;
+	_events = NULL;
+	_overflows = 0;
+}
+
+bool esp32UartTransport::begin(){
+	uart_config_t config = {};
+	config.baud_rate = _baudrate;
+	config.data_bits = UART_DATA_8_BITS;
+	config.parity = UART_PARITY_DISABLE;
+	config.stop_bits = UART_STOP_BITS_1;
+	config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+
+	// No transmit buffer: a frame fits into the hardware FIFO, so uart_write_bytes() returns immediately
+	if (uart_driver_install(_uartNum, TRANSPORT_UART_RX_BUFFER, 0, TRANSPORT_UART_EVENTS, &_events, 0) != ESP_OK
+		|| uart_param_config(_uartNum, &config) != ESP_OK
+		|| uart_set_pin(_uartNum, _txPin, _rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+		Serial.println(F("ERROR: UART driver could not be installed (is the UART used by a HardwareSerial?)"));
+		return false;
+	}
+	return true;
+}
+
+bool esp32UartTransport::send(const uint8_t* data, uint8_t length){
+	return uart_write_bytes(_uartNum, (const char*)data, length) == length;
+}
+
+uint8_t esp32UartTransport::receive(uint8_t* buffer, uint8_t size){
+	handleEvents(0);
+	int length = uart_read_bytes(_uartNum, buffer, size, 0);
+	if (length <= 0) return 0;
+	return length;
+}
+
+bool esp32UartTransport::waitForData(uint32_t timeout){
+	size_t length = 0;
+	uart_get_buffered_data_len(_uartNum, &length);
+	if (length > 0) return true;
+
+	handleEvents((timeout + portTICK_PERIOD_MS*1000UL - 1) / (portTICK_PERIOD_MS*1000UL));
+	uart_get_buffered_data_len(_uartNum, &length);
+	return length > 0;
+}
+
+uint16_t esp32UartTransport::getOverflows(){
+	return _overflows;
+}
+
+void esp32UartTransport::handleEvents(TickType_t ticks){
+	uart_event_t event;
+	while (xQueueReceive(_events, &event, ticks) == pdTRUE) {
+		ticks = 0;
+		switch (event.type) {
+			case UART_DATA:
+				// The driver reports data when a frame ends (receive timeout) or the FIFO is filled
+				_rxTime = micros();
+				break;
+			case UART_FIFO_OVF:
+			case UART_BUFFER_FULL:
+				// The frames in the buffer are incomplete, the driver repeats the command after its timeout
+				_overflows++;
+				uart_flush_input(_uartNum);
+				xQueueReset(_events);
+				return;
+			default:
+				break;
+		}
+	}
+}
+#endif
+
+/* fdTransport */
+#if !defined(ARDUINO) && defined(__unix__)
+fdTransport::fdTransport(int fd){
+	setFd(fd);
+}
+
+void fdTransport::setFd(int fd){
+	_fd = fd;
+	if (_fd >= 0) fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) | O_NONBLOCK);
+}
+
+bool fdTransport::send(const uint8_t* data, uint8_t length){
+	uint8_t sent = 0;
+	while (sent < length) {
+		ssize_t result = write(_fd, data + sent, length - sent);
+		if (result < 0) {
+			// The other end has not read its buffer yet
+			struct pollfd request = {_fd, POLLOUT, 0};
+			if (poll(&request, 1, 100) <= 0) return false;
+			continue;
+		}
+		sent += result;
+	}
+	return true;
+}
+
+uint8_t fdTransport::receive(uint8_t* buffer, uint8_t size){
+	ssize_t length = read(_fd, buffer, size);
+	if (length <= 0) return 0;
+	_rxTime = micros();
+	return length;
+}
+
+bool fdTransport::waitForData(uint32_t timeout){
+	struct pollfd request = {_fd, POLLIN, 0};
+	return poll(&request, 1, (timeout + 999) / 1000) > 0;
+}
+#endif
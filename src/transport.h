@@ -0,0 +1,194 @@
+/**
+ *  \class 	servoTransport, streamTransport, esp32UartTransport, fdTransport
+ *  \brief 	Connection between the smart servo driver and the bus of the motors (serial port, UART driver or a file descriptor on a PC)
+ *  @file 	transport.h
+ *  @author	Johannes Rauer FHTW
+ *  @date	2026/10/18
+ *  \par Method List:
+ *  	servoTransport:
+ *  		public:
+ *  			servoTransport();
+				virtual bool send(const uint8_t* data, uint8_t length)=0;
+				virtual uint8_t receive(uint8_t* buffer, uint8_t size)=0;
+				virtual bool waitForData(uint32_t timeout);
+				unsigned long getRxTime();
+ *  	streamTransport:
+ *  		public:
+ *  			streamTransport(Stream* port=NULL);
+				void setStream(Stream* port);
+				Stream* getStream();
+				bool send(const uint8_t* data, uint8_t length);
+				uint8_t receive(uint8_t* buffer, uint8_t size);
+				bool waitForData(uint32_t timeout);
+ *  	esp32UartTransport (ESP32 only):
+ *  		public:
+ *  			esp32UartTransport(uart_port_t uartNum, int8_t rxPin, int8_t txPin, uint32_t baudrate=115200);
+				bool begin();
+				bool send(const uint8_t* data, uint8_t length);
+				uint8_t receive(uint8_t* buffer, uint8_t size);
+				bool waitForData(uint32_t timeout);
+				uint16_t getOverflows();
+			private:
+				void handleEvents(TickType_t ticks);
+ *  	fdTransport (PC only):
+ *  		public:
+ *  			fdTransport(int fd=-1);
+				void setFd(int fd);
+				bool send(const uint8_t* data, uint8_t length);
+				uint8_t receive(uint8_t* buffer, uint8_t size);
+				bool waitForData(uint32_t timeout);
+ *  \par Usage:
+ *  	MakeblockSmartServo::beginSerial() wraps the given Stream into a streamTransport, so sketches which use port names or Streams
+ *  	need no changes. Pass another transport to morobotClass::begin() to replace the serial port (e.g. the UART driver of the ESP32,
+ *  	which receives in the background and lets other tasks run while the driver waits for a response).
+ *  	A frame is always sent with one call of send(). receive() copies everything received so far, waitForData() waits until
+ *  	data is available without reading it.
+ */
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include "driver/uart.h"
+#define TRANSPORT_UART_RX_BUFFER	256		//!< Size of the receive ring buffer of the ESP32 UART driver
+#define TRANSPORT_UART_EVENTS		8		//!< Length of the event queue of the ESP32 UART driver
+#endif
+
+class servoTransport {
+	public:
+		/**
+		 *  \brief Constructor of servoTransport class
+		 */
+		servoTransport();
+
+		/**
+		 *  \brief Sends a frame to the motors
+		 *  \param [in] data Bytes of the frame
+		 *  \param [in] length Number of bytes
+		 *  \return Returns false if the frame could not be sent completely
+		 */
+		virtual bool send(const uint8_t* data, uint8_t length)=0;
+
+		/**
+		 *  \brief Copies the bytes received so far (does not wait)
+		 *  \param [out] buffer Buffer for the received bytes
+		 *  \param [in] size Size of the buffer
+		 *  \return Returns the number of bytes copied (0 if nothing has been received)
+		 */
+		virtual uint8_t receive(uint8_t* buffer, uint8_t size)=0;
+
+		/**
+		 *  \brief Waits until data has been received. The default implementation does not wait, so the caller polls.
+		 *  \param [in] timeout Maximum time to wait in us
+		 *  \return Returns true if data is available
+		 */
+		virtual bool waitForData(uint32_t timeout);
+
+		/**
+		 *  \brief Returns the time the last bytes have been received (micros())
+		 */
+		unsigned long getRxTime();
+	protected:
+		unsigned long _rxTime;		//!< Time the last bytes have been received (micros())
+};
+
+class streamTransport : public servoTransport {
+	public:
+		/**
+		 *  \brief Constructor of streamTransport class
+		 *  \param [in] port (Optional) Started serial port (e.g. &Serial1)
+		 */
+		streamTransport(Stream* port=NULL);
+
+		/**
+		 *  \brief Sets the serial port
+		 *  \param [in] port Started serial port (e.g. &Serial1)
+		 */
+		void setStream(Stream* port);
+
+		/**
+		 *  \brief Returns the serial port
+		 */
+		Stream* getStream();
+
+		bool send(const uint8_t* data, uint8_t length);
+		uint8_t receive(uint8_t* buffer, uint8_t size);
+		bool waitForData(uint32_t timeout);
+	private:
+		Stream* _port;		//!< Serial port the motors are connected to
+};
+
+#if defined(ESP32)
+class esp32UartTransport : public servoTransport {
+	public:
+		/**
+		 *  \brief Constructor of esp32UartTransport class. Do not start the HardwareSerial of the same UART (e.g. Serial1).
+		 *  \param [in] uartNum Number of the UART (UART_NUM_1, UART_NUM_2)
+		 *  \param [in] rxPin Pin connected to the white cable of the robot
+		 *  \param [in] txPin Pin connected to the yellow cable of the robot
+		 *  \param [in] baudrate (Optional) Baudrate of the motors
+		 */
+		esp32UartTransport(uart_port_t uartNum, int8_t rxPin, int8_t txPin, uint32_t baudrate=115200);
+
+		/**
+		 *  \brief Installs the UART driver, which receives into a ring buffer by interrupt and reports new data in an event queue
+		 *  \return Returns false (and prints an error) if the driver could not be installed
+		 */
+		bool begin();
+
+		bool send(const uint8_t* data, uint8_t length);
+		uint8_t receive(uint8_t* buffer, uint8_t size);
+
+		/**
+		 *  \brief Blocks the task on the event queue until data has been received, so other tasks can run meanwhile
+		 *  \param [in] timeout Maximum time to wait in us (rounded up to ticks of the scheduler)
+		 *  \return Returns true if data is available
+		 */
+		bool waitForData(uint32_t timeout);
+
+		/**
+		 *  \brief Returns the number of times received data has been lost because the ring buffer was full
+		 */
+		uint16_t getOverflows();
+	private:
+		/**
+		 *  \brief Processes the events of the UART driver
+		 *  \param [in] ticks Time to wait for the first event
+		 */
+		void handleEvents(TickType_t ticks);
+
+		uart_port_t _uartNum;		//!< Number of the UART
+		int8_t _rxPin;				//!< Receive pin
+		int8_t _txPin;				//!< Transmit pin
+		uint32_t _baudrate;			//!< Baudrate
+		QueueHandle_t _events;		//!< Event queue of the UART driver
+		uint16_t _overflows;		//!< Number of overflows of the receive buffer
+};
+#endif
+
+#if !defined(ARDUINO) && defined(__unix__)
+class fdTransport : public servoTransport {
+	public:
+		/**
+		 *  \brief Constructor of fdTransport class. Stand-in for a serial port when the library runs on a PC (e.g. one end of a pty or socketpair).
+		 *  \param [in] fd (Optional) Open file descriptor
+		 */
+		fdTransport(int fd=-1);
+
+		/**
+		 *  \brief Sets the file descriptor
+		 *  \param [in] fd Open file descriptor
+		 */
+		void setFd(int fd);
+
+		bool send(const uint8_t* data, uint8_t length);
+		uint8_t receive(uint8_t* buffer, uint8_t size);
+		bool waitForData(uint32_t timeout);
+	private:
+		int _fd;		//!< File descriptor of the connection to the motors (or a simulation of them)
+};
+#endif
+
+#endif